@@ -31,6 +31,7 @@
 
 #include "benchmark/benchmark_utils.h"
 #include "edit/edit_dp.h"
+#include "edit/edit_wavefront.h"
 
 /*
  * Benchmark Edit
@@ -40,6 +41,8 @@ void benchmark_edit_dp(
   // Parameters
   edit_table_t edit_table;
   // Allocate
+  mm_allocator_mark_t mm_mark;
+  mm_allocator_mark(align_input->mm_allocator,&mm_mark);
   edit_table_allocate(
       &edit_table,align_input->pattern_length,
       align_input->text_length,align_input->mm_allocator);
@@ -54,7 +57,7 @@ void benchmark_edit_dp(
     benchmark_check_alignment(align_input,&edit_table.edit_cigar);
   }
   // Free
-  edit_table_free(&edit_table,align_input->mm_allocator);
+  mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
 }
 void benchmark_edit_dp_banded(
     align_input_t* const align_input,
@@ -62,6 +65,8 @@ void benchmark_edit_dp_banded(
   // Parameters
   edit_table_t edit_table;
   // Allocate
+  mm_allocator_mark_t mm_mark;
+  mm_allocator_mark(align_input->mm_allocator,&mm_mark);
   edit_table_allocate(
       &edit_table,align_input->pattern_length,
       align_input->text_length,align_input->mm_allocator);
@@ -76,5 +81,24 @@ void benchmark_edit_dp_banded(
     benchmark_check_alignment(align_input,&edit_table.edit_cigar);
   }
   // Free
-  edit_table_free(&edit_table,align_input->mm_allocator);
+  mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
+}
+void benchmark_edit_wavefront(
+    align_input_t* const align_input) {
+  // Allocate
+  edit_wavefronts_t* const edit_wavefronts = edit_wavefronts_new(
+      align_input->pattern_length,align_input->text_length,
+      align_input->mm_allocator);
+  // Align
+  timer_start(&align_input->timer);
+  edit_wavefronts_align(edit_wavefronts,
+      align_input->pattern,align_input->pattern_length,
+      align_input->text,align_input->text_length);
+  timer_stop(&align_input->timer);
+  // Debug alignment
+  if (align_input->debug_flags) {
+    benchmark_check_alignment(align_input,&edit_wavefronts->edit_cigar);
+  }
+  // Free
+  edit_wavefronts_delete(edit_wavefronts);
 }
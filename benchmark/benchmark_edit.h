@@ -49,5 +49,7 @@ void benchmark_edit_dp(
 void benchmark_edit_dp_banded(
     align_input_t* const align_input,
     const int bandwidth);
+void benchmark_edit_wavefront(
+    align_input_t* const align_input);
 
 #endif /* BENCHMARK_EDIT_H_ */
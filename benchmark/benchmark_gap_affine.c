@@ -47,6 +47,8 @@ void benchmark_gap_affine_swg(
     affine_penalties_t* const penalties) {
   // Allocate
   affine_table_t affine_table;
+  mm_allocator_mark_t mm_mark;
+  mm_allocator_mark(align_input->mm_allocator,&mm_mark);
   affine_table_allocate(
       &affine_table,align_input->pattern_length,
       align_input->text_length,align_input->mm_allocator);
@@ -61,7 +63,7 @@ void benchmark_gap_affine_swg(
     benchmark_check_alignment(align_input,&affine_table.edit_cigar);
   }
   // Free
-  affine_table_free(&affine_table,align_input->mm_allocator);
+  mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
 }
 void benchmark_gap_affine_swg_banded(
     align_input_t* const align_input,
@@ -69,6 +71,8 @@ void benchmark_gap_affine_swg_banded(
     const int bandwidth) {
   // Allocate
   affine_table_t affine_table;
+  mm_allocator_mark_t mm_mark;
+  mm_allocator_mark(align_input->mm_allocator,&mm_mark);
   affine_table_allocate(
       &affine_table,align_input->pattern_length,
       align_input->text_length,align_input->mm_allocator);
@@ -83,36 +87,186 @@ void benchmark_gap_affine_swg_banded(
     benchmark_check_alignment(align_input,&affine_table.edit_cigar);
   }
   // Free
-  affine_table_free(&affine_table,align_input->mm_allocator);
+  mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
 }
 void benchmark_gap_affine_wavefront(
     align_input_t* const align_input,
     affine_penalties_t* const penalties,
     const int min_wavefront_length,
     const int max_distance_threshold) {
-  // Allocate
-  affine_wavefronts_t* affine_wavefronts;
-  if (min_wavefront_length < 0) {
-    affine_wavefronts = affine_wavefronts_new_complete(
-        align_input->pattern_length,align_input->text_length,penalties,
-        &(align_input->wavefronts_stats),align_input->mm_allocator);
+  // Allocate (or resize the reusable aligner)
+  affine_wavefronts_t* affine_wavefronts = align_input->affine_wavefronts;
+  if (affine_wavefronts != NULL) {
+    affine_wavefronts_resize(affine_wavefronts,
+        align_input->pattern_length,align_input->text_length);
   } else {
-    affine_wavefronts = affine_wavefronts_new_reduced(
-        align_input->pattern_length,align_input->text_length,penalties,
-        min_wavefront_length,max_distance_threshold,
-        &(align_input->wavefronts_stats),align_input->mm_allocator);
+    if (min_wavefront_length < 0) {
+      affine_wavefronts = affine_wavefronts_new_complete(
+          align_input->pattern_length,align_input->text_length,penalties,
+          &(align_input->wavefronts_stats),align_input->mm_allocator);
+    } else {
+      affine_wavefronts = affine_wavefronts_new_reduced(
+          align_input->pattern_length,align_input->text_length,penalties,
+          min_wavefront_length,max_distance_threshold,
+          &(align_input->wavefronts_stats),align_input->mm_allocator);
+    }
+    affine_wavefronts_set_cigar_rle(affine_wavefronts,align_input->cigar_rle);
+    affine_wavefronts_set_match(affine_wavefronts,
+        align_input->match.case_insensitive,align_input->match.n);
+    affine_wavefronts_set_zero_copy(affine_wavefronts,
+        align_input->zero_copy,align_input->zero_copy_slack);
+    affine_wavefronts_set_budget_fallback(affine_wavefronts,
+        align_input->budget_min_wavefront_length,align_input->budget_max_distance_threshold);
+    align_input->affine_wavefronts = affine_wavefronts;
   }
   // Align
   timer_start(&align_input->timer);
-  // affine_wavefronts_clear(affine_wavefronts);
-  affine_wavefronts_align(affine_wavefronts,
+  const affine_wavefronts_status_t status = affine_wavefronts_align(affine_wavefronts,
       align_input->pattern,align_input->pattern_length,
       align_input->text,align_input->text_length);
   timer_stop(&align_input->timer);
+  if (status == affine_wavefronts_status_out_of_budget) {
+    counter_add(&align_input->align_out_of_budget,1);
+    return;
+  }
+  // Debug alignment
+  if (align_input->debug_flags) {
+    if (affine_wavefronts->cigar_rle) {
+      benchmark_check_alignment_rle(align_input,&affine_wavefronts->edit_cigar_rle);
+    } else {
+      benchmark_check_alignment(align_input,&affine_wavefronts->edit_cigar);
+    }
+  }
+}
+void benchmark_gap_affine2p_wavefront(
+    align_input_t* const align_input,
+    affine2p_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold) {
+  // Allocate (or resize the reusable aligner)
+  affine_wavefronts_t* affine_wavefronts = align_input->affine_wavefronts;
+  if (affine_wavefronts != NULL) {
+    affine_wavefronts_resize(affine_wavefronts,
+        align_input->pattern_length,align_input->text_length);
+  } else {
+    if (min_wavefront_length < 0) {
+      affine_wavefronts = affine_wavefronts_new_complete_2p(
+          align_input->pattern_length,align_input->text_length,penalties,
+          &(align_input->wavefronts_stats),align_input->mm_allocator);
+    } else {
+      affine_wavefronts = affine_wavefronts_new_reduced_2p(
+          align_input->pattern_length,align_input->text_length,penalties,
+          min_wavefront_length,max_distance_threshold,
+          &(align_input->wavefronts_stats),align_input->mm_allocator);
+    }
+    affine_wavefronts_set_cigar_rle(affine_wavefronts,align_input->cigar_rle);
+    affine_wavefronts_set_match(affine_wavefronts,
+        align_input->match.case_insensitive,align_input->match.n);
+    affine_wavefronts_set_zero_copy(affine_wavefronts,
+        align_input->zero_copy,align_input->zero_copy_slack);
+    affine_wavefronts_set_budget_fallback(affine_wavefronts,
+        align_input->budget_min_wavefront_length,align_input->budget_max_distance_threshold);
+    align_input->affine_wavefronts = affine_wavefronts;
+  }
+  // Align
+  timer_start(&align_input->timer);
+  const affine_wavefronts_status_t status = affine_wavefronts_align(affine_wavefronts,
+      align_input->pattern,align_input->pattern_length,
+      align_input->text,align_input->text_length);
+  timer_stop(&align_input->timer);
+  if (status == affine_wavefronts_status_out_of_budget) {
+    counter_add(&align_input->align_out_of_budget,1);
+    return;
+  }
   // Debug alignment
   if (align_input->debug_flags) {
-    benchmark_check_alignment(align_input,&affine_wavefronts->edit_cigar);
+    if (affine_wavefronts->cigar_rle) {
+      benchmark_check_alignment_rle(align_input,&affine_wavefronts->edit_cigar_rle);
+    } else {
+      benchmark_check_alignment(align_input,&affine_wavefronts->edit_cigar);
+    }
+  }
+}
+void benchmark_gap_affine_wavefront_batch(
+    align_input_t* const align_input,
+    affine_penalties_t* const penalties,
+    affine2p_penalties_t* const penalties_2p,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    const int first_sequence_id) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = align_input->mm_allocator;
+  // Allocate (or reuse the batch aligner)
+  if (align_input->affine_wavefronts_batch == NULL) {
+    align_input->affine_wavefronts_batch =
+        affine_wavefronts_batch_new(penalties,penalties_2p,mm_allocator);
+  }
+  // Allocate results (freed, not rewound; the batch aligner grows on demand)
+  affine_wavefronts_result_t* const results =
+      mm_allocator_calloc(mm_allocator,num_pairs,affine_wavefronts_result_t,false);
+  char* const results_arena = mm_allocator_calloc(mm_allocator,
+      affine_wavefronts_batch_arena_size(pairs,num_pairs),char,false);
+  // Align
+  timer_start(&align_input->timer);
+  affine_wavefronts_align_batch(
+      align_input->affine_wavefronts_batch,
+      pairs,num_pairs,results,results_arena);
+  timer_stop(&align_input->timer);
+  // Debug alignments
+  int i;
+  for (i=0;i<num_pairs;++i) {
+    if (results[i].status == affine_wavefronts_status_out_of_budget) {
+      counter_add(&align_input->align_out_of_budget,1);
+      continue;
+    }
+    if (align_input->debug_flags) {
+      align_input->sequence_id = first_sequence_id + i;
+      align_input->pattern = (char*)pairs[i].pattern;
+      align_input->pattern_length = pairs[i].pattern_length;
+      align_input->text = (char*)pairs[i].text;
+      align_input->text_length = pairs[i].text_length;
+      edit_cigar_t edit_cigar = {
+          .operations = results[i].cigar,
+          .max_operations = results[i].cigar_length,
+          .begin_offset = 0,
+          .end_offset = results[i].cigar_length,
+          .score = results[i].score,
+      };
+      benchmark_check_alignment(align_input,&edit_cigar);
+    }
   }
   // Free
-  affine_wavefronts_delete(affine_wavefronts);
+  mm_allocator_free(mm_allocator,results_arena);
+  mm_allocator_free(mm_allocator,results);
+}
+void benchmark_gap_affine_wavefront_lanes(
+    align_input_t* const align_input,
+    affine_penalties_t* const penalties,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    const int first_sequence_id) {
+  // Allocate (or reuse the lane-parallel aligner)
+  if (align_input->affine_wavefronts_lanes == NULL) {
+    align_input->affine_wavefronts_lanes =
+        affine_wavefronts_lanes_new(penalties,align_input->mm_allocator);
+  }
+  // Align
+  int scores[num_pairs];
+  timer_start(&align_input->timer);
+  affine_wavefronts_align_lanes(
+      align_input->affine_wavefronts_lanes,
+      pairs,num_pairs,scores);
+  timer_stop(&align_input->timer);
+  // Debug scores
+  if (align_input->debug_flags) {
+    int i;
+    for (i=0;i<num_pairs;++i) {
+      align_input->sequence_id = first_sequence_id + i;
+      align_input->pattern = (char*)pairs[i].pattern;
+      align_input->pattern_length = pairs[i].pattern_length;
+      align_input->text = (char*)pairs[i].text;
+      align_input->text_length = pairs[i].text_length;
+      benchmark_check_score(align_input,scores[i]);
+    }
+  }
 }
@@ -50,5 +50,31 @@ void benchmark_gap_affine_wavefront(
     affine_penalties_t* const penalties,
     const int min_wavefront_length,
     const int max_distance_threshold);
+void benchmark_gap_affine2p_wavefront(
+    align_input_t* const align_input,
+    affine2p_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold);
+
+/*
+ * Benchmark WFA batch (@penalties_2p != NULL selects two-piece gap-affine)
+ */
+void benchmark_gap_affine_wavefront_batch(
+    align_input_t* const align_input,
+    affine_penalties_t* const penalties,
+    affine2p_penalties_t* const penalties_2p,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    const int first_sequence_id);
+
+/*
+ * Benchmark WFA lanes (score-only)
+ */
+void benchmark_gap_affine_wavefront_lanes(
+    align_input_t* const align_input,
+    affine_penalties_t* const penalties,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    const int first_sequence_id);
 
 #endif /* BENCHMARK_GAP_AFFINE_H_ */
@@ -31,6 +31,7 @@
 
 #include "benchmark/benchmark_gap_lineal.h"
 #include "gap_lineal/nw.h"
+#include "gap_lineal/lineal_wavefront.h"
 
 /*
  * Benchmark NW
@@ -40,6 +41,8 @@ void benchmark_gap_lineal_nw(
     lineal_penalties_t* const penalties) {
   // Allocate
   edit_table_t edit_table;
+  mm_allocator_mark_t mm_mark;
+  mm_allocator_mark(align_input->mm_allocator,&mm_mark);
   edit_table_allocate(
       &edit_table,align_input->pattern_length,
       align_input->text_length,align_input->mm_allocator);
@@ -51,5 +54,37 @@ void benchmark_gap_lineal_nw(
       penalties);
   timer_stop(&align_input->timer);
   // Free
-  edit_table_free(&edit_table,align_input->mm_allocator);
+  mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
+}
+/*
+ * Benchmark Gap-Lineal WFA
+ */
+void benchmark_gap_lineal_wavefront(
+    align_input_t* const align_input,
+    lineal_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold) {
+  // Allocate
+  lineal_wavefronts_t* lineal_wavefronts;
+  if (min_wavefront_length < 0) {
+    lineal_wavefronts = lineal_wavefronts_new_complete(
+        align_input->pattern_length,align_input->text_length,
+        penalties,align_input->mm_allocator);
+  } else {
+    lineal_wavefronts = lineal_wavefronts_new_reduced(
+        align_input->pattern_length,align_input->text_length,penalties,
+        min_wavefront_length,max_distance_threshold,align_input->mm_allocator);
+  }
+  // Align
+  timer_start(&align_input->timer);
+  lineal_wavefronts_align(lineal_wavefronts,
+      align_input->pattern,align_input->pattern_length,
+      align_input->text,align_input->text_length);
+  timer_stop(&align_input->timer);
+  // Debug alignment
+  if (align_input->debug_flags) {
+    benchmark_check_alignment(align_input,&lineal_wavefronts->edit_cigar);
+  }
+  // Free
+  lineal_wavefronts_delete(lineal_wavefronts);
 }
@@ -42,4 +42,13 @@ void benchmark_gap_lineal_nw(
     align_input_t* const align_input,
     lineal_penalties_t* const penalties);
 
+/*
+ * Benchmark Gap-Lineal WFA
+ */
+void benchmark_gap_lineal_wavefront(
+    align_input_t* const align_input,
+    lineal_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold);
+
 #endif /* BENCHMARK_GAP_LINEAL_H_ */
@@ -53,86 +53,237 @@ void benchmark_align_input_clear(
   counter_reset(&(align_input->align_mismatches));
   counter_reset(&(align_input->align_del));
   counter_reset(&(align_input->align_ins));
+  counter_reset(&(align_input->align_out_of_budget));
   wavefronts_stats_clear(&(align_input->wavefronts_stats));
 }
+void benchmark_align_input_combine(
+    align_input_t* const align_input_dst,
+    align_input_t* const align_input_src) {
+  // Timer
+  counter_combine_sum(&(align_input_dst->timer.time_ns),&(align_input_src->timer.time_ns));
+  // Accuracy Stats
+  counter_combine_sum(&(align_input_dst->align),&(align_input_src->align));
+  counter_combine_sum(&(align_input_dst->align_correct),&(align_input_src->align_correct));
+  counter_combine_sum(&(align_input_dst->align_score),&(align_input_src->align_score));
+  counter_combine_sum(&(align_input_dst->align_score_total),&(align_input_src->align_score_total));
+  counter_combine_sum(&(align_input_dst->align_score_diff),&(align_input_src->align_score_diff));
+  counter_combine_sum(&(align_input_dst->align_cigar),&(align_input_src->align_cigar));
+  counter_combine_sum(&(align_input_dst->align_bases),&(align_input_src->align_bases));
+  counter_combine_sum(&(align_input_dst->align_matches),&(align_input_src->align_matches));
+  counter_combine_sum(&(align_input_dst->align_mismatches),&(align_input_src->align_mismatches));
+  counter_combine_sum(&(align_input_dst->align_del),&(align_input_src->align_del));
+  counter_combine_sum(&(align_input_dst->align_ins),&(align_input_src->align_ins));
+  counter_combine_sum(&(align_input_dst->align_out_of_budget),&(align_input_src->align_out_of_budget));
+  wavefronts_stats_combine(&(align_input_dst->wavefronts_stats),&(align_input_src->wavefronts_stats));
+}
 /*
  * Check
  */
+bool benchmark_check_match_relaxed(
+    align_input_t* const align_input) {
+  return align_input->match.case_insensitive ||
+         align_input->match.n != wavefronts_match_n_exact;
+}
+bool benchmark_check_match_run(
+    align_input_t* const align_input,
+    const char operation,
+    const int length,
+    int* const pattern_pos,
+    int* const text_pos) {
+  switch (operation) {
+    case 'M':
+    case 'X': {
+      // Check bounds
+      if (*pattern_pos+length > align_input->pattern_length ||
+          *text_pos+length > align_input->text_length) {
+        if (align_input->verbose) fprintf(stderr,"Align Check. Alignment exceeds sequences length\n");
+        return false;
+      }
+      // Check matches/mismatches (using the matching semantics)
+      int i;
+      for (i=0;i<length;++i,++(*pattern_pos),++(*text_pos)) {
+        const bool match = affine_wavefronts_match_chars(&align_input->match,
+            align_input->pattern[*pattern_pos],align_input->text[*text_pos]);
+        if (match != (operation=='M')) {
+          if (align_input->verbose) {
+            fprintf(stderr,"Align Check. Alignment not %s (pattern[%d]=%c text[%d]=%c)\n",
+                (operation=='M') ? "matching" : "mismatching",*pattern_pos,
+                align_input->pattern[*pattern_pos],*text_pos,align_input->text[*text_pos]);
+          }
+          return false;
+        }
+      }
+      return true;
+    }
+    case 'I': *text_pos += length; return true;
+    case 'D': *pattern_pos += length; return true;
+    default:
+      fprintf(stderr,"Align Check. Unknown edit operation '%c'\n",operation);
+      exit(1);
+  }
+}
+bool benchmark_check_match_length(
+    align_input_t* const align_input,
+    const int pattern_pos,
+    const int text_pos) {
+  if (pattern_pos != align_input->pattern_length || text_pos != align_input->text_length) {
+    if (align_input->verbose) {
+      fprintf(stderr,"Align Check. Alignment incorrect length "
+          "(pattern-aligned=%d,pattern-length=%d,text-aligned=%d,text-length=%d)\n",
+          pattern_pos,align_input->pattern_length,text_pos,align_input->text_length);
+    }
+    return false;
+  }
+  return true;
+}
+bool benchmark_check_match(
+    align_input_t* const align_input,
+    edit_cigar_t* const edit_cigar) {
+  // Exact matching
+  if (!benchmark_check_match_relaxed(align_input)) {
+    return edit_cigar_check_alignment(stderr,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length,
+        edit_cigar,align_input->verbose);
+  }
+  // Relaxed matching (traverse CIGAR operation runs)
+  int pattern_pos=0, text_pos=0, i=edit_cigar->begin_offset;
+  while (i < edit_cigar->end_offset) {
+    const int length = edit_cigar_get_run_length(
+        edit_cigar->operations+i,edit_cigar->end_offset-i);
+    if (!benchmark_check_match_run(align_input,
+        edit_cigar->operations[i],length,&pattern_pos,&text_pos)) return false;
+    i += length;
+  }
+  return benchmark_check_match_length(align_input,pattern_pos,text_pos);
+}
+bool benchmark_check_match_rle(
+    align_input_t* const align_input,
+    edit_cigar_rle_t* const cigar_rle) {
+  // Exact matching
+  if (!benchmark_check_match_relaxed(align_input)) {
+    return edit_cigar_rle_check_alignment(stderr,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length,
+        cigar_rle,align_input->verbose);
+  }
+  // Relaxed matching (traverse RLE-CIGAR runs)
+  int pattern_pos=0, text_pos=0, i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    if (!benchmark_check_match_run(align_input,EDIT_CIGAR_RLE_RUN_CHAR(run),
+        EDIT_CIGAR_RLE_RUN_LENGTH(run),&pattern_pos,&text_pos)) return false;
+  }
+  return benchmark_check_match_length(align_input,pattern_pos,text_pos);
+}
+edit_cigar_t* benchmark_check_alignment_compute_correct(
+    align_input_t* const align_input) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = align_input->mm_allocator;
+  // Compute correct CIGAR (table allocated from the MM; rewound by the caller)
+  if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P) {
+    affine2p_table_t* const affine2p_table = mm_allocator_alloc(mm_allocator,affine2p_table_t);
+    affine2p_table_allocate(
+        affine2p_table,align_input->pattern_length,
+        align_input->text_length,mm_allocator);
+    swg_compute_2p_match(affine2p_table,
+        align_input->check_affine2p_penalties,&align_input->match,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length); // (Unbanded)
+    return &affine2p_table->edit_cigar;
+  } else if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE) {
+    affine_table_t* const affine_table = mm_allocator_alloc(mm_allocator,affine_table_t);
+    affine_table_allocate(
+        affine_table,align_input->pattern_length,
+        align_input->text_length,mm_allocator);
+    if (benchmark_check_match_relaxed(align_input)) {
+      swg_compute_match(affine_table,
+          align_input->check_affine_penalties,&align_input->match,
+          align_input->pattern,align_input->pattern_length,
+          align_input->text,align_input->text_length); // (Unbanded)
+    } else if (align_input->check_bandwidth <= 0) {
+      swg_compute(affine_table,align_input->check_affine_penalties,
+          align_input->pattern,align_input->pattern_length,
+          align_input->text,align_input->text_length);
+    } else {
+      swg_compute_banded(affine_table,align_input->check_affine_penalties,
+          align_input->pattern,align_input->pattern_length,
+          align_input->text,align_input->text_length,
+          align_input->check_bandwidth);
+    }
+    return &affine_table->edit_cigar;
+  } else if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_LINEAL) {
+    edit_table_t* const edit_table = mm_allocator_alloc(mm_allocator,edit_table_t);
+    edit_table_allocate(
+        edit_table,align_input->pattern_length,
+        align_input->text_length,mm_allocator);
+    nw_compute(edit_table,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length,align_input->check_lineal_penalties);
+    return &edit_table->edit_cigar;
+  } else { // ALIGN_DEBUG_CHECK_DISTANCE_METRIC_EDIT
+    edit_table_t* const edit_table = mm_allocator_alloc(mm_allocator,edit_table_t);
+    edit_table_allocate(
+        edit_table,align_input->pattern_length,
+        align_input->text_length,mm_allocator);
+    if (align_input->check_bandwidth <= 0) {
+      edit_dp_compute(edit_table,
+          align_input->pattern,align_input->pattern_length,
+          align_input->text,align_input->text_length);
+    } else {
+      edit_dp_compute_banded(edit_table,
+          align_input->pattern,align_input->pattern_length,
+          align_input->text,align_input->text_length,
+          align_input->check_bandwidth);
+    }
+    return &edit_table->edit_cigar;
+  }
+}
+int benchmark_check_alignment_score(
+    align_input_t* const align_input,
+    edit_cigar_t* const edit_cigar) {
+  if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P) {
+    return edit_cigar_score_gap_affine2p(edit_cigar,align_input->check_affine2p_penalties);
+  } else if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE) {
+    return edit_cigar_score_gap_affine(edit_cigar,align_input->check_affine_penalties);
+  } else if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_LINEAL) {
+    return edit_cigar_score_gap_lineal(edit_cigar,align_input->check_lineal_penalties);
+  } else { // ALIGN_DEBUG_CHECK_DISTANCE_METRIC_EDIT
+    return edit_cigar_score_edit(edit_cigar);
+  }
+}
+int benchmark_check_alignment_score_rle(
+    align_input_t* const align_input,
+    edit_cigar_rle_t* const cigar_rle) {
+  if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P) {
+    return edit_cigar_rle_score_gap_affine2p(cigar_rle,align_input->check_affine2p_penalties);
+  } else if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE) {
+    return edit_cigar_rle_score_gap_affine(cigar_rle,align_input->check_affine_penalties);
+  } else if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_LINEAL) {
+    return edit_cigar_rle_score_gap_lineal(cigar_rle,align_input->check_lineal_penalties);
+  } else { // ALIGN_DEBUG_CHECK_DISTANCE_METRIC_EDIT
+    return edit_cigar_rle_score_edit(cigar_rle);
+  }
+}
 void benchmark_check_alignment(
     align_input_t* const align_input,
     edit_cigar_t* const edit_cigar_computed) {
   // Compute correct CIGAR
   if ((align_input->debug_flags & ALIGN_DEBUG_CHECK_SCORE) ||
       (align_input->debug_flags & ALIGN_DEBUG_CHECK_ALIGNMENT)) {
-    if (align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE) {
-      // Compute correct
-      affine_table_t affine_table;
-      affine_table_allocate(
-          &affine_table,align_input->pattern_length,
-          align_input->text_length,align_input->mm_allocator);
-      if (align_input->check_bandwidth <= 0) {
-        swg_compute(&affine_table,align_input->check_affine_penalties,
-            align_input->pattern,align_input->pattern_length,
-            align_input->text,align_input->text_length);
-      } else {
-        swg_compute_banded(&affine_table,align_input->check_affine_penalties,
-            align_input->pattern,align_input->pattern_length,
-            align_input->text,align_input->text_length,
-            align_input->check_bandwidth);
-      }
-      const int score_correct = edit_cigar_score_gap_affine(
-          &affine_table.edit_cigar,align_input->check_affine_penalties);
-      const int score_computed = edit_cigar_score_gap_affine(
-          edit_cigar_computed,align_input->check_affine_penalties);
-      // Check alignment
-      benchmark_check_alignment_using_template(
-          align_input,edit_cigar_computed,score_computed,
-          &affine_table.edit_cigar,score_correct);
-      // Free
-      affine_table_free(&affine_table,align_input->mm_allocator);
-    } else if(align_input->debug_flags & ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_LINEAL) {
-      // Compute correct
-      edit_table_t edit_table;
-      edit_table_allocate(
-          &edit_table,align_input->pattern_length,
-          align_input->text_length,align_input->mm_allocator);
-      nw_compute(&edit_table,
-          align_input->pattern,align_input->pattern_length,
-          align_input->text,align_input->text_length,align_input->check_lineal_penalties);
-      const int score_correct = edit_cigar_score_gap_lineal(
-          &edit_table.edit_cigar,align_input->check_lineal_penalties);
-      const int score_computed = edit_cigar_score_gap_lineal(
-          edit_cigar_computed,align_input->check_lineal_penalties);
-      // Check alignment
-      benchmark_check_alignment_using_template(
-          align_input,edit_cigar_computed,score_computed,
-          &edit_table.edit_cigar,score_correct);
-      // Free
-      edit_table_free(&edit_table,align_input->mm_allocator);
-    } else { // ALIGN_DEBUG_CHECK_DISTANCE_METRIC_EDIT
-      edit_table_t edit_table;
-      edit_table_allocate(
-          &edit_table,align_input->pattern_length,
-          align_input->text_length,align_input->mm_allocator);
-      if (align_input->check_bandwidth <= 0) {
-        edit_dp_compute(&edit_table,
-            align_input->pattern,align_input->pattern_length,
-            align_input->text,align_input->text_length);
-      } else {
-        edit_dp_compute_banded(&edit_table,
-            align_input->pattern,align_input->pattern_length,
-            align_input->text,align_input->text_length,
-            align_input->check_bandwidth);
-      }
-      const int score_correct = edit_cigar_score_edit(&edit_table.edit_cigar);
-      const int score_computed = edit_cigar_score_edit(edit_cigar_computed);
-      // Check alignment
-      benchmark_check_alignment_using_template(
-          align_input,edit_cigar_computed,score_computed,
-          &edit_table.edit_cigar,score_correct);
-      // Free
-      edit_table_free(&edit_table,align_input->mm_allocator);
-    }
+    // Compute correct
+    mm_allocator_mark_t mm_mark;
+    mm_allocator_mark(align_input->mm_allocator,&mm_mark);
+    edit_cigar_t* const edit_cigar_correct =
+        benchmark_check_alignment_compute_correct(align_input);
+    const int score_correct = benchmark_check_alignment_score(align_input,edit_cigar_correct);
+    const int score_computed = benchmark_check_alignment_score(align_input,edit_cigar_computed);
+    // Check alignment
+    benchmark_check_alignment_using_template(
+        align_input,edit_cigar_computed,score_computed,
+        edit_cigar_correct,score_correct);
+    // Free
+    mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
   } else {
     // Delegate check alignment
     const int score_computed = edit_cigar_score_edit(edit_cigar_computed);
@@ -140,6 +291,32 @@ void benchmark_check_alignment(
         align_input,edit_cigar_computed,score_computed,NULL,-1);
   }
 }
+void benchmark_check_alignment_rle(
+    align_input_t* const align_input,
+    edit_cigar_rle_t* const cigar_rle_computed) {
+  // Compute correct CIGAR
+  if ((align_input->debug_flags & ALIGN_DEBUG_CHECK_SCORE) ||
+      (align_input->debug_flags & ALIGN_DEBUG_CHECK_ALIGNMENT)) {
+    // Compute correct
+    mm_allocator_mark_t mm_mark;
+    mm_allocator_mark(align_input->mm_allocator,&mm_mark);
+    edit_cigar_t* const edit_cigar_correct =
+        benchmark_check_alignment_compute_correct(align_input);
+    const int score_correct = benchmark_check_alignment_score(align_input,edit_cigar_correct);
+    const int score_computed = benchmark_check_alignment_score_rle(align_input,cigar_rle_computed);
+    // Check alignment
+    benchmark_check_alignment_rle_using_template(
+        align_input,cigar_rle_computed,score_computed,
+        edit_cigar_correct,score_correct);
+    // Free
+    mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table, CIGAR & RLE-CIGAR
+  } else {
+    // Delegate check alignment
+    const int score_computed = edit_cigar_rle_score_edit(cigar_rle_computed);
+    benchmark_check_alignment_rle_using_template(
+        align_input,cigar_rle_computed,score_computed,NULL,-1);
+  }
+}
 void benchmark_check_alignment_using_template(
     align_input_t* const align_input,
     edit_cigar_t* const edit_cigar_computed,
@@ -156,10 +333,7 @@ void benchmark_check_alignment_using_template(
     }
     // Check correct
     if (align_input->debug_flags & ALIGN_DEBUG_CHECK_CORRECT) {
-      bool correct = edit_cigar_check_alignment(stderr,
-          align_input->pattern,align_input->pattern_length,
-          align_input->text,align_input->text_length,
-          edit_cigar_computed,align_input->verbose);
+      bool correct = benchmark_check_match(align_input,edit_cigar_computed);
       if (!correct) {
         // Print
         if (align_input->verbose) {
@@ -172,16 +346,13 @@ void benchmark_check_alignment_using_template(
         counter_add(&(align_input->align_correct),1);
       }
       // CIGAR Stats
-      int i;
+      edit_cigar_stats_t stats;
+      edit_cigar_get_stats(edit_cigar_computed,&stats);
       counter_add(&(align_input->align_bases),align_input->pattern_length);
-      for (i=edit_cigar_computed->begin_offset;i<edit_cigar_computed->end_offset;++i) {
-        switch (edit_cigar_computed->operations[i]) {
-          case 'M': counter_add(&(align_input->align_matches),1); break;
-          case 'X': counter_add(&(align_input->align_mismatches),1); break;
-          case 'I': counter_add(&(align_input->align_ins),1); break;
-          case 'D': default: counter_add(&(align_input->align_del),1); break;
-        }
-      }
+      counter_add(&(align_input->align_matches),stats.matches);
+      counter_add(&(align_input->align_mismatches),stats.mismatches);
+      counter_add(&(align_input->align_ins),stats.insertions);
+      counter_add(&(align_input->align_del),stats.deletions);
     }
     // Check score
     if (align_input->debug_flags & ALIGN_DEBUG_CHECK_SCORE) {
@@ -221,6 +392,119 @@ void benchmark_check_alignment_using_template(
     }
   }
 }
+void benchmark_check_alignment_rle_using_template(
+    align_input_t* const align_input,
+    edit_cigar_rle_t* const cigar_rle_computed,
+    const int score_computed,
+    edit_cigar_t* const edit_cigar_correct,
+    const int score_correct) {
+  counter_add(&(align_input->align),1);
+  counter_add(&(align_input->align_score_total),ABS(score_computed));
+  // Debug
+  if (align_input->debug_flags) {
+    // Display info
+    if (align_input->debug_flags & ALIGN_DEBUG_DISPLAY_INFO) {
+      benchmark_print_alignment_rle(stderr,align_input,score_computed,cigar_rle_computed,-1,NULL);
+    }
+    // Check correct
+    if (align_input->debug_flags & ALIGN_DEBUG_CHECK_CORRECT) {
+      bool correct = benchmark_check_match_rle(align_input,cigar_rle_computed);
+      if (!correct) {
+        // Print
+        if (align_input->verbose) {
+          fprintf(stderr,"INCORRECT ALIGNMENT\n");
+          benchmark_print_alignment_rle(stderr,align_input,-1,cigar_rle_computed,-1,NULL);
+        }
+        // Quit
+        return;
+      } else {
+        counter_add(&(align_input->align_correct),1);
+      }
+      // CIGAR Stats
+      edit_cigar_stats_t stats;
+      edit_cigar_rle_get_stats(cigar_rle_computed,&stats);
+      counter_add(&(align_input->align_bases),align_input->pattern_length);
+      counter_add(&(align_input->align_matches),stats.matches);
+      counter_add(&(align_input->align_mismatches),stats.mismatches);
+      counter_add(&(align_input->align_ins),stats.insertions);
+      counter_add(&(align_input->align_del),stats.deletions);
+    }
+    // Check score
+    if (align_input->debug_flags & ALIGN_DEBUG_CHECK_SCORE) {
+      if (score_computed != score_correct) {
+        // Print
+        if (align_input->verbose) {
+          benchmark_print_alignment_rle(
+              stderr,align_input,
+              score_computed,cigar_rle_computed,
+              score_correct,edit_cigar_correct);
+          fprintf(stderr,"(#%d)\t INACCURATE SCORE computed=%d\tcorrect=%d\n",
+              align_input->sequence_id,score_computed,score_correct);
+        }
+        counter_add(&(align_input->align_score_diff),ABS(score_computed-score_correct));
+        // Quit
+        return;
+      } else {
+        counter_add(&(align_input->align_score),1);
+      }
+    }
+    // Check alignment (against the correct CIGAR run-length encoded)
+    if (align_input->debug_flags & ALIGN_DEBUG_CHECK_ALIGNMENT) {
+      edit_cigar_rle_t cigar_rle_correct;
+      edit_cigar_rle_allocate(&cigar_rle_correct,
+          edit_cigar_correct->end_offset-edit_cigar_correct->begin_offset,
+          align_input->mm_allocator);
+      edit_cigar_rle_compact(&cigar_rle_correct,edit_cigar_correct);
+      const int cmp = edit_cigar_rle_cmp(cigar_rle_computed,&cigar_rle_correct);
+      edit_cigar_rle_free(&cigar_rle_correct);
+      if (cmp != 0) {
+        // Print
+        if (align_input->verbose) {
+          fprintf(stderr,"INACCURATE ALIGNMENT\n");
+          benchmark_print_alignment_rle(
+              stderr,align_input,
+              -1,cigar_rle_computed,
+              -1,edit_cigar_correct);
+        }
+        // Quit
+        return;
+      } else {
+        counter_add(&(align_input->align_cigar),1);
+      }
+    }
+  }
+}
+void benchmark_check_score(
+    align_input_t* const align_input,
+    const int score_computed) {
+  counter_add(&(align_input->align),1);
+  counter_add(&(align_input->align_score_total),ABS(score_computed));
+  // Check score (score-only aligners; no CIGAR to check)
+  if (align_input->debug_flags & ALIGN_DEBUG_CHECK_SCORE) {
+    // Compute correct
+    mm_allocator_mark_t mm_mark;
+    mm_allocator_mark(align_input->mm_allocator,&mm_mark);
+    edit_cigar_t* const edit_cigar_correct =
+        benchmark_check_alignment_compute_correct(align_input);
+    const int score_correct = benchmark_check_alignment_score(align_input,edit_cigar_correct);
+    if (score_computed != score_correct) {
+      // Print
+      if (align_input->verbose) {
+        benchmark_print_alignment(
+            stderr,align_input,
+            score_computed,NULL,
+            score_correct,edit_cigar_correct);
+        fprintf(stderr,"(#%d)\t INACCURATE SCORE computed=%d\tcorrect=%d\n",
+            align_input->sequence_id,score_computed,score_correct);
+      }
+      counter_add(&(align_input->align_score_diff),ABS(score_computed-score_correct));
+    } else {
+      counter_add(&(align_input->align_score),1);
+    }
+    // Free
+    mm_allocator_rewind(align_input->mm_allocator,&mm_mark); // Table & CIGAR
+  }
+}
 /*
  * Display
  */
@@ -259,6 +543,35 @@ void benchmark_print_alignment(
         cigar_correct,align_input->mm_allocator);
   }
 }
+void benchmark_print_alignment_rle(
+    FILE* const stream,
+    align_input_t* const align_input,
+    const int score_computed,
+    edit_cigar_rle_t* const cigar_rle_computed,
+    const int score_correct,
+    edit_cigar_t* const cigar_correct) {
+  // Print Sequence
+  fprintf(stream,"ALIGNMENT (#%d)\n",align_input->sequence_id);
+  fprintf(stream,"  PATTERN  %s\n",align_input->pattern);
+  fprintf(stream,"  TEXT     %s\n",align_input->text);
+  // Print CIGARS
+  if (cigar_rle_computed != NULL) {
+    fprintf(stream,"    COMPUTED\tscore=%d\t",score_computed);
+    edit_cigar_rle_print(stream,cigar_rle_computed);
+    fprintf(stream,"\n");
+  }
+  if (cigar_correct != NULL && score_correct != -1) {
+    fprintf(stream,"    CORRECT \tscore=%d\t",score_correct);
+    edit_cigar_print(stream,cigar_correct);
+    fprintf(stream,"\n");
+  }
+  if (cigar_correct != NULL) {
+    edit_cigar_print_pretty(stream,
+        align_input->pattern,align_input->pattern_length,
+        align_input->text,align_input->text_length,
+        cigar_correct,align_input->mm_allocator);
+  }
+}
 /*
  * Stats
  */
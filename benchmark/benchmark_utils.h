@@ -36,7 +36,11 @@
 #include "system/mm_allocator.h"
 #include "system/profiler_timer.h"
 #include "edit/edit_table.h"
+#include "edit/edit_cigar_rle.h"
 #include "gap_affine/wavefront_stats.h"
+#include "gap_affine/affine_wavefront.h"
+#include "gap_affine/affine_wavefront_batch.h"
+#include "gap_affine/affine_wavefront_lanes.h"
 
 /*
  * Constants
@@ -49,6 +53,7 @@
 #define ALIGN_DEBUG_CHECK_DISTANCE_METRIC_EDIT       0x00000010
 #define ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_LINEAL 0x00000040
 #define ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE 0x00000080
+#define ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P 0x00000100
 
 /*
  * Alignment Input
@@ -66,9 +71,24 @@ typedef struct {
   profiler_timer_t timer;
   // MM
   mm_allocator_t* mm_allocator;
+  affine_wavefronts_t* affine_wavefronts; // Reusable aligner (resized for each pair)
+  affine_wavefronts_batch_t* affine_wavefronts_batch; // Reusable batch aligner
+  affine_wavefronts_lanes_t* affine_wavefronts_lanes; // Reusable lane-parallel aligner (score-only)
+  // Output
+  bool cigar_rle;                         // Emit RLE-CIGARs (WFA gap-affine)
+  // Matching
+  affine_wavefronts_match_t match;        // Matching semantics (WFA gap-affine extension & check)
+  // Input
+  bool zero_copy;                         // Align on the input buffers (WFA gap-affine)
+  int zero_copy_slack;                    // Readable bytes past the end of the input buffers
+  // Memory budget
+  int budget_min_wavefront_length;        // Retry out-of-budget alignments using adaptive WFA (-1 = disabled)
+  int budget_max_distance_threshold;      // Retry adaptive WFA (maximum distance)
+  profiler_counter_t align_out_of_budget; // Alignments aborted (over the memory budget)
   // Check
   lineal_penalties_t* check_lineal_penalties;
   affine_penalties_t* check_affine_penalties;
+  affine2p_penalties_t* check_affine2p_penalties;
   int check_bandwidth;
   // STATS
   profiler_counter_t align;
@@ -93,6 +113,9 @@ typedef struct {
  */
 void benchmark_align_input_clear(
     align_input_t* const align_input);
+void benchmark_align_input_combine(
+    align_input_t* const align_input_dst,
+    align_input_t* const align_input_src);
 
 /*
  * Check
@@ -106,6 +129,18 @@ void benchmark_check_alignment_using_template(
     const int score_computed,
     edit_cigar_t* const edit_cigar_correct,
     const int score_correct);
+void benchmark_check_alignment_rle(
+    align_input_t* const align_input,
+    edit_cigar_rle_t* const cigar_rle_computed);
+void benchmark_check_alignment_rle_using_template(
+    align_input_t* const align_input,
+    edit_cigar_rle_t* const cigar_rle_computed,
+    const int score_computed,
+    edit_cigar_t* const edit_cigar_correct,
+    const int score_correct);
+void benchmark_check_score(
+    align_input_t* const align_input,
+    const int score_computed);
 
 /*
  * Display
@@ -117,6 +152,13 @@ void benchmark_print_alignment(
     edit_cigar_t* const cigar_computed,
     const int score_correct,
     edit_cigar_t* const cigar_correct);
+void benchmark_print_alignment_rle(
+    FILE* const stream,
+    align_input_t* const align_input,
+    const int score_computed,
+    edit_cigar_rle_t* const cigar_rle_computed,
+    const int score_correct,
+    edit_cigar_t* const cigar_correct);
 
 /*
  * Stats
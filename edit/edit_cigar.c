@@ -56,17 +56,75 @@ void edit_cigar_free(
     mm_allocator_t* const mm_allocator) {
   mm_allocator_free(mm_allocator,edit_cigar->operations);
 }
+/*
+ * Packed operations (8 operations per 64-bit block)
+ */
+uint64_t edit_cigar_load_block(
+    const char* const operations,
+    const int length) {
+  uint64_t block = 0;
+  memcpy(&block,operations,MIN(length,8)); // Zero-padded (never an operation)
+  return block;
+}
 /*
  * Accessors
  */
 int edit_cigar_get_matches(
     edit_cigar_t* const edit_cigar) {
+  const char* const operations = edit_cigar->operations + edit_cigar->begin_offset;
+  const int num_operations = edit_cigar->end_offset - edit_cigar->begin_offset;
   int i, num_matches=0;
-  for (i=edit_cigar->begin_offset;i<edit_cigar->end_offset;++i) {
-    num_matches += (edit_cigar->operations[i]=='M');
+  for (i=0;i<num_operations;i+=8) {
+    const uint64_t block = edit_cigar_load_block(operations+i,num_operations-i);
+    num_matches += __builtin_popcountl(SWAR_EQ_BYTES(block,'M'));
   }
   return num_matches;
 }
+int edit_cigar_get_run_length(
+    const char* const operations,
+    const int max_length) {
+  // Compare blocks against the first operation
+  const char operation = operations[0];
+  int length = 0;
+  while (length < max_length) {
+    const uint64_t block = edit_cigar_load_block(operations+length,max_length-length);
+    const uint64_t differ = ~SWAR_EQ_BYTES(block,operation) & SWAR_HIGH;
+    if (differ) return MIN(length+__builtin_ctzl(differ)/8,max_length);
+    length += 8;
+  }
+  return max_length;
+}
+void edit_cigar_get_stats(
+    edit_cigar_t* const edit_cigar,
+    edit_cigar_stats_t* const stats) {
+  // Parameters
+  const char* const operations = edit_cigar->operations + edit_cigar->begin_offset;
+  const int num_operations = edit_cigar->end_offset - edit_cigar->begin_offset;
+  // Init
+  memset(stats,0,sizeof(edit_cigar_stats_t));
+  stats->num_operations = num_operations;
+  // Count operations (gap opens are detected against the operations shifted by one)
+  uint64_t last_block = 0;
+  int i;
+  for (i=0;i<num_operations;i+=8) {
+    const uint64_t block = edit_cigar_load_block(operations+i,num_operations-i);
+    const uint64_t previous = (block << 8) | (last_block >> 56);
+    const uint64_t ins = SWAR_EQ_BYTES(block,'I');
+    const uint64_t del = SWAR_EQ_BYTES(block,'D');
+    stats->matches += __builtin_popcountl(SWAR_EQ_BYTES(block,'M'));
+    stats->mismatches += __builtin_popcountl(SWAR_EQ_BYTES(block,'X'));
+    stats->insertions += __builtin_popcountl(ins);
+    stats->deletions += __builtin_popcountl(del);
+    stats->insertion_opens += __builtin_popcountl(ins & ~SWAR_EQ_BYTES(previous,'I'));
+    stats->deletion_opens += __builtin_popcountl(del & ~SWAR_EQ_BYTES(previous,'D'));
+    last_block = block;
+  }
+}
+bool edit_cigar_stats_valid(
+    edit_cigar_stats_t* const stats) {
+  return stats->matches + stats->mismatches +
+         stats->insertions + stats->deletions == stats->num_operations;
+}
 void edit_cigar_add_mismatches(
     char* const pattern,
     const int pattern_length,
@@ -109,63 +167,81 @@ void edit_cigar_add_mismatches(
  */
 int edit_cigar_score_edit(
     edit_cigar_t* const edit_cigar) {
-  int score = 0, i;
-  for (i=edit_cigar->begin_offset;i<edit_cigar->end_offset;++i) {
-    switch (edit_cigar->operations[i]) {
-      case 'M': break;
-      case 'X':
-      case 'D':
-      case 'I': ++score; break;
-      default: return INT_MIN;
-    }
-  }
-  return score;
+  edit_cigar_stats_t stats;
+  edit_cigar_get_stats(edit_cigar,&stats);
+  if (!edit_cigar_stats_valid(&stats)) return INT_MIN;
+  return stats.mismatches + stats.insertions + stats.deletions;
 }
 int edit_cigar_score_gap_lineal(
     edit_cigar_t* const edit_cigar,
     lineal_penalties_t* const penalties) {
-  int score = 0, i;
-  for (i=edit_cigar->begin_offset;i<edit_cigar->end_offset;++i) {
-    switch (edit_cigar->operations[i]) {
-      case 'M': score -= penalties->match; break;
-      case 'X': score -= penalties->mismatch; break;
-      case 'I': score -= penalties->insertion; break;
-      case 'D': score -= penalties->deletion; break;
-      default: return INT_MIN;
-    }
-  }
-  return score;
+  edit_cigar_stats_t stats;
+  edit_cigar_get_stats(edit_cigar,&stats);
+  if (!edit_cigar_stats_valid(&stats)) return INT_MIN;
+  return -(stats.matches*penalties->match +
+           stats.mismatches*penalties->mismatch +
+           stats.insertions*penalties->insertion +
+           stats.deletions*penalties->deletion);
 }
 int edit_cigar_score_gap_affine(
     edit_cigar_t* const edit_cigar,
     affine_penalties_t* const penalties) {
+  edit_cigar_stats_t stats;
+  edit_cigar_get_stats(edit_cigar,&stats);
+  if (!edit_cigar_stats_valid(&stats)) {
+    fprintf(stderr,"Computing CIGAR score: Unknown operation\n");
+    exit(1);
+  }
+  return edit_cigar_stats_score_gap_affine(&stats,penalties);
+}
+int edit_cigar_score_gap_affine2p_get_operations_score(
+    const char operation,
+    const int op_length,
+    affine2p_penalties_t* const penalties) {
+  switch (operation) {
+    case 'M': return op_length*penalties->match;
+    case 'X': return op_length*penalties->mismatch;
+    case 'D':
+    case 'I': {
+      const int score1 = penalties->gap_opening1 + penalties->gap_extension1*op_length;
+      const int score2 = penalties->gap_opening2 + penalties->gap_extension2*op_length;
+      return MIN(score1,score2);
+    }
+    default:
+      fprintf(stderr,"Computing CIGAR score: Unknown operation\n");
+      exit(1);
+  }
+}
+int edit_cigar_score_gap_affine2p(
+    edit_cigar_t* const edit_cigar,
+    affine2p_penalties_t* const penalties) {
   char last_op = '\0';
-  int score = 0, i;
+  int score = 0, op_length = 0, i;
   for (i=edit_cigar->begin_offset;i<edit_cigar->end_offset;++i) {
-    switch (edit_cigar->operations[i]) {
-      case 'M':
-        score -= penalties->match;
-        last_op = 'M';
-        break;
-      case 'X':
-        score -= penalties->mismatch;
-        last_op = 'X';
-        break;
-      case 'D':
-        score -= penalties->gap_extension + ((last_op=='D') ? 0 : penalties->gap_opening);
-        last_op = 'D';
-        break;
-      case 'I':
-        score -= penalties->gap_extension + ((last_op=='I') ? 0 : penalties->gap_opening);
-        last_op = 'I';
-        break;
-      default:
-        fprintf(stderr,"Computing CIGAR score: Unknown operation\n");
-        exit(1);
+    // Account for operation runs
+    if (edit_cigar->operations[i] != last_op && last_op != '\0') {
+      score -= edit_cigar_score_gap_affine2p_get_operations_score(last_op,op_length,penalties);
+      op_length = 0;
     }
+    last_op = edit_cigar->operations[i];
+    ++op_length;
+  }
+  // Account for last operation run
+  if (last_op != '\0') {
+    score -= edit_cigar_score_gap_affine2p_get_operations_score(last_op,op_length,penalties);
   }
   return score;
 }
+int edit_cigar_stats_score_gap_affine(
+    edit_cigar_stats_t* const stats,
+    affine_penalties_t* const penalties) {
+  const int num_gap_opens = stats->insertion_opens + stats->deletion_opens;
+  const int num_gap_bases = stats->insertions + stats->deletions;
+  return -(stats->matches*penalties->match +
+           stats->mismatches*penalties->mismatch +
+           num_gap_opens*penalties->gap_opening +
+           num_gap_bases*penalties->gap_extension);
+}
 /*
  * Utils
  */
@@ -208,45 +284,49 @@ bool edit_cigar_check_alignment(
     edit_cigar_t* const edit_cigar,
     const bool verbose) {
   // Parameters
-  char* const operations = edit_cigar->operations;
-  // Traverse CIGAR
-  int pattern_pos=0, text_pos=0, i;
-  for (i=edit_cigar->begin_offset;i<edit_cigar->end_offset;++i) {
-    switch (operations[i]) {
+  const char* const operations = edit_cigar->operations;
+  // Traverse CIGAR (operation runs)
+  int pattern_pos=0, text_pos=0, i=edit_cigar->begin_offset, j;
+  while (i < edit_cigar->end_offset) {
+    const char operation = operations[i];
+    const int length = edit_cigar_get_run_length(operations+i,edit_cigar->end_offset-i);
+    i += length;
+    switch (operation) {
       case 'M':
-        // Check match
-        if (pattern[pattern_pos] != text[text_pos]) {
-          if (verbose) {
-            fprintf(stream,
-                "Align Check. Alignment not matching (pattern[%d]=%c != text[%d]=%c)\n",
-                pattern_pos,pattern[pattern_pos],text_pos,text[text_pos]);
-          }
+      case 'X': {
+        // Check bounds
+        if (pattern_pos+length > pattern_length || text_pos+length > text_length) {
+          if (verbose) fprintf(stream,"Align Check. Alignment exceeds sequences length\n");
           return false;
         }
-        ++pattern_pos;
-        ++text_pos;
-        break;
-      case 'X':
-        // Check mismatch
-        if (pattern[pattern_pos] == text[text_pos]) {
-          if (verbose) {
-            fprintf(stream,
-                "Align Check. Alignment not mismatching (pattern[%d]=%c == text[%d]=%c)\n",
-                pattern_pos,pattern[pattern_pos],text_pos,text[text_pos]);
+        // Check matches (whole run at once) & mismatches
+        const bool match = (operation == 'M');
+        if (match && memcmp(pattern+pattern_pos,text+text_pos,length)==0) {
+          pattern_pos += length;
+          text_pos += length;
+          break;
+        }
+        for (j=0;j<length;++j,++pattern_pos,++text_pos) {
+          if ((pattern[pattern_pos] == text[text_pos]) != match) {
+            if (verbose) {
+              fprintf(stream,
+                  "Align Check. Alignment not %s (pattern[%d]=%c %s text[%d]=%c)\n",
+                  match ? "matching" : "mismatching",pattern_pos,pattern[pattern_pos],
+                  match ? "!=" : "==",text_pos,text[text_pos]);
+            }
+            return false;
           }
-          return false;
         }
-        ++pattern_pos;
-        ++text_pos;
         break;
+      }
       case 'I':
-        ++text_pos;
+        text_pos += length;
         break;
       case 'D':
-        ++pattern_pos;
+        pattern_pos += length;
         break;
       default:
-        fprintf(stderr,"CIGAR check. Unknown edit operation '%c'\n",operations[i]);
+        fprintf(stderr,"CIGAR check. Unknown edit operation '%c'\n",operation);
         exit(1);
         break;
     }
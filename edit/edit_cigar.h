@@ -48,6 +48,19 @@ typedef struct {
   int score;
 } edit_cigar_t;
 
+/*
+ * CIGAR Stats
+ */
+typedef struct {
+  int num_operations;    // Total operations
+  int matches;           // Matches ('M')
+  int mismatches;        // Mismatches ('X')
+  int insertions;        // Inserted bases ('I')
+  int deletions;         // Deleted bases ('D')
+  int insertion_opens;   // Insertion gaps (runs of 'I')
+  int deletion_opens;    // Deletion gaps (runs of 'D')
+} edit_cigar_stats_t;
+
 /*
  * Distance metrics
  */
@@ -76,6 +89,12 @@ void edit_cigar_free(
  */
 int edit_cigar_get_matches(
     edit_cigar_t* const edit_cigar);
+int edit_cigar_get_run_length(
+    const char* const operations,
+    const int max_length);
+void edit_cigar_get_stats(
+    edit_cigar_t* const edit_cigar,
+    edit_cigar_stats_t* const stats);
 void edit_cigar_add_mismatches(
     char* const pattern,
     const int pattern_length,
@@ -94,6 +113,12 @@ int edit_cigar_score_gap_lineal(
 int edit_cigar_score_gap_affine(
     edit_cigar_t* const edit_cigar,
     affine_penalties_t* const penalties);
+int edit_cigar_score_gap_affine2p(
+    edit_cigar_t* const edit_cigar,
+    affine2p_penalties_t* const penalties);
+int edit_cigar_stats_score_gap_affine(
+    edit_cigar_stats_t* const stats,
+    affine_penalties_t* const penalties);
 
 /*
  * Utils
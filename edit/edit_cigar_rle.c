@@ -0,0 +1,359 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Run-length encoded CIGAR (SAM/BAM packed operations)
+ */
+
+#include "edit/edit_cigar_rle.h"
+
+/*
+ * Setup
+ */
+void edit_cigar_rle_allocate(
+    edit_cigar_rle_t* const cigar_rle,
+    const int num_runs,
+    mm_allocator_t* const mm_allocator) {
+  cigar_rle->max_operations = MAX(num_runs,1);
+  cigar_rle->operations = mm_allocator_calloc(mm_allocator,cigar_rle->max_operations,uint32_t,false);
+  cigar_rle->begin_offset = cigar_rle->max_operations;
+  cigar_rle->end_offset = cigar_rle->max_operations;
+  cigar_rle->mm_allocator = mm_allocator;
+}
+void edit_cigar_rle_clear(
+    edit_cigar_rle_t* const cigar_rle) {
+  cigar_rle->begin_offset = cigar_rle->max_operations;
+  cigar_rle->end_offset = cigar_rle->max_operations;
+}
+void edit_cigar_rle_free(
+    edit_cigar_rle_t* const cigar_rle) {
+  mm_allocator_free(cigar_rle->mm_allocator,cigar_rle->operations);
+}
+/*
+ * Accessors
+ */
+int edit_cigar_rle_get_num_runs(
+    edit_cigar_rle_t* const cigar_rle) {
+  return cigar_rle->end_offset - cigar_rle->begin_offset;
+}
+uint32_t edit_cigar_rle_encode_operation(
+    const char operation) {
+  switch (operation) {
+    case 'M': return EDIT_CIGAR_RLE_OP_M;
+    case 'X': return EDIT_CIGAR_RLE_OP_X;
+    case 'I': return EDIT_CIGAR_RLE_OP_I;
+    case 'D': return EDIT_CIGAR_RLE_OP_D;
+    default:
+      fprintf(stderr,"RLE-CIGAR. Unknown edit operation '%c'\n",operation);
+      exit(1);
+  }
+}
+void edit_cigar_rle_grow(
+    edit_cigar_rle_t* const cigar_rle) {
+  // Allocate (twice as many runs)
+  const int num_runs = edit_cigar_rle_get_num_runs(cigar_rle);
+  const int max_operations = 2*cigar_rle->max_operations;
+  uint32_t* const operations = mm_allocator_calloc(cigar_rle->mm_allocator,max_operations,uint32_t,false);
+  // Copy runs (at the end)
+  memcpy(operations+(max_operations-num_runs),
+      cigar_rle->operations+cigar_rle->begin_offset,num_runs*sizeof(uint32_t));
+  mm_allocator_free(cigar_rle->mm_allocator,cigar_rle->operations);
+  cigar_rle->operations = operations;
+  cigar_rle->max_operations = max_operations;
+  cigar_rle->begin_offset = max_operations-num_runs;
+  cigar_rle->end_offset = max_operations;
+}
+void edit_cigar_rle_prepend(
+    edit_cigar_rle_t* const cigar_rle,
+    const char operation,
+    const int length) {
+  if (length <= 0) return;
+  const uint32_t op = edit_cigar_rle_encode_operation(operation);
+  // Extend first run
+  if (cigar_rle->begin_offset < cigar_rle->end_offset &&
+      EDIT_CIGAR_RLE_RUN_OP(cigar_rle->operations[cigar_rle->begin_offset]) == op) {
+    cigar_rle->operations[cigar_rle->begin_offset] += EDIT_CIGAR_RLE_RUN(0,length);
+    return;
+  }
+  // Add new run
+  if (cigar_rle->begin_offset == 0) edit_cigar_rle_grow(cigar_rle);
+  cigar_rle->operations[--(cigar_rle->begin_offset)] = EDIT_CIGAR_RLE_RUN(op,length);
+}
+void edit_cigar_rle_get_stats(
+    edit_cigar_rle_t* const cigar_rle,
+    edit_cigar_stats_t* const stats) {
+  // Init
+  memset(stats,0,sizeof(edit_cigar_stats_t));
+  // Count operations (one run per gap)
+  int i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    const int length = EDIT_CIGAR_RLE_RUN_LENGTH(run);
+    stats->num_operations += length;
+    switch (EDIT_CIGAR_RLE_RUN_OP(run)) {
+      case EDIT_CIGAR_RLE_OP_M: stats->matches += length; break;
+      case EDIT_CIGAR_RLE_OP_X: stats->mismatches += length; break;
+      case EDIT_CIGAR_RLE_OP_I: stats->insertions += length; ++(stats->insertion_opens); break;
+      case EDIT_CIGAR_RLE_OP_D: stats->deletions += length; ++(stats->deletion_opens); break;
+      default: break;
+    }
+  }
+}
+/*
+ * Conversion
+ */
+void edit_cigar_rle_compact(
+    edit_cigar_rle_t* const cigar_rle,
+    edit_cigar_t* const edit_cigar) {
+  // Traverse backwards (runs are prepended)
+  edit_cigar_rle_clear(cigar_rle);
+  int i = edit_cigar->end_offset-1;
+  while (i >= edit_cigar->begin_offset) {
+    const char operation = edit_cigar->operations[i];
+    int length = 0;
+    while (i >= edit_cigar->begin_offset && edit_cigar->operations[i] == operation) {
+      ++length; --i;
+    }
+    edit_cigar_rle_prepend(cigar_rle,operation,length);
+  }
+}
+void edit_cigar_rle_expand(
+    edit_cigar_rle_t* const cigar_rle,
+    edit_cigar_t* const edit_cigar) {
+  // Expand runs (at the beginning of the buffer)
+  int i, num_operations = 0;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    const int length = EDIT_CIGAR_RLE_RUN_LENGTH(run);
+    memset(edit_cigar->operations+num_operations,EDIT_CIGAR_RLE_RUN_CHAR(run),length);
+    num_operations += length;
+  }
+  edit_cigar->begin_offset = 0;
+  edit_cigar->end_offset = num_operations;
+}
+/*
+ * Score
+ */
+int edit_cigar_rle_score_edit(
+    edit_cigar_rle_t* const cigar_rle) {
+  int score = 0, i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    if (EDIT_CIGAR_RLE_RUN_OP(run) != EDIT_CIGAR_RLE_OP_M) {
+      score += EDIT_CIGAR_RLE_RUN_LENGTH(run);
+    }
+  }
+  return score;
+}
+int edit_cigar_rle_score_gap_lineal(
+    edit_cigar_rle_t* const cigar_rle,
+    lineal_penalties_t* const penalties) {
+  int score = 0, i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    const int length = EDIT_CIGAR_RLE_RUN_LENGTH(run);
+    switch (EDIT_CIGAR_RLE_RUN_OP(run)) {
+      case EDIT_CIGAR_RLE_OP_M: score -= length*penalties->match; break;
+      case EDIT_CIGAR_RLE_OP_X: score -= length*penalties->mismatch; break;
+      case EDIT_CIGAR_RLE_OP_I: score -= length*penalties->insertion; break;
+      case EDIT_CIGAR_RLE_OP_D: score -= length*penalties->deletion; break;
+      default: return INT_MIN;
+    }
+  }
+  return score;
+}
+int edit_cigar_rle_score_gap_affine(
+    edit_cigar_rle_t* const cigar_rle,
+    affine_penalties_t* const penalties) {
+  uint32_t last_op = UINT32_MAX;
+  int score = 0, i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    const uint32_t op = EDIT_CIGAR_RLE_RUN_OP(run);
+    const int length = EDIT_CIGAR_RLE_RUN_LENGTH(run);
+    switch (op) {
+      case EDIT_CIGAR_RLE_OP_M: score -= length*penalties->match; break;
+      case EDIT_CIGAR_RLE_OP_X: score -= length*penalties->mismatch; break;
+      case EDIT_CIGAR_RLE_OP_I:
+      case EDIT_CIGAR_RLE_OP_D:
+        score -= length*penalties->gap_extension + ((last_op==op) ? 0 : penalties->gap_opening);
+        break;
+      default:
+        fprintf(stderr,"Computing RLE-CIGAR score: Unknown operation\n");
+        exit(1);
+    }
+    last_op = op;
+  }
+  return score;
+}
+int edit_cigar_rle_score_gap_affine2p_run(
+    const uint32_t op,
+    const int length,
+    affine2p_penalties_t* const penalties) {
+  switch (op) {
+    case EDIT_CIGAR_RLE_OP_M: return length*penalties->match;
+    case EDIT_CIGAR_RLE_OP_X: return length*penalties->mismatch;
+    case EDIT_CIGAR_RLE_OP_I:
+    case EDIT_CIGAR_RLE_OP_D: {
+      const int score1 = penalties->gap_opening1 + penalties->gap_extension1*length;
+      const int score2 = penalties->gap_opening2 + penalties->gap_extension2*length;
+      return MIN(score1,score2);
+    }
+    default:
+      fprintf(stderr,"Computing RLE-CIGAR score: Unknown operation\n");
+      exit(1);
+  }
+}
+int edit_cigar_rle_score_gap_affine2p(
+    edit_cigar_rle_t* const cigar_rle,
+    affine2p_penalties_t* const penalties) {
+  uint32_t last_op = UINT32_MAX;
+  int score = 0, op_length = 0, i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    const uint32_t op = EDIT_CIGAR_RLE_RUN_OP(run);
+    // Account for operation runs (merging contiguous runs of the same operation)
+    if (op != last_op && last_op != UINT32_MAX) {
+      score -= edit_cigar_rle_score_gap_affine2p_run(last_op,op_length,penalties);
+      op_length = 0;
+    }
+    last_op = op;
+    op_length += EDIT_CIGAR_RLE_RUN_LENGTH(run);
+  }
+  // Account for last operation run
+  if (last_op != UINT32_MAX) {
+    score -= edit_cigar_rle_score_gap_affine2p_run(last_op,op_length,penalties);
+  }
+  return score;
+}
+/*
+ * Utils
+ */
+int edit_cigar_rle_cmp(
+    edit_cigar_rle_t* const cigar_rle_a,
+    edit_cigar_rle_t* const cigar_rle_b) {
+  // Compare number of runs (runs of the same operation are always merged)
+  const int num_runs_a = edit_cigar_rle_get_num_runs(cigar_rle_a);
+  const int num_runs_b = edit_cigar_rle_get_num_runs(cigar_rle_b);
+  if (num_runs_a != num_runs_b) return num_runs_a - num_runs_b;
+  // Compare runs
+  const uint32_t* const runs_a = cigar_rle_a->operations + cigar_rle_a->begin_offset;
+  const uint32_t* const runs_b = cigar_rle_b->operations + cigar_rle_b->begin_offset;
+  int i;
+  for (i=0;i<num_runs_a;++i) {
+    if (runs_a[i] != runs_b[i]) {
+      return (runs_a[i] < runs_b[i]) ? -1 : 1;
+    }
+  }
+  // Equal
+  return 0;
+}
+bool edit_cigar_rle_check_alignment(
+    FILE* const stream,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    edit_cigar_rle_t* const cigar_rle,
+    const bool verbose) {
+  // Traverse RLE-CIGAR
+  int pattern_pos=0, text_pos=0, i, j;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    const int length = EDIT_CIGAR_RLE_RUN_LENGTH(run);
+    switch (EDIT_CIGAR_RLE_RUN_OP(run)) {
+      case EDIT_CIGAR_RLE_OP_M:
+      case EDIT_CIGAR_RLE_OP_X: {
+        // Check bounds
+        if (pattern_pos+length > pattern_length || text_pos+length > text_length) {
+          if (verbose) fprintf(stream,"Align Check. Alignment exceeds sequences length\n");
+          return false;
+        }
+        // Check matches/mismatches
+        const bool match = (EDIT_CIGAR_RLE_RUN_OP(run) == EDIT_CIGAR_RLE_OP_M);
+        if (match && memcmp(pattern+pattern_pos,text+text_pos,length)==0) {
+          pattern_pos += length;
+          text_pos += length;
+          break;
+        }
+        for (j=0;j<length;++j,++pattern_pos,++text_pos) {
+          if ((pattern[pattern_pos] == text[text_pos]) != match) {
+            if (verbose) {
+              fprintf(stream,
+                  "Align Check. Alignment not %s (pattern[%d]=%c %s text[%d]=%c)\n",
+                  match ? "matching" : "mismatching",pattern_pos,pattern[pattern_pos],
+                  match ? "!=" : "==",text_pos,text[text_pos]);
+            }
+            return false;
+          }
+        }
+        break;
+      }
+      case EDIT_CIGAR_RLE_OP_I:
+        text_pos += length;
+        break;
+      case EDIT_CIGAR_RLE_OP_D:
+        pattern_pos += length;
+        break;
+      default:
+        fprintf(stderr,"RLE-CIGAR check. Unknown edit operation '%c'\n",EDIT_CIGAR_RLE_RUN_CHAR(run));
+        exit(1);
+        break;
+    }
+  }
+  // Check alignment length
+  if (pattern_pos != pattern_length) {
+    if (verbose) {
+      fprintf(stream,
+          "Align Check. Alignment incorrect length (pattern-aligned=%d,pattern-length=%d)\n",
+          pattern_pos,pattern_length);
+    }
+    return false;
+  }
+  if (text_pos != text_length) {
+    if (verbose) {
+      fprintf(stream,
+          "Align Check. Alignment incorrect length (text-aligned=%d,text-length=%d)\n",
+          text_pos,text_length);
+    }
+    return false;
+  }
+  // OK
+  return true;
+}
+/*
+ * Display
+ */
+void edit_cigar_rle_print(
+    FILE* const stream,
+    edit_cigar_rle_t* const cigar_rle) {
+  int i;
+  for (i=cigar_rle->begin_offset;i<cigar_rle->end_offset;++i) {
+    const uint32_t run = cigar_rle->operations[i];
+    fprintf(stream,"%u%c",EDIT_CIGAR_RLE_RUN_LENGTH(run),EDIT_CIGAR_RLE_RUN_CHAR(run));
+  }
+}
@@ -0,0 +1,141 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Run-length encoded CIGAR (SAM/BAM packed operations)
+ */
+
+#ifndef EDIT_CIGAR_RLE_H_
+#define EDIT_CIGAR_RLE_H_
+
+#include "utils/commons.h"
+#include "system/mm_allocator.h"
+#include "edit/edit_cigar.h"
+#include "gap_lineal/lineal_penalties.h"
+#include "gap_affine/affine_penalties.h"
+
+/*
+ * Packed operations (as in BAM: length<<4 | op)
+ *   'M' runs are matches (as in edit_cigar_t), mismatches are 'X'
+ */
+#define EDIT_CIGAR_RLE_OP_M  0
+#define EDIT_CIGAR_RLE_OP_I  1
+#define EDIT_CIGAR_RLE_OP_D  2
+#define EDIT_CIGAR_RLE_OP_X  8
+
+#define EDIT_CIGAR_RLE_OP_CHARS         "MIDNSHP=X"
+#define EDIT_CIGAR_RLE_RUN(op,length)   (((uint32_t)(length)<<4) | (uint32_t)(op))
+#define EDIT_CIGAR_RLE_RUN_OP(run)      ((run) & 0xF)
+#define EDIT_CIGAR_RLE_RUN_CHAR(run)    (EDIT_CIGAR_RLE_OP_CHARS[EDIT_CIGAR_RLE_RUN_OP(run)])
+#define EDIT_CIGAR_RLE_RUN_LENGTH(run)  ((run) >> 4)
+
+/*
+ * RLE-CIGAR
+ *   Runs are prepended (like the backtrace emits them); valid runs
+ *   are in [begin_offset,end_offset). Grows on demand.
+ */
+typedef struct {
+  uint32_t* operations;          // Packed runs
+  int max_operations;            // Allocated runs
+  int begin_offset;              // First run
+  int end_offset;                // Last run (exclusive)
+  mm_allocator_t* mm_allocator;  // MM
+} edit_cigar_rle_t;
+
+/*
+ * Setup
+ */
+void edit_cigar_rle_allocate(
+    edit_cigar_rle_t* const cigar_rle,
+    const int num_runs,
+    mm_allocator_t* const mm_allocator);
+void edit_cigar_rle_clear(
+    edit_cigar_rle_t* const cigar_rle);
+void edit_cigar_rle_free(
+    edit_cigar_rle_t* const cigar_rle);
+
+/*
+ * Accessors
+ */
+int edit_cigar_rle_get_num_runs(
+    edit_cigar_rle_t* const cigar_rle);
+void edit_cigar_rle_prepend(
+    edit_cigar_rle_t* const cigar_rle,
+    const char operation,
+    const int length);
+void edit_cigar_rle_get_stats(
+    edit_cigar_rle_t* const cigar_rle,
+    edit_cigar_stats_t* const stats);
+
+/*
+ * Conversion
+ */
+void edit_cigar_rle_compact(
+    edit_cigar_rle_t* const cigar_rle,
+    edit_cigar_t* const edit_cigar);
+void edit_cigar_rle_expand(
+    edit_cigar_rle_t* const cigar_rle,
+    edit_cigar_t* const edit_cigar);
+
+/*
+ * Score
+ */
+int edit_cigar_rle_score_edit(
+    edit_cigar_rle_t* const cigar_rle);
+int edit_cigar_rle_score_gap_lineal(
+    edit_cigar_rle_t* const cigar_rle,
+    lineal_penalties_t* const penalties);
+int edit_cigar_rle_score_gap_affine(
+    edit_cigar_rle_t* const cigar_rle,
+    affine_penalties_t* const penalties);
+int edit_cigar_rle_score_gap_affine2p(
+    edit_cigar_rle_t* const cigar_rle,
+    affine2p_penalties_t* const penalties);
+
+/*
+ * Utils
+ */
+int edit_cigar_rle_cmp(
+    edit_cigar_rle_t* const cigar_rle_a,
+    edit_cigar_rle_t* const cigar_rle_b);
+bool edit_cigar_rle_check_alignment(
+    FILE* const stream,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    edit_cigar_rle_t* const cigar_rle,
+    const bool verbose);
+
+/*
+ * Display
+ */
+void edit_cigar_rle_print(
+    FILE* const stream,
+    edit_cigar_rle_t* const cigar_rle);
+
+#endif /* EDIT_CIGAR_RLE_H_ */
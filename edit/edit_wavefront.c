@@ -0,0 +1,352 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Wavefront alignment algorithm for pairwise edit-distance
+ *   alignment (Levenshtein)
+ */
+
+#include "edit/edit_wavefront.h"
+#include "utils/string_padded.h"
+
+/*
+ * Setup
+ */
+edit_wavefronts_t* edit_wavefronts_new(
+    const int pattern_length,
+    const int text_length,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  edit_wavefronts_t* const edit_wavefronts = mm_allocator_alloc(mm_allocator,edit_wavefronts_t);
+  // Dimensions
+  edit_wavefronts->pattern_length = pattern_length;
+  edit_wavefronts->text_length = text_length;
+  edit_wavefronts->max_score = MAX(pattern_length,text_length);
+  // MM
+  edit_wavefronts->mm_allocator = mm_allocator;
+  // Wavefronts
+  edit_wavefronts->wavefronts = mm_allocator_calloc(
+      mm_allocator,edit_wavefronts->max_score+1,edit_wavefront_t,false);
+  edit_wavefronts->num_wavefronts = 0;
+  // CIGAR
+  edit_cigar_allocate(&edit_wavefronts->edit_cigar,pattern_length,text_length,mm_allocator);
+  // Return
+  return edit_wavefronts;
+}
+void edit_wavefronts_clear(
+    edit_wavefronts_t* const edit_wavefronts) {
+  // Free wavefronts (reverse order)
+  mm_allocator_t* const mm_allocator = edit_wavefronts->mm_allocator;
+  edit_wavefront_t* const wavefronts = edit_wavefronts->wavefronts;
+  int i;
+  for (i=edit_wavefronts->num_wavefronts-1;i>=0;--i) {
+    mm_allocator_free(mm_allocator,wavefronts[i].offsets+wavefronts[i].lo-2);
+  }
+  edit_wavefronts->num_wavefronts = 0;
+  // Clear CIGAR
+  edit_cigar_clear(&edit_wavefronts->edit_cigar);
+}
+void edit_wavefronts_delete(
+    edit_wavefronts_t* const edit_wavefronts) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = edit_wavefronts->mm_allocator;
+  // Clear wavefronts
+  edit_wavefronts_clear(edit_wavefronts);
+  // Free
+  edit_cigar_free(&edit_wavefronts->edit_cigar,mm_allocator);
+  mm_allocator_free(mm_allocator,edit_wavefronts->wavefronts);
+  mm_allocator_free(mm_allocator,edit_wavefronts);
+}
+/*
+ * Allocate wavefront (with 2 null-sentinels at each side)
+ */
+edit_wavefront_t* edit_wavefronts_allocate_wavefront(
+    edit_wavefronts_t* const edit_wavefronts,
+    const int score,
+    const int lo,
+    const int hi) {
+  // Allocate offsets
+  edit_wavefront_t* const wavefront = edit_wavefronts->wavefronts + score;
+  const int wavefront_length = hi - lo + 5;
+  ewf_offset_t* const offsets_mem = mm_allocator_calloc(
+      edit_wavefronts->mm_allocator,wavefront_length,ewf_offset_t,false);
+  wavefront->lo = lo;
+  wavefront->hi = hi;
+  wavefront->offsets = offsets_mem + 2 - lo; // Center at k=0
+  edit_wavefronts->num_wavefronts = score+1;
+  // Set sentinels
+  wavefront->offsets[lo-2] = EDIT_WAVEFRONT_OFFSET_NULL;
+  wavefront->offsets[lo-1] = EDIT_WAVEFRONT_OFFSET_NULL;
+  wavefront->offsets[hi+1] = EDIT_WAVEFRONT_OFFSET_NULL;
+  wavefront->offsets[hi+2] = EDIT_WAVEFRONT_OFFSET_NULL;
+  // Return
+  return wavefront;
+}
+/*
+ * Wavefront offset extension comparing characters
+ */
+void edit_wavefronts_extend_packed(
+    edit_wavefront_t* const wavefront,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Extend diagonally each wavefront point
+  ewf_offset_t* const offsets = wavefront->offsets;
+  int k;
+  for (k=wavefront->lo;k<=wavefront->hi;++k) {
+    // Fetch offset & positions
+    const ewf_offset_t offset = offsets[k];
+    const uint32_t h = EDIT_WAVEFRONT_H(k,offset); // Make unsigned to avoid checking negative
+    if (h >= text_length) continue;
+    const uint32_t v = EDIT_WAVEFRONT_V(k,offset); // Make unsigned to avoid checking negative
+    if (v >= pattern_length) continue;
+    // Fetch pattern/text blocks
+    uint64_t* pattern_blocks = (uint64_t*)(pattern+v);
+    uint64_t* text_blocks = (uint64_t*)(text+h);
+    uint64_t pattern_block = *pattern_blocks;
+    uint64_t text_block = *text_blocks;
+    // Compare 64-bits blocks
+    uint64_t cmp = pattern_block ^ text_block;
+    while (__builtin_expect(!cmp,0)) {
+      // Increment offset (full block)
+      offsets[k] += 8;
+      // Next blocks
+      ++pattern_blocks;
+      ++text_blocks;
+      // Fetch
+      pattern_block = *pattern_blocks;
+      text_block = *text_blocks;
+      // Compare
+      cmp = pattern_block ^ text_block;
+    }
+    // Count equal characters
+    const int equal_right_bits = __builtin_ctzl(cmp);
+    const int equal_chars = DIV_FLOOR(equal_right_bits,8);
+    // Increment offset
+    offsets[k] += equal_chars;
+  }
+}
+/*
+ * Compute wavefront offsets
+ */
+void edit_wavefronts_compute_offsets(
+    const ewf_offset_t* const prev_offsets,
+    ewf_offset_t* const curr_offsets,
+    const int lo,
+    const int hi,
+    const int pattern_length,
+    const int text_length) {
+  int k;
+#if defined(__clang__)
+  #pragma clang loop vectorize(enable)
+#elif defined(__GNUC__) || defined(__GNUG__)
+  #pragma GCC ivdep
+#else
+  #pragma ivdep
+#endif
+  for (k=lo;k<=hi;++k) {
+    // Compute maximum offset
+    const ewf_offset_t ins = prev_offsets[k-1] + 1;
+    const ewf_offset_t del = prev_offsets[k+1];
+    const ewf_offset_t sub = prev_offsets[k] + 1;
+    ewf_offset_t max = MAX(del,MAX(sub,ins));
+    // Nullify offsets out of the DP-table (they cannot reach the end)
+    const uint32_t h = EDIT_WAVEFRONT_H(k,max); // Make unsigned to avoid checking negative
+    const uint32_t v = EDIT_WAVEFRONT_V(k,max); // Make unsigned to avoid checking negative
+    if (h > text_length || v > pattern_length) max = EDIT_WAVEFRONT_OFFSET_NULL;
+    curr_offsets[k] = max;
+  }
+}
+/*
+ * Termination
+ */
+bool edit_wavefronts_end_reached(
+    edit_wavefront_t* const wavefront,
+    const int pattern_length,
+    const int text_length) {
+  const int alignment_k = EDIT_WAVEFRONT_DIAGONAL(text_length,pattern_length);
+  const int alignment_offset = EDIT_WAVEFRONT_OFFSET(text_length,pattern_length);
+  return (wavefront->lo <= alignment_k &&
+          alignment_k <= wavefront->hi &&
+          wavefront->offsets[alignment_k] >= alignment_offset);
+}
+/*
+ * Backtrace
+ */
+void edit_wavefronts_backtrace(
+    edit_wavefronts_t* const edit_wavefronts,
+    const int pattern_length,
+    const int text_length,
+    const int alignment_score) {
+  // Parameters
+  edit_wavefront_t* const wavefronts = edit_wavefronts->wavefronts;
+  edit_cigar_t* const edit_cigar = &edit_wavefronts->edit_cigar;
+  char* const operations = edit_cigar->operations;
+  int op_sentinel = edit_cigar->end_offset-1;
+  // Compute starting location
+  int score = alignment_score;
+  int k = EDIT_WAVEFRONT_DIAGONAL(text_length,pattern_length);
+  ewf_offset_t offset = wavefronts[score].offsets[k];
+  // Trace the alignment back
+  while (score > 0) {
+    // Compute source offsets (sentinels cover k-1 and k+1)
+    const ewf_offset_t* const prev_offsets = wavefronts[score-1].offsets;
+    const ewf_offset_t ins = prev_offsets[k-1] + 1;
+    const ewf_offset_t del = prev_offsets[k+1];
+    const ewf_offset_t sub = prev_offsets[k] + 1;
+    const ewf_offset_t max_all = MAX(del,MAX(sub,ins));
+    // Traceback Matches
+    while (offset > max_all) {
+      operations[op_sentinel--] = 'M';
+      --offset;
+    }
+    // Traceback Operation
+    if (max_all == sub) {
+      operations[op_sentinel--] = 'X';
+      --offset;
+    } else if (max_all == ins) {
+      operations[op_sentinel--] = 'I';
+      --offset;
+      --k;
+    } else if (max_all == del) {
+      operations[op_sentinel--] = 'D';
+      ++k;
+    } else {
+      fprintf(stderr,"Edit-WF backtrace. No backtrace operation found\n");
+      exit(1);
+    }
+    --score;
+  }
+  // Account for last stroke of matches
+  while (offset > 0) {
+    operations[op_sentinel--] = 'M';
+    --offset;
+  }
+  edit_cigar->begin_offset = op_sentinel+1;
+  edit_cigar->score = alignment_score;
+}
+/*
+ * Edit distance computation using wavefronts (full alignment)
+ */
+void edit_wavefronts_align(
+    edit_wavefronts_t* const edit_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Init padded strings (out-of-DP offsets are nullified; only end padding is needed)
+  strings_padded_t* const strings_padded =
+      strings_padded_new(
+          pattern,pattern_length,text,text_length,
+          EDIT_WAVEFRONT_PADDING,edit_wavefronts->mm_allocator);
+  const char* const pattern_padded = strings_padded->pattern_padded;
+  const char* const text_padded = strings_padded->text_padded;
+  // Initialize wavefront
+  edit_wavefront_t* wavefront = edit_wavefronts_allocate_wavefront(edit_wavefronts,0,0,0);
+  wavefront->offsets[0] = 0;
+  // Compute wavefronts for increasing score
+  int score = 0;
+  while (true) {
+    // Exact extend s-wavefront
+    edit_wavefronts_extend_packed(
+        wavefront,pattern_padded,pattern_length,text_padded,text_length);
+    // Exit condition
+    if (edit_wavefronts_end_reached(wavefront,pattern_length,text_length)) break;
+    // Compute (s+1)-wavefront
+    ++score;
+    const int lo = MAX(wavefront->lo-1,-pattern_length);
+    const int hi = MIN(wavefront->hi+1,text_length);
+    edit_wavefront_t* const next_wavefront =
+        edit_wavefronts_allocate_wavefront(edit_wavefronts,score,lo,hi);
+    edit_wavefronts_compute_offsets(
+        wavefront->offsets,next_wavefront->offsets,
+        lo,hi,pattern_length,text_length);
+    wavefront = next_wavefront;
+  }
+  // Backtrace
+  edit_wavefronts_backtrace(edit_wavefronts,pattern_length,text_length,score);
+  // Free
+  strings_padded_delete(strings_padded);
+}
+/*
+ * Edit distance computation using wavefronts (score-only; O(n+m) memory)
+ */
+int edit_wavefronts_align_score(
+    edit_wavefronts_t* const edit_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = edit_wavefronts->mm_allocator;
+  // Init padded strings
+  strings_padded_t* const strings_padded =
+      strings_padded_new(
+          pattern,pattern_length,text,text_length,
+          EDIT_WAVEFRONT_PADDING,mm_allocator);
+  const char* const pattern_padded = strings_padded->pattern_padded;
+  const char* const text_padded = strings_padded->text_padded;
+  // Allocate two full-length wavefronts (swapped every step)
+  const int wavefront_length = pattern_length + text_length + 5;
+  ewf_offset_t* const offsets_mem_a = mm_allocator_calloc(mm_allocator,wavefront_length,ewf_offset_t,false);
+  ewf_offset_t* const offsets_mem_b = mm_allocator_calloc(mm_allocator,wavefront_length,ewf_offset_t,false);
+  int i;
+  for (i=0;i<wavefront_length;++i) {
+    offsets_mem_a[i] = EDIT_WAVEFRONT_OFFSET_NULL;
+    offsets_mem_b[i] = EDIT_WAVEFRONT_OFFSET_NULL;
+  }
+  edit_wavefront_t wavefront_a = { .lo = 0, .hi = 0, .offsets = offsets_mem_a + pattern_length + 2 };
+  edit_wavefront_t wavefront_b = { .lo = 0, .hi = 0, .offsets = offsets_mem_b + pattern_length + 2 };
+  edit_wavefront_t* wavefront = &wavefront_a;
+  edit_wavefront_t* next_wavefront = &wavefront_b;
+  wavefront->offsets[0] = 0;
+  // Compute wavefronts for increasing score
+  int score = 0;
+  while (true) {
+    // Exact extend s-wavefront
+    edit_wavefronts_extend_packed(
+        wavefront,pattern_padded,pattern_length,text_padded,text_length);
+    // Exit condition
+    if (edit_wavefronts_end_reached(wavefront,pattern_length,text_length)) break;
+    // Compute (s+1)-wavefront
+    ++score;
+    next_wavefront->lo = MAX(wavefront->lo-1,-pattern_length);
+    next_wavefront->hi = MIN(wavefront->hi+1,text_length);
+    edit_wavefronts_compute_offsets(
+        wavefront->offsets,next_wavefront->offsets,
+        next_wavefront->lo,next_wavefront->hi,
+        pattern_length,text_length);
+    SWAP(wavefront,next_wavefront);
+  }
+  // Free
+  mm_allocator_free(mm_allocator,offsets_mem_b);
+  mm_allocator_free(mm_allocator,offsets_mem_a);
+  strings_padded_delete(strings_padded);
+  // Return
+  return score;
+}
@@ -0,0 +1,117 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Wavefront alignment algorithm for pairwise edit-distance
+ *   alignment (Levenshtein)
+ */
+
+#ifndef EDIT_WAVEFRONT_H_
+#define EDIT_WAVEFRONT_H_
+
+#include "utils/commons.h"
+#include "system/mm_allocator.h"
+#include "edit/edit_cigar.h"
+
+/*
+ * Constants
+ */
+#define EDIT_WAVEFRONT_OFFSET_NULL (INT32_MIN/2)
+#define EDIT_WAVEFRONT_PADDING     10
+
+/*
+ * Translate k and offset to coordinates h,v
+ */
+#define EDIT_WAVEFRONT_V(k,offset) ((offset)-(k))
+#define EDIT_WAVEFRONT_H(k,offset) (offset)
+
+#define EDIT_WAVEFRONT_DIAGONAL(h,v) ((h)-(v))
+#define EDIT_WAVEFRONT_OFFSET(h,v)   (h)
+
+/*
+ * Offset size
+ */
+typedef int32_t ewf_offset_t;
+
+/*
+ * Wavefront
+ */
+typedef struct {
+  int lo;                     // Lowest diagonal (inclusive)
+  int hi;                     // Highest diagonal (inclusive)
+  ewf_offset_t* offsets;      // Offsets (centered at k=0)
+} edit_wavefront_t;
+
+/*
+ * Edit Wavefronts
+ */
+typedef struct {
+  // Dimensions
+  int pattern_length;                // Pattern length
+  int text_length;                   // Text length
+  int max_score;                     // Maximum edit-distance (MAX(pattern_length,text_length))
+  // Wavefronts
+  edit_wavefront_t* wavefronts;      // Wavefronts (indexed by score)
+  int num_wavefronts;                // Total wavefronts computed
+  // CIGAR
+  edit_cigar_t edit_cigar;           // Alignment CIGAR
+  // MM
+  mm_allocator_t* mm_allocator;      // MM-Allocator
+} edit_wavefronts_t;
+
+/*
+ * Setup
+ */
+edit_wavefronts_t* edit_wavefronts_new(
+    const int pattern_length,
+    const int text_length,
+    mm_allocator_t* const mm_allocator);
+void edit_wavefronts_clear(
+    edit_wavefronts_t* const edit_wavefronts);
+void edit_wavefronts_delete(
+    edit_wavefronts_t* const edit_wavefronts);
+
+/*
+ * Edit distance computation using wavefronts (full alignment)
+ */
+void edit_wavefronts_align(
+    edit_wavefronts_t* const edit_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+/*
+ * Edit distance computation using wavefronts (score-only; O(n+m) memory)
+ */
+int edit_wavefronts_align_score(
+    edit_wavefronts_t* const edit_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+
+#endif /* EDIT_WAVEFRONT_H_ */
@@ -41,4 +41,15 @@ typedef struct {
   int gap_extension;      // (Penalty representation; usually E > 0)
 } affine_penalties_t;
 
+typedef struct {
+  int match;              // (Penalty representation; usually M <= 0)
+  int mismatch;           // (Penalty representation; usually X > 0)
+  // Short gaps
+  int gap_opening1;       // (Penalty representation; usually O1 > 0)
+  int gap_extension1;     // (Penalty representation; usually E1 > 0)
+  // Long gaps
+  int gap_opening2;       // (Penalty representation; usually O2 > O1)
+  int gap_extension2;     // (Penalty representation; usually 0 < E2 < E1)
+} affine2p_penalties_t;
+
 #endif /* AFFINE_PENALTIES_H_ */
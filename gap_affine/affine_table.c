@@ -64,6 +64,38 @@ void affine_table_free(
   // CIGAR
   edit_cigar_free(&table->edit_cigar,mm_allocator);
 }
+/*
+ * Two-piece Gap-Affine Table Setup
+ */
+void affine2p_table_allocate(
+    affine2p_table_t* const table,
+    const int pattern_length,
+    const int text_length,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate DP table
+  int h;
+  table->num_rows = pattern_length+1;
+  const int num_columns = text_length+1;
+  table->num_columns = num_columns;
+  table->columns = mm_allocator_malloc(mm_allocator,(text_length+1)*sizeof(affine2p_cell_t*)); // Columns
+  for (h=0;h<num_columns;++h) {
+    table->columns[h] = mm_allocator_calloc(mm_allocator,pattern_length+1,affine2p_cell_t,false); // Rows
+  }
+  // CIGAR
+  edit_cigar_allocate(&table->edit_cigar,pattern_length,text_length,mm_allocator);
+}
+void affine2p_table_free(
+    affine2p_table_t* const table,
+    mm_allocator_t* const mm_allocator) {
+  const int num_columns = table->num_columns;
+  int h;
+  for (h=0;h<num_columns;++h) {
+    mm_allocator_free(mm_allocator,table->columns[h]);
+  }
+  mm_allocator_free(mm_allocator,table->columns);
+  // CIGAR
+  edit_cigar_free(&table->edit_cigar,mm_allocator);
+}
 /*
  * Display
  */
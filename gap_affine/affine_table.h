@@ -48,6 +48,21 @@ typedef struct {
   // CIGAR
   edit_cigar_t edit_cigar;
 } affine_table_t;
+typedef struct {
+  int M;  // Alignment matching/mismatching
+  int I1; // Alignment ends with a short gap in the reference (insertion)
+  int D1; // Alignment ends with a short gap in the read (deletion)
+  int I2; // Alignment ends with a long gap in the reference (insertion)
+  int D2; // Alignment ends with a long gap in the read (deletion)
+} affine2p_cell_t;
+typedef struct {
+  // DP Table
+  affine2p_cell_t** columns;
+  int num_rows;
+  int num_columns;
+  // CIGAR
+  edit_cigar_t edit_cigar;
+} affine2p_table_t;
 
 /*
  * Gap-Affine Table Setup
@@ -61,6 +76,18 @@ void affine_table_free(
     affine_table_t* const table,
     mm_allocator_t* const mm_allocator);
 
+/*
+ * Two-piece Gap-Affine Table Setup
+ */
+void affine2p_table_allocate(
+    affine2p_table_t* const table,
+    const int pattern_length,
+    const int text_length,
+    mm_allocator_t* const mm_allocator);
+void affine2p_table_free(
+    affine2p_table_t* const table,
+    mm_allocator_t* const mm_allocator);
+
 /*
  * Display
  */
@@ -35,141 +35,316 @@
 #include "gap_affine/affine_wavefront_utils.h"
 #include "gap_affine/affine_penalties.h"
 
+/*
+ * Shared null wavefront
+ *   Process-wide buffer of null offsets centered at k=0, grown on demand
+ *   and never written once filled, so all aligners (and threads) share it.
+ *   Buffers being replaced are kept alive, as other aligners might still
+ *   point to them (geometric growth bounds the total to twice the largest).
+ *   Each buffer starts with a link to the one it replaced, so all of them
+ *   stay reachable (and leak checkers do not report them).
+ */
+static void* affine_wavefronts_null_mem = NULL;             // Current buffer (linked to the retired ones)
+static awf_offset_t* affine_wavefronts_null_offsets = NULL; // Centered at k=0
+static int affine_wavefronts_null_radius = -1;              // Covering diagonals [-radius,radius]
+static bool affine_wavefronts_null_lock = false;
+awf_offset_t* affine_wavefronts_get_null_offsets(
+    const int min_radius,
+    int* const radius) {
+  // Lock
+  while (__atomic_test_and_set(&affine_wavefronts_null_lock,__ATOMIC_ACQUIRE));
+  // Grow (if needed)
+  if (min_radius > affine_wavefronts_null_radius) {
+    const int null_radius = MAX(min_radius,2*affine_wavefronts_null_radius);
+    const int wavefront_length = 2*null_radius + 1;
+    void** const null_mem = malloc(sizeof(void*)+wavefront_length*sizeof(awf_offset_t));
+    if (null_mem == NULL) {
+      fprintf(stderr,"Could not allocate null wavefront (%d offsets)\n",wavefront_length);
+      exit(1);
+    }
+    *null_mem = affine_wavefronts_null_mem; // Link the retired buffer
+    affine_wavefronts_null_mem = null_mem;
+    awf_offset_t* const offsets_null = (awf_offset_t*)(null_mem+1);
+    int i;
+    for (i=0;i<wavefront_length;++i) {
+      offsets_null[i] = AFFINE_WAVEFRONT_OFFSET_NULL;
+    }
+    affine_wavefronts_null_offsets = offsets_null + null_radius; // Center at k=0
+    affine_wavefronts_null_radius = null_radius;
+  }
+  awf_offset_t* const offsets = affine_wavefronts_null_offsets;
+  *radius = affine_wavefronts_null_radius;
+  // Unlock
+  __atomic_clear(&affine_wavefronts_null_lock,__ATOMIC_RELEASE);
+  return offsets;
+}
 /*
  * Setup
  */
 void affine_wavefronts_allocate_wavefront_null(
     affine_wavefronts_t* const affine_wavefronts) {
-  // Allocate null wavefront
-  const int wavefront_length = affine_wavefronts->pattern_length + affine_wavefronts->text_length + 1;
-  awf_offset_t* const offsets_null = mm_allocator_calloc(
-      affine_wavefronts->mm_allocator,wavefront_length,awf_offset_t,false);
+  // Fetch null offsets (covering diagonals [-pattern_length-1,text_length+1])
+  const int min_radius = MAX(affine_wavefronts->pattern_length,affine_wavefronts->text_length) + 1;
   // Initialize
   affine_wavefronts->wavefront_null.null = true;
   affine_wavefronts->wavefront_null.lo =  1;
   affine_wavefronts->wavefront_null.hi = -1;
   affine_wavefronts->wavefront_null.lo_base =  1;
   affine_wavefronts->wavefront_null.hi_base = -1;
-  affine_wavefronts->wavefront_null.offsets = offsets_null + affine_wavefronts->pattern_length; // Center at k=0
-  int i;
-  for (i=0;i<wavefront_length;++i) {
-    offsets_null[i] = AFFINE_WAVEFRONT_OFFSET_NULL;
-  }
+  affine_wavefronts->wavefront_null.offsets =
+      affine_wavefronts_get_null_offsets(min_radius,&affine_wavefronts->wavefront_null_radius);
 }
 void affine_wavefronts_allocate_wavefront_components(
     affine_wavefronts_t* const affine_wavefronts) {
   // Parameters
   mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
+  const int num_wavefronts = affine_wavefronts->num_wavefronts_allocated;
   // Initialize wavefronts
   affine_wavefronts->mwavefronts =
-      mm_allocator_calloc(mm_allocator,affine_wavefronts->num_wavefronts,affine_wavefront_t*,true);
+      mm_allocator_calloc(mm_allocator,num_wavefronts,affine_wavefront_t*,true);
   affine_wavefronts->iwavefronts =
-      mm_allocator_calloc(mm_allocator,affine_wavefronts->num_wavefronts,affine_wavefront_t*,true);
+      mm_allocator_calloc(mm_allocator,num_wavefronts,affine_wavefront_t*,true);
   affine_wavefronts->dwavefronts =
-      mm_allocator_calloc(mm_allocator,affine_wavefronts->num_wavefronts,affine_wavefront_t*,true);
+      mm_allocator_calloc(mm_allocator,num_wavefronts,affine_wavefront_t*,true);
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    affine_wavefronts->i2wavefronts =
+        mm_allocator_calloc(mm_allocator,num_wavefronts,affine_wavefront_t*,true);
+    affine_wavefronts->d2wavefronts =
+        mm_allocator_calloc(mm_allocator,num_wavefronts,affine_wavefront_t*,true);
+  } else {
+    affine_wavefronts->i2wavefronts = NULL;
+    affine_wavefronts->d2wavefronts = NULL;
+  }
   // Allocate bulk-memory (for all wavefronts)
-  const int num_wavefronts = affine_wavefronts->num_wavefronts;
+  const int num_components = (affine_wavefronts->penalties.gap_affine_2p) ? 5 : 3;
   affine_wavefront_t* const wavefronts_mem =
-      mm_allocator_calloc(mm_allocator,3*num_wavefronts,affine_wavefront_t,false);
+      mm_allocator_calloc(mm_allocator,num_components*num_wavefronts,affine_wavefront_t,false);
   affine_wavefronts->wavefronts_mem = wavefronts_mem;
   affine_wavefronts->wavefronts_current = wavefronts_mem;
 }
+void affine_wavefronts_grow_wavefront_array(
+    affine_wavefronts_t* const affine_wavefronts,
+    affine_wavefront_t*** const wavefronts,
+    const int num_wavefronts,
+    affine_wavefront_t* const wavefronts_mem) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
+  affine_wavefront_t** const old_wavefronts = *wavefronts;
+  const int old_num_wavefronts = affine_wavefronts->num_wavefronts_allocated;
+  // Allocate & copy (re-basing wavefronts into the new slab)
+  affine_wavefront_t** const new_wavefronts =
+      mm_allocator_calloc(mm_allocator,num_wavefronts,affine_wavefront_t*,true);
+  int i;
+  for (i=0;i<old_num_wavefronts;++i) {
+    if (old_wavefronts[i]!=NULL) {
+      new_wavefronts[i] = wavefronts_mem + (old_wavefronts[i]-affine_wavefronts->wavefronts_mem);
+    }
+  }
+  mm_allocator_free(mm_allocator,old_wavefronts);
+  *wavefronts = new_wavefronts;
+}
+void affine_wavefronts_grow_wavefront_components(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int min_num_wavefronts) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
+  const bool gap_affine_2p = affine_wavefronts->penalties.gap_affine_2p;
+  // Compute new dimensions (geometric growth)
+  const int num_wavefronts = MAX(2*affine_wavefronts->num_wavefronts_allocated,min_num_wavefronts);
+  // Allocate bulk-memory & copy used wavefronts
+  const int num_components = (gap_affine_2p) ? 5 : 3;
+  const int num_used = affine_wavefronts->wavefronts_current - affine_wavefronts->wavefronts_mem;
+  affine_wavefront_t* const wavefronts_mem =
+      mm_allocator_calloc(mm_allocator,num_components*num_wavefronts,affine_wavefront_t,false);
+  memcpy(wavefronts_mem,affine_wavefronts->wavefronts_mem,num_used*sizeof(affine_wavefront_t));
+  // Grow score-indexed wavefronts
+  affine_wavefronts_grow_wavefront_array(affine_wavefronts,&affine_wavefronts->mwavefronts,num_wavefronts,wavefronts_mem);
+  affine_wavefronts_grow_wavefront_array(affine_wavefronts,&affine_wavefronts->iwavefronts,num_wavefronts,wavefronts_mem);
+  affine_wavefronts_grow_wavefront_array(affine_wavefronts,&affine_wavefronts->dwavefronts,num_wavefronts,wavefronts_mem);
+  if (gap_affine_2p) {
+    affine_wavefronts_grow_wavefront_array(affine_wavefronts,&affine_wavefronts->i2wavefronts,num_wavefronts,wavefronts_mem);
+    affine_wavefronts_grow_wavefront_array(affine_wavefronts,&affine_wavefronts->d2wavefronts,num_wavefronts,wavefronts_mem);
+  }
+  // Replace bulk-memory
+  mm_allocator_free(mm_allocator,affine_wavefronts->wavefronts_mem);
+  affine_wavefronts->wavefronts_mem = wavefronts_mem;
+  affine_wavefronts->wavefronts_current = wavefronts_mem + num_used;
+  affine_wavefronts->num_wavefronts_allocated = num_wavefronts;
+}
+void affine_wavefronts_free_wavefront_components(
+    affine_wavefronts_t* const affine_wavefronts) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
+  // Free MID-Wavefronts
+  mm_allocator_free(mm_allocator,affine_wavefronts->mwavefronts);
+  mm_allocator_free(mm_allocator,affine_wavefronts->iwavefronts);
+  mm_allocator_free(mm_allocator,affine_wavefronts->dwavefronts);
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    mm_allocator_free(mm_allocator,affine_wavefronts->i2wavefronts);
+    mm_allocator_free(mm_allocator,affine_wavefronts->d2wavefronts);
+  }
+  // Free bulk memory
+  mm_allocator_free(mm_allocator,affine_wavefronts->wavefronts_mem);
+}
+#ifdef AFFINE_WAVEFRONT_DEBUG
+void affine_wavefronts_allocate_debug_table(
+    affine_wavefronts_t* const affine_wavefronts) {
+  // Parameters
+  const int pattern_length = affine_wavefronts->pattern_length;
+  const int text_length = affine_wavefronts->text_length;
+  // Allocate & initialize
+  affine_table_allocate(&affine_wavefronts->gap_affine_table,
+      pattern_length,text_length,affine_wavefronts->mm_allocator);
+  int h, v;
+  for (h=0;h<=text_length;++h) {
+    for (v=0;v<=pattern_length;++v) {
+      affine_wavefronts->gap_affine_table.columns[h][v].M = -1;
+      affine_wavefronts->gap_affine_table.columns[h][v].D = -1;
+      affine_wavefronts->gap_affine_table.columns[h][v].I = -1;
+    }
+  }
+}
+#endif
+void affine_wavefronts_set_dimensions(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int pattern_length,
+    const int text_length) {
+  // Parameters
+  const affine_penalties_t* const base_penalties = &affine_wavefronts->penalties.base_penalties;
+  const affine2p_penalties_t* const base_penalties_2p = &affine_wavefronts->penalties.base_penalties_2p;
+  // Dimensions
+  const int max_score_misms = MIN(pattern_length,text_length) * base_penalties->mismatch;
+  int max_score_indel = base_penalties->gap_opening + ABS(pattern_length-text_length) * base_penalties->gap_extension;
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    const int max_score_indel2 = base_penalties_2p->gap_opening2 + ABS(pattern_length-text_length) * base_penalties_2p->gap_extension2;
+    max_score_indel = MIN(max_score_indel,max_score_indel2);
+  }
+  const int num_wavefronts = max_score_misms + max_score_indel + 1; // (+1) for the score bound itself
+  affine_wavefronts->pattern_length = pattern_length;
+  affine_wavefronts->text_length = text_length;
+  affine_wavefronts->num_wavefronts = num_wavefronts;
+  // Limits
+  affine_wavefronts->max_k = text_length;
+  affine_wavefronts->min_k = -pattern_length;
+}
 affine_wavefronts_t* affine_wavefronts_new(
     const int pattern_length,
     const int text_length,
     affine_penalties_t* const penalties,
+    affine2p_penalties_t* const penalties_2p,
     const wavefronts_penalties_strategy penalties_strategy,
     mm_allocator_t* const mm_allocator) {
   // Allocate
   affine_wavefronts_t* const affine_wavefronts = mm_allocator_alloc(mm_allocator,affine_wavefronts_t);
+  // Penalties (single-piece or two-piece gap-affine)
+  if (penalties_2p != NULL) {
+    affine_wavefronts_penalties_init_2p(&affine_wavefronts->penalties,penalties_2p,penalties_strategy);
+  } else {
+    affine_wavefronts_penalties_init(&affine_wavefronts->penalties,penalties,penalties_strategy);
+  }
+  const affine_penalties_t* const base_penalties = &affine_wavefronts->penalties.base_penalties;
   // Dimensions
-  const int max_score_misms = MIN(pattern_length,text_length) * penalties->mismatch;
-  const int max_score_indel = penalties->gap_opening + ABS(pattern_length-text_length) * penalties->gap_extension;
-  const int num_wavefronts = max_score_misms + max_score_indel;
-  affine_wavefronts->pattern_length = pattern_length;
-  affine_wavefronts->text_length = text_length;
-  affine_wavefronts->num_wavefronts = num_wavefronts;
+  affine_wavefronts_set_dimensions(affine_wavefronts,pattern_length,text_length);
+  affine_wavefronts->num_wavefronts_allocated =
+      MIN(affine_wavefronts->num_wavefronts,AFFINE_WAVEFRONT_INIT_NUM_WAVEFRONTS);
   // MM
   affine_wavefronts->mm_allocator = mm_allocator;
   // Limits
-  const int single_gap_penalty = penalties->gap_opening + penalties->gap_extension;
-  const int max_penalty = MAX(penalties->mismatch,single_gap_penalty);
+  const int single_gap_penalty = base_penalties->gap_opening + base_penalties->gap_extension;
+  int max_penalty = MAX(base_penalties->mismatch,single_gap_penalty);
+  if (penalties_2p != NULL) {
+    max_penalty = MAX(max_penalty,penalties_2p->gap_opening2+penalties_2p->gap_extension2);
+  }
   affine_wavefronts->max_penalty = max_penalty;
-  // Penalties
-  affine_wavefronts_penalties_init(&affine_wavefronts->penalties,penalties,penalties_strategy);
+  // Extension (exact matching)
+  affine_wavefronts->match.case_insensitive = false;
+  affine_wavefronts->match.n = wavefronts_match_n_exact;
+  // Input (padded copies)
+  affine_wavefronts->zero_copy = false;
+  affine_wavefronts->zero_copy_slack = 0;
+  // Memory budget (no retry)
+  affine_wavefronts_reduction_set_none(&affine_wavefronts->budget_reduction);
   // Allocate wavefronts
   affine_wavefronts_allocate_wavefront_components(affine_wavefronts);
   affine_wavefronts_allocate_wavefront_null(affine_wavefronts);
+  wavefront_slab_init(&affine_wavefronts->offsets_slab,WAVEFRONT_SLAB_INITIAL_SIZE,mm_allocator);
   // CIGAR
   edit_cigar_allocate(&affine_wavefronts->edit_cigar,pattern_length,text_length,mm_allocator);
+  affine_wavefronts->cigar_rle = false;
+  edit_cigar_rle_allocate(&affine_wavefronts->edit_cigar_rle,AFFINE_WAVEFRONT_INIT_CIGAR_RUNS,mm_allocator);
   // STATS
   affine_wavefronts->wavefronts_stats = NULL;
   // DEBUG
 #ifdef AFFINE_WAVEFRONT_DEBUG
-  affine_table_allocate(&affine_wavefronts->gap_affine_table,pattern_length,text_length,mm_allocator);
-  int h, v;
-  for (h=0;h<=text_length;++h) {
-    for (v=0;v<=pattern_length;++v) {
-      affine_wavefronts->gap_affine_table.columns[h][v].M = -1;
-      affine_wavefronts->gap_affine_table.columns[h][v].D = -1;
-      affine_wavefronts->gap_affine_table.columns[h][v].I = -1;
-    }
-  }
+  affine_wavefronts_allocate_debug_table(affine_wavefronts);
 #endif
   // Return
   return affine_wavefronts;
 }
-void affine_wavefronts_clear(
-    affine_wavefronts_t* const affine_wavefronts) {
-  // Clear wavefronts
+void affine_wavefronts_resize(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int pattern_length,
+    const int text_length) {
+  // Parameters
   mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
-  affine_wavefront_t** const mwavefronts = affine_wavefronts->mwavefronts;
-  affine_wavefront_t** const iwavefronts = affine_wavefronts->iwavefronts;
-  affine_wavefront_t** const dwavefronts = affine_wavefronts->dwavefronts;
-  int i;
-  for (i=0;i<affine_wavefronts->num_wavefronts;++i) {
-    if (mwavefronts[i]!=NULL) {
-      mm_allocator_free(mm_allocator,mwavefronts[i]->offsets + mwavefronts[i]->lo_base);
-#ifdef AFFINE_WAVEFRONT_DEBUG
-      mm_allocator_free(mm_allocator,mwavefronts[i]->offsets_base + mwavefronts[i]->lo_base);
-#endif
-      mwavefronts[i] = NULL;
-    }
-    if (iwavefronts[i]!=NULL) {
-      mm_allocator_free(mm_allocator,iwavefronts[i]->offsets + iwavefronts[i]->lo_base);
-#ifdef AFFINE_WAVEFRONT_DEBUG
-      mm_allocator_free(mm_allocator,iwavefronts[i]->offsets_base + iwavefronts[i]->lo_base);
-#endif
-      iwavefronts[i] = NULL;
-    }
-    if (dwavefronts[i]!=NULL) {
-      mm_allocator_free(mm_allocator,dwavefronts[i]->offsets + dwavefronts[i]->lo_base);
+  // Clear previous alignment
+  affine_wavefronts_clear(affine_wavefronts);
+  // Dimensions
+  affine_wavefronts_set_dimensions(affine_wavefronts,pattern_length,text_length);
+  // Fetch a larger null wavefront (only if needed)
+  if (MAX(pattern_length,text_length)+1 > affine_wavefronts->wavefront_null_radius) {
+    affine_wavefronts_allocate_wavefront_null(affine_wavefronts);
+  }
+  // Grow CIGAR (only if needed)
+  if (pattern_length+text_length > affine_wavefronts->edit_cigar.max_operations) {
+    edit_cigar_free(&affine_wavefronts->edit_cigar,mm_allocator);
+    edit_cigar_allocate(&affine_wavefronts->edit_cigar,pattern_length,text_length,mm_allocator);
+  }
+  // DEBUG
 #ifdef AFFINE_WAVEFRONT_DEBUG
-      mm_allocator_free(mm_allocator,dwavefronts[i]->offsets_base + dwavefronts[i]->lo_base);
+  affine_table_free(&affine_wavefronts->gap_affine_table,mm_allocator);
+  affine_wavefronts_allocate_debug_table(affine_wavefronts);
 #endif
-      dwavefronts[i] = NULL;
-    }
+}
+void affine_wavefronts_clear_wavefronts(
+    affine_wavefronts_t* const affine_wavefronts) {
+  // Clear wavefronts
+  const int num_wavefronts = affine_wavefronts->num_wavefronts_allocated;
+  memset(affine_wavefronts->mwavefronts,0,num_wavefronts*sizeof(affine_wavefront_t*));
+  memset(affine_wavefronts->iwavefronts,0,num_wavefronts*sizeof(affine_wavefront_t*));
+  memset(affine_wavefronts->dwavefronts,0,num_wavefronts*sizeof(affine_wavefront_t*));
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    memset(affine_wavefronts->i2wavefronts,0,num_wavefronts*sizeof(affine_wavefront_t*));
+    memset(affine_wavefronts->d2wavefronts,0,num_wavefronts*sizeof(affine_wavefront_t*));
   }
   // Clear CIGAR
   edit_cigar_clear(&affine_wavefronts->edit_cigar);
-  // Clear bulk memory
+  edit_cigar_rle_clear(&affine_wavefronts->edit_cigar_rle);
+  // Clear wavefronts slab
   affine_wavefronts->wavefronts_current = affine_wavefronts->wavefronts_mem;
 }
+void affine_wavefronts_clear(
+    affine_wavefronts_t* const affine_wavefronts) {
+  affine_wavefronts_clear_wavefronts(affine_wavefronts);
+  wavefront_slab_clear(&affine_wavefronts->offsets_slab); // Keep the offsets memory
+}
+void affine_wavefronts_reap(
+    affine_wavefronts_t* const affine_wavefronts) {
+  affine_wavefronts_clear_wavefronts(affine_wavefronts);
+  wavefront_slab_reap(&affine_wavefronts->offsets_slab); // Release the offsets memory
+}
 void affine_wavefronts_delete(
     affine_wavefronts_t* const affine_wavefronts) {
   // Parameters
   mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
   // Clear wavefronts
   affine_wavefronts_clear(affine_wavefronts);
-  // Free MID-Wavefronts
-  mm_allocator_free(mm_allocator,affine_wavefronts->mwavefronts);
-  mm_allocator_free(mm_allocator,affine_wavefronts->iwavefronts);
-  mm_allocator_free(mm_allocator,affine_wavefronts->dwavefronts);
-  mm_allocator_free(mm_allocator,affine_wavefronts->wavefront_null.offsets - affine_wavefronts->pattern_length);
-  // Free bulk memory
-  mm_allocator_free(mm_allocator,affine_wavefronts->wavefronts_mem);
+  // Free wavefronts
+  affine_wavefronts_free_wavefront_components(affine_wavefronts);
+  wavefront_slab_free(&affine_wavefronts->offsets_slab);
   // CIGAR
   edit_cigar_free(&affine_wavefronts->edit_cigar,mm_allocator);
+  edit_cigar_rle_free(&affine_wavefronts->edit_cigar_rle);
   // DEBUG
 #ifdef AFFINE_WAVEFRONT_DEBUG
   affine_table_free(&affine_wavefronts->gap_affine_table,mm_allocator);
@@ -189,11 +364,8 @@ affine_wavefronts_t* affine_wavefronts_new_complete(
   // Create new
   affine_wavefronts_t* const affine_wavefronts =
       affine_wavefronts_new(
-          pattern_length,text_length,
-          penalties,wavefronts_penalties_force_zero_match,mm_allocator);
-  // Limits
-  affine_wavefronts->max_k = text_length;
-  affine_wavefronts->min_k = -pattern_length;
+          pattern_length,text_length,penalties,NULL,
+          wavefronts_penalties_force_zero_match,mm_allocator);
   // Reduction
   affine_wavefronts_reduction_set_none(&affine_wavefronts->reduction);
   // Stats
@@ -212,11 +384,47 @@ affine_wavefronts_t* affine_wavefronts_new_reduced(
   // Create new
   affine_wavefronts_t* const affine_wavefronts =
       affine_wavefronts_new(
-          pattern_length,text_length,
-          penalties,wavefronts_penalties_force_zero_match,mm_allocator);
-  // Limits
-  affine_wavefronts->max_k = text_length;
-  affine_wavefronts->min_k = -pattern_length;
+          pattern_length,text_length,penalties,NULL,
+          wavefronts_penalties_force_zero_match,mm_allocator);
+  // Reduction
+  affine_wavefronts_reduction_set_dynamic(
+      &affine_wavefronts->reduction,min_wavefront_length,max_distance_threshold);
+  // Stats
+  affine_wavefronts->wavefronts_stats = wavefronts_stats;
+  // Return
+  return affine_wavefronts;
+}
+affine_wavefronts_t* affine_wavefronts_new_complete_2p(
+    const int pattern_length,
+    const int text_length,
+    affine2p_penalties_t* const penalties,
+    wavefronts_stats_t* const wavefronts_stats,
+    mm_allocator_t* const mm_allocator) {
+  // Create new
+  affine_wavefronts_t* const affine_wavefronts =
+      affine_wavefronts_new(
+          pattern_length,text_length,NULL,penalties,
+          wavefronts_penalties_force_zero_match,mm_allocator);
+  // Reduction
+  affine_wavefronts_reduction_set_none(&affine_wavefronts->reduction);
+  // Stats
+  affine_wavefronts->wavefronts_stats = wavefronts_stats;
+  // Return
+  return affine_wavefronts;
+}
+affine_wavefronts_t* affine_wavefronts_new_reduced_2p(
+    const int pattern_length,
+    const int text_length,
+    affine2p_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold,
+    wavefronts_stats_t* const wavefronts_stats,
+    mm_allocator_t* const mm_allocator) {
+  // Create new
+  affine_wavefronts_t* const affine_wavefronts =
+      affine_wavefronts_new(
+          pattern_length,text_length,NULL,penalties,
+          wavefronts_penalties_force_zero_match,mm_allocator);
   // Reduction
   affine_wavefronts_reduction_set_dynamic(
       &affine_wavefronts->reduction,min_wavefront_length,max_distance_threshold);
@@ -225,6 +433,66 @@ affine_wavefronts_t* affine_wavefronts_new_reduced(
   // Return
   return affine_wavefronts;
 }
+/*
+ * Setup extension matching semantics
+ */
+void affine_wavefronts_set_match(
+    affine_wavefronts_t* const affine_wavefronts,
+    const bool case_insensitive,
+    const wavefronts_match_n_type n_match) {
+  affine_wavefronts->match.case_insensitive = case_insensitive;
+  affine_wavefronts->match.n = n_match;
+}
+bool affine_wavefronts_match_chars(
+    const affine_wavefronts_match_t* const match,
+    const char pattern_char,
+    const char text_char) {
+  // Ambiguous bases (N/n on either sequence)
+  const char pattern_folded = pattern_char | 0x20;
+  const char text_folded = text_char | 0x20;
+  if (pattern_folded == 'n' || text_folded == 'n') {
+    if (match->n == wavefronts_match_n_any) return true;
+    if (match->n == wavefronts_match_n_none) return false;
+  }
+  // Exact match
+  if (pattern_char == text_char) return true;
+  // Fold case (only if both characters are letters)
+  return match->case_insensitive &&
+      pattern_folded >= 'a' && pattern_folded <= 'z' &&
+      pattern_folded == text_folded;
+}
+/*
+ * Setup input mode
+ */
+void affine_wavefronts_set_zero_copy(
+    affine_wavefronts_t* const affine_wavefronts,
+    const bool zero_copy,
+    const int readable_slack) {
+  affine_wavefronts->zero_copy = zero_copy;
+  affine_wavefronts->zero_copy_slack = readable_slack;
+}
+/*
+ * Setup CIGAR output
+ */
+void affine_wavefronts_set_cigar_rle(
+    affine_wavefronts_t* const affine_wavefronts,
+    const bool cigar_rle) {
+  affine_wavefronts->cigar_rle = cigar_rle;
+}
+/*
+ * Setup memory budget fallback
+ */
+void affine_wavefronts_set_budget_fallback(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int min_wavefront_length,
+    const int max_distance_threshold) {
+  if (min_wavefront_length < 0) {
+    affine_wavefronts_reduction_set_none(&affine_wavefronts->budget_reduction);
+  } else {
+    affine_wavefronts_reduction_set_dynamic(
+        &affine_wavefronts->budget_reduction,min_wavefront_length,max_distance_threshold);
+  }
+}
 /*
  * Allocate individual wavefront
  */
@@ -243,16 +511,17 @@ affine_wavefront_t* affine_wavefronts_allocate_wavefront(
   wavefront->hi = hi_base;
   wavefront->lo_base = lo_base;
   wavefront->hi_base = hi_base;
-  // Allocate offsets
-  awf_offset_t* const offsets_mem = mm_allocator_calloc(
-      affine_wavefronts->mm_allocator,wavefront_length,awf_offset_t,false);
-  awf_offset_t* const offsets = offsets_mem - lo_base; // Center at k=0
+  // Allocate offsets (aligned at k=0, so all wavefronts share the same vector phase)
+  const int lo_phase = lo_base & (AFFINE_WAVEFRONT_OFFSETS_LANES-1);
+  awf_offset_t* const offsets_mem = wavefront_slab_allocate(
+      &affine_wavefronts->offsets_slab,(lo_phase+wavefront_length)*sizeof(awf_offset_t));
+  awf_offset_t* const offsets = offsets_mem + lo_phase - lo_base; // Center at k=0
   wavefront->offsets = offsets;
   // DEBUG
 #ifdef AFFINE_WAVEFRONT_DEBUG
-  awf_offset_t* const offsets_base_mem = mm_allocator_calloc(
-      affine_wavefronts->mm_allocator,wavefront_length,awf_offset_t,false);
-  wavefront->offsets_base = offsets_base_mem - lo_base; // Center at k=0
+  awf_offset_t* const offsets_base_mem = wavefront_slab_allocate(
+      &affine_wavefronts->offsets_slab,(lo_phase+wavefront_length)*sizeof(awf_offset_t));
+  wavefront->offsets_base = offsets_base_mem + lo_phase - lo_base; // Center at k=0
 #endif
   // Return
   return wavefront;
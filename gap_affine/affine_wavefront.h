@@ -41,7 +41,9 @@
 #include "gap_affine/affine_table.h"
 #include "gap_affine/affine_wavefront_penalties.h"
 #include "gap_affine/affine_wavefront_reduction.h"
+#include "gap_affine/wavefront_slab.h"
 #include "gap_affine/wavefront_stats.h"
+#include "edit/edit_cigar_rle.h"
 
 /*
  * Debug
@@ -53,6 +55,8 @@
  * Constants
  */
 #define AFFINE_WAVEFRONT_K_NULL      (INT_MAX/2)
+#define AFFINE_WAVEFRONT_INIT_NUM_WAVEFRONTS 256 // Initial score-indexed wavefronts (grow on demand)
+#define AFFINE_WAVEFRONT_INIT_CIGAR_RUNS      64 // Initial RLE-CIGAR runs (grow on demand)
 
 /*
  * Translate k and offset to coordinates h,v
@@ -82,6 +86,28 @@
     #define AFFINE_WAVEFRONT_OFFSET_NULL (INT32_MIN/2)
   #endif
 #endif
+#define AFFINE_WAVEFRONT_OFFSETS_LANES (WAVEFRONT_SLAB_ALIGNMENT/sizeof(awf_offset_t)) // Offsets per aligned block
+
+/*
+ * Wavefront extension matching semantics
+ */
+typedef enum {
+  wavefronts_match_n_exact,    // N/n only match themselves (like any other character)
+  wavefronts_match_n_any,      // N/n match any character
+  wavefronts_match_n_none,     // N/n never match (not even another N/n)
+} wavefronts_match_n_type;
+typedef struct {
+  bool case_insensitive;       // Soft-masked (lower-case) characters match their upper-case
+  wavefronts_match_n_type n;   // Semantics of ambiguous base N/n
+} affine_wavefronts_match_t;
+
+/*
+ * Alignment status
+ */
+typedef enum {
+  affine_wavefronts_status_successful = 0,     // Alignment computed
+  affine_wavefronts_status_out_of_budget = -1, // MM-Allocator over budget (no alignment)
+} affine_wavefronts_status_t;
 
 /*
  * Wavefront
@@ -107,26 +133,39 @@ typedef struct {
   // Dimensions
   int pattern_length;                          // Pattern length
   int text_length;                             // Text length
-  int num_wavefronts;                          // Total number of allocatable wavefronts
+  int num_wavefronts;                          // Maximum number of wavefronts (score bound)
+  int num_wavefronts_allocated;                // Capacity of the score-indexed wavefront arrays
   // Limits
-  int max_penalty;                             // MAX(mismatch_penalty,single_gap_penalty)
+  int max_penalty;                             // MAX(mismatch_penalty,single_gap_penalty(s))
   int max_k;                                   // Maximum diagonal k (used for null-wf, display, and banding)
   int min_k;                                   // Maximum diagonal k (used for null-wf, display, and banding)
   // Wavefronts
   affine_wavefront_t** mwavefronts;            // M-wavefronts
   affine_wavefront_t** iwavefronts;            // I-wavefronts
   affine_wavefront_t** dwavefronts;            // D-wavefronts
-  affine_wavefront_t wavefront_null;           // Null wavefront (used to gain orthogonality)
+  affine_wavefront_t** i2wavefronts;           // I2-wavefronts (only two-piece gap-affine)
+  affine_wavefront_t** d2wavefronts;           // D2-wavefronts (only two-piece gap-affine)
+  affine_wavefront_t wavefront_null;           // Null wavefront (used to gain orthogonality; shared offsets)
+  int wavefront_null_radius;                   // Diagonals covered by the null wavefront ([-radius,radius])
   // Reduction
   affine_wavefronts_reduction_t reduction;     // Reduction parameters
+  affine_wavefronts_reduction_t budget_reduction; // Reduction used to retry out-of-budget alignments
   // Penalties
   affine_wavefronts_penalties_t penalties;     // Penalties parameters
+  // Extension
+  affine_wavefronts_match_t match;             // Matching semantics (exact by default)
+  // Input
+  bool zero_copy;                              // Align on the caller buffers (no padded copies)
+  int zero_copy_slack;                         // Readable bytes past the end of the caller buffers
   // CIGAR
   edit_cigar_t edit_cigar;                     // Alignment CIGAR
+  bool cigar_rle;                              // Emit the run-length encoded CIGAR (instead)
+  edit_cigar_rle_t edit_cigar_rle;             // Alignment RLE-CIGAR
   // MM
   mm_allocator_t* mm_allocator;                // MM-Allocator
   affine_wavefront_t* wavefronts_mem;          // MM-Slab for affine_wavefront_t (base)
   affine_wavefront_t* wavefronts_current;      // MM-Slab for affine_wavefront_t (next)
+  wavefront_slab_t offsets_slab;               // MM-Slab for wavefront offsets
   // STATS
   wavefronts_stats_t* wavefronts_stats; // Stats
   // DEBUG
@@ -144,10 +183,15 @@ typedef struct {
   affine_wavefront_t* in_mwavefront_gap;
   affine_wavefront_t* in_iwavefront_ext;
   affine_wavefront_t* in_dwavefront_ext;
+  affine_wavefront_t* in_mwavefront_gap2;
+  affine_wavefront_t* in_i2wavefront_ext;
+  affine_wavefront_t* in_d2wavefront_ext;
   /* Out Wavefronts */
   affine_wavefront_t* out_mwavefront;
   affine_wavefront_t* out_iwavefront;
   affine_wavefront_t* out_dwavefront;
+  affine_wavefront_t* out_i2wavefront;
+  affine_wavefront_t* out_d2wavefront;
 } affine_wavefront_set;
 
 /*
@@ -155,8 +199,14 @@ typedef struct {
  */
 void affine_wavefronts_clear(
     affine_wavefronts_t* const affine_wavefronts);
+void affine_wavefronts_reap(
+    affine_wavefronts_t* const affine_wavefronts);
 void affine_wavefronts_delete(
     affine_wavefronts_t* const affine_wavefronts);
+void affine_wavefronts_resize(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int pattern_length,
+    const int text_length);
 
 /*
  * Setup WF-modes
@@ -175,6 +225,73 @@ affine_wavefronts_t* affine_wavefronts_new_reduced(
     const int max_distance_threshold,
     wavefronts_stats_t* const wavefronts_stats,
     mm_allocator_t* const mm_allocator);
+affine_wavefronts_t* affine_wavefronts_new_complete_2p(
+    const int pattern_length,
+    const int text_length,
+    affine2p_penalties_t* const penalties,
+    wavefronts_stats_t* const wavefronts_stats,
+    mm_allocator_t* const mm_allocator);
+affine_wavefronts_t* affine_wavefronts_new_reduced_2p(
+    const int pattern_length,
+    const int text_length,
+    affine2p_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold,
+    wavefronts_stats_t* const wavefronts_stats,
+    mm_allocator_t* const mm_allocator);
+
+/*
+ * Setup extension matching semantics
+ *   affine_wavefronts_match_chars() compares two characters as the
+ *   extension does (scalar reference; e.g. for verification).
+ */
+void affine_wavefronts_set_match(
+    affine_wavefronts_t* const affine_wavefronts,
+    const bool case_insensitive,
+    const wavefronts_match_n_type n_match);
+bool affine_wavefronts_match_chars(
+    const affine_wavefronts_match_t* const match,
+    const char pattern_char,
+    const char text_char);
+
+/*
+ * Setup input mode
+ *   Zero-copy aligns directly on the caller buffers (bounds-aware extension).
+ *   If at least 8 bytes past the end of both sequences are readable, the
+ *   last block of each extension is loaded directly instead of copied.
+ */
+void affine_wavefronts_set_zero_copy(
+    affine_wavefronts_t* const affine_wavefronts,
+    const bool zero_copy,
+    const int readable_slack);
+
+/*
+ * Setup CIGAR output
+ *   RLE-CIGAR mode emits the alignment (only) into @edit_cigar_rle,
+ *   one packed run per operation stroke (as in SAM/BAM).
+ */
+void affine_wavefronts_set_cigar_rle(
+    affine_wavefronts_t* const affine_wavefronts,
+    const bool cigar_rle);
+
+/*
+ * Setup memory budget fallback
+ *   Alignments aborted because the MM-Allocator went over budget are
+ *   retried once using the adaptive reduction (min_wavefront_length < 0
+ *   disables the retry). The retry is heuristic (the score might not be
+ *   optimal), but its memory grows with the score, not with its square.
+ */
+void affine_wavefronts_set_budget_fallback(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int min_wavefront_length,
+    const int max_distance_threshold);
+
+/*
+ * Grow score-indexed wavefronts (on demand)
+ */
+void affine_wavefronts_grow_wavefront_components(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int min_num_wavefronts);
 
 /*
  * Allocate individual wavefront
@@ -53,6 +53,19 @@ void affine_wavefronts_fetch_wavefronts(
   wavefront_set->in_mwavefront_gap = affine_wavefronts_get_source_mwavefront(affine_wavefronts,gap_open_score);
   wavefront_set->in_iwavefront_ext = affine_wavefronts_get_source_iwavefront(affine_wavefronts,gap_extend_score);
   wavefront_set->in_dwavefront_ext = affine_wavefronts_get_source_dwavefront(affine_wavefronts,gap_extend_score);
+  // Fetch two-piece wavefronts
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    const affine2p_penalties_t* const wavefront_penalties_2p = &(affine_wavefronts->penalties.wavefront_penalties_2p);
+    const int gap_open2_score = score - wavefront_penalties_2p->gap_opening2 - wavefront_penalties_2p->gap_extension2;
+    const int gap_extend2_score = score - wavefront_penalties_2p->gap_extension2;
+    wavefront_set->in_mwavefront_gap2 = affine_wavefronts_get_source_mwavefront(affine_wavefronts,gap_open2_score);
+    wavefront_set->in_i2wavefront_ext = affine_wavefronts_get_source_i2wavefront(affine_wavefronts,gap_extend2_score);
+    wavefront_set->in_d2wavefront_ext = affine_wavefronts_get_source_d2wavefront(affine_wavefronts,gap_extend2_score);
+  } else {
+    wavefront_set->in_mwavefront_gap2 = &affine_wavefronts->wavefront_null;
+    wavefront_set->in_i2wavefront_ext = &affine_wavefronts->wavefront_null;
+    wavefront_set->in_d2wavefront_ext = &affine_wavefronts->wavefront_null;
+  }
 }
 void affine_wavefronts_allocate_wavefronts(
     affine_wavefronts_t* const affine_wavefronts,
@@ -64,6 +77,24 @@ void affine_wavefronts_allocate_wavefronts(
   wavefront_set->out_mwavefront =
       affine_wavefronts_allocate_wavefront(affine_wavefronts,lo_effective,hi_effective);
   affine_wavefronts->mwavefronts[score] = wavefront_set->out_mwavefront;
+  // Allocate all components (two-piece gap-affine)
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    wavefront_set->out_iwavefront =
+        affine_wavefronts_allocate_wavefront(affine_wavefronts,lo_effective,hi_effective);
+    affine_wavefronts->iwavefronts[score] = wavefront_set->out_iwavefront;
+    wavefront_set->out_dwavefront =
+        affine_wavefronts_allocate_wavefront(affine_wavefronts,lo_effective,hi_effective);
+    affine_wavefronts->dwavefronts[score] = wavefront_set->out_dwavefront;
+    wavefront_set->out_i2wavefront =
+        affine_wavefronts_allocate_wavefront(affine_wavefronts,lo_effective,hi_effective);
+    affine_wavefronts->i2wavefronts[score] = wavefront_set->out_i2wavefront;
+    wavefront_set->out_d2wavefront =
+        affine_wavefronts_allocate_wavefront(affine_wavefronts,lo_effective,hi_effective);
+    affine_wavefronts->d2wavefronts[score] = wavefront_set->out_d2wavefront;
+    return;
+  }
+  wavefront_set->out_i2wavefront = NULL;
+  wavefront_set->out_d2wavefront = NULL;
   // Allocate I-Wavefront
   if (!wavefront_set->in_mwavefront_gap->null || !wavefront_set->in_iwavefront_ext->null) {
     wavefront_set->out_iwavefront =
@@ -92,13 +123,22 @@ void affine_wavefronts_compute_limits(
   if (lo > wavefront_set->in_mwavefront_gap->lo) lo = wavefront_set->in_mwavefront_gap->lo;
   if (lo > wavefront_set->in_iwavefront_ext->lo) lo = wavefront_set->in_iwavefront_ext->lo;
   if (lo > wavefront_set->in_dwavefront_ext->lo) lo = wavefront_set->in_dwavefront_ext->lo;
+  if (lo > wavefront_set->in_mwavefront_gap2->lo) lo = wavefront_set->in_mwavefront_gap2->lo;
+  if (lo > wavefront_set->in_i2wavefront_ext->lo) lo = wavefront_set->in_i2wavefront_ext->lo;
+  if (lo > wavefront_set->in_d2wavefront_ext->lo) lo = wavefront_set->in_d2wavefront_ext->lo;
   --lo;
   // Set limits (max_hi)
   int hi = wavefront_set->in_mwavefront_sub->hi;
   if (hi < wavefront_set->in_mwavefront_gap->hi) hi = wavefront_set->in_mwavefront_gap->hi;
   if (hi < wavefront_set->in_iwavefront_ext->hi) hi = wavefront_set->in_iwavefront_ext->hi;
   if (hi < wavefront_set->in_dwavefront_ext->hi) hi = wavefront_set->in_dwavefront_ext->hi;
+  if (hi < wavefront_set->in_mwavefront_gap2->hi) hi = wavefront_set->in_mwavefront_gap2->hi;
+  if (hi < wavefront_set->in_i2wavefront_ext->hi) hi = wavefront_set->in_i2wavefront_ext->hi;
+  if (hi < wavefront_set->in_d2wavefront_ext->hi) hi = wavefront_set->in_d2wavefront_ext->hi;
   ++hi;
+  // Trim to the diagonals of the DP-table (null-wavefront reads stay within bounds)
+  if (lo < affine_wavefronts->min_k) lo = affine_wavefronts->min_k;
+  if (hi > affine_wavefronts->max_k) hi = affine_wavefronts->max_k;
   // Set effective limits values
   *hi_effective = hi;
   *lo_effective = lo;
@@ -273,6 +313,113 @@ void affine_wavefronts_compute_offsets_m(
     out_moffsets[k] = AFFINE_WAVEFRONT_COND_FETCH(m_sub,k,m_sub_offsets[k]+1);
   }
 }
+void affine_wavefronts_compute_offsets_idm2p(
+    affine_wavefronts_t* const affine_wavefronts,
+    const affine_wavefront_set* const wavefront_set,
+    const int lo,
+    const int hi) {
+  // Parameters
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_mwavefront_sub,m_sub);
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_mwavefront_gap,m_gap);
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_iwavefront_ext,i_ext);
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_dwavefront_ext,d_ext);
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_mwavefront_gap2,m_gap2);
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_i2wavefront_ext,i2_ext);
+  AFFINE_WAVEFRONT_DECLARE(wavefront_set->in_d2wavefront_ext,d2_ext);
+  awf_offset_t* const out_ioffsets = wavefront_set->out_iwavefront->offsets;
+  awf_offset_t* const out_doffsets = wavefront_set->out_dwavefront->offsets;
+  awf_offset_t* const out_i2offsets = wavefront_set->out_i2wavefront->offsets;
+  awf_offset_t* const out_d2offsets = wavefront_set->out_d2wavefront->offsets;
+  awf_offset_t* const out_moffsets = wavefront_set->out_mwavefront->offsets;
+  // Compute loop peeling offset (min_hi)
+  int min_hi = wavefront_set->in_mwavefront_sub->hi;
+  if (!wavefront_set->in_mwavefront_gap->null && min_hi > wavefront_set->in_mwavefront_gap->hi-1) min_hi = wavefront_set->in_mwavefront_gap->hi-1;
+  if (!wavefront_set->in_iwavefront_ext->null && min_hi > wavefront_set->in_iwavefront_ext->hi+1) min_hi = wavefront_set->in_iwavefront_ext->hi+1;
+  if (!wavefront_set->in_dwavefront_ext->null && min_hi > wavefront_set->in_dwavefront_ext->hi-1) min_hi = wavefront_set->in_dwavefront_ext->hi-1;
+  if (!wavefront_set->in_mwavefront_gap2->null && min_hi > wavefront_set->in_mwavefront_gap2->hi-1) min_hi = wavefront_set->in_mwavefront_gap2->hi-1;
+  if (!wavefront_set->in_i2wavefront_ext->null && min_hi > wavefront_set->in_i2wavefront_ext->hi+1) min_hi = wavefront_set->in_i2wavefront_ext->hi+1;
+  if (!wavefront_set->in_d2wavefront_ext->null && min_hi > wavefront_set->in_d2wavefront_ext->hi-1) min_hi = wavefront_set->in_d2wavefront_ext->hi-1;
+  // Compute loop peeling offset (max_lo)
+  int max_lo = wavefront_set->in_mwavefront_sub->lo;
+  if (!wavefront_set->in_mwavefront_gap->null && max_lo < wavefront_set->in_mwavefront_gap->lo+1) max_lo = wavefront_set->in_mwavefront_gap->lo+1;
+  if (!wavefront_set->in_iwavefront_ext->null && max_lo < wavefront_set->in_iwavefront_ext->lo+1) max_lo = wavefront_set->in_iwavefront_ext->lo+1;
+  if (!wavefront_set->in_dwavefront_ext->null && max_lo < wavefront_set->in_dwavefront_ext->lo-1) max_lo = wavefront_set->in_dwavefront_ext->lo-1;
+  if (!wavefront_set->in_mwavefront_gap2->null && max_lo < wavefront_set->in_mwavefront_gap2->lo+1) max_lo = wavefront_set->in_mwavefront_gap2->lo+1;
+  if (!wavefront_set->in_i2wavefront_ext->null && max_lo < wavefront_set->in_i2wavefront_ext->lo+1) max_lo = wavefront_set->in_i2wavefront_ext->lo+1;
+  if (!wavefront_set->in_d2wavefront_ext->null && max_lo < wavefront_set->in_d2wavefront_ext->lo-1) max_lo = wavefront_set->in_d2wavefront_ext->lo-1;
+  // Compute score wavefronts (prologue)
+  int k;
+  for (k=lo;k<max_lo;++k) {
+    // Update I1/I2
+    const awf_offset_t ins1_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap,k-1,m_gap_offsets[k-1]);
+    const awf_offset_t ins1_i = AFFINE_WAVEFRONT_COND_FETCH(i_ext,k-1,i_ext_offsets[k-1]);
+    const awf_offset_t ins1 = MAX(ins1_g,ins1_i) + 1;
+    out_ioffsets[k] = ins1;
+    const awf_offset_t ins2_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap2,k-1,m_gap2_offsets[k-1]);
+    const awf_offset_t ins2_i = AFFINE_WAVEFRONT_COND_FETCH(i2_ext,k-1,i2_ext_offsets[k-1]);
+    const awf_offset_t ins2 = MAX(ins2_g,ins2_i) + 1;
+    out_i2offsets[k] = ins2;
+    // Update D1/D2
+    const awf_offset_t del1_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap,k+1,m_gap_offsets[k+1]);
+    const awf_offset_t del1_d = AFFINE_WAVEFRONT_COND_FETCH(d_ext,k+1,d_ext_offsets[k+1]);
+    const awf_offset_t del1 = MAX(del1_g,del1_d);
+    out_doffsets[k] = del1;
+    const awf_offset_t del2_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap2,k+1,m_gap2_offsets[k+1]);
+    const awf_offset_t del2_d = AFFINE_WAVEFRONT_COND_FETCH(d2_ext,k+1,d2_ext_offsets[k+1]);
+    const awf_offset_t del2 = MAX(del2_g,del2_d);
+    out_d2offsets[k] = del2;
+    // Update M
+    const awf_offset_t sub = AFFINE_WAVEFRONT_COND_FETCH(m_sub,k,m_sub_offsets[k]+1);
+    out_moffsets[k] = MAX(MAX(sub,MAX(ins1,ins2)),MAX(del1,del2));
+  }
+  // Compute score wavefronts (core)
+#if defined(__clang__)
+  #pragma clang loop vectorize(enable)
+#elif defined(__GNUC__) || defined(__GNUG__)
+  #pragma GCC ivdep
+#else
+  #pragma ivdep
+#endif
+  for (k=max_lo;k<=min_hi;++k) {
+    // Update I1/I2
+    const awf_offset_t ins1 = MAX(m_gap_offsets[k-1],i_ext_offsets[k-1]) + 1;
+    out_ioffsets[k] = ins1;
+    const awf_offset_t ins2 = MAX(m_gap2_offsets[k-1],i2_ext_offsets[k-1]) + 1;
+    out_i2offsets[k] = ins2;
+    // Update D1/D2
+    const awf_offset_t del1 = MAX(m_gap_offsets[k+1],d_ext_offsets[k+1]);
+    out_doffsets[k] = del1;
+    const awf_offset_t del2 = MAX(m_gap2_offsets[k+1],d2_ext_offsets[k+1]);
+    out_d2offsets[k] = del2;
+    // Update M
+    const awf_offset_t sub = m_sub_offsets[k] + 1;
+    out_moffsets[k] = MAX(MAX(sub,MAX(ins1,ins2)),MAX(del1,del2));
+  }
+  // Compute score wavefronts (epilogue)
+  for (k=min_hi+1;k<=hi;++k) {
+    // Update I1/I2
+    const awf_offset_t ins1_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap,k-1,m_gap_offsets[k-1]);
+    const awf_offset_t ins1_i = AFFINE_WAVEFRONT_COND_FETCH(i_ext,k-1,i_ext_offsets[k-1]);
+    const awf_offset_t ins1 = MAX(ins1_g,ins1_i) + 1;
+    out_ioffsets[k] = ins1;
+    const awf_offset_t ins2_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap2,k-1,m_gap2_offsets[k-1]);
+    const awf_offset_t ins2_i = AFFINE_WAVEFRONT_COND_FETCH(i2_ext,k-1,i2_ext_offsets[k-1]);
+    const awf_offset_t ins2 = MAX(ins2_g,ins2_i) + 1;
+    out_i2offsets[k] = ins2;
+    // Update D1/D2
+    const awf_offset_t del1_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap,k+1,m_gap_offsets[k+1]);
+    const awf_offset_t del1_d = AFFINE_WAVEFRONT_COND_FETCH(d_ext,k+1,d_ext_offsets[k+1]);
+    const awf_offset_t del1 = MAX(del1_g,del1_d);
+    out_doffsets[k] = del1;
+    const awf_offset_t del2_g = AFFINE_WAVEFRONT_COND_FETCH(m_gap2,k+1,m_gap2_offsets[k+1]);
+    const awf_offset_t del2_d = AFFINE_WAVEFRONT_COND_FETCH(d2_ext,k+1,d2_ext_offsets[k+1]);
+    const awf_offset_t del2 = MAX(del2_g,del2_d);
+    out_d2offsets[k] = del2;
+    // Update M
+    const awf_offset_t sub = AFFINE_WAVEFRONT_COND_FETCH(m_sub,k,m_sub_offsets[k]+1);
+    out_moffsets[k] = MAX(MAX(sub,MAX(ins1,ins2)),MAX(del1,del2));
+  }
+}
 /*
  * Compute wavefront
  */
@@ -283,6 +430,10 @@ void affine_wavefronts_compute_wavefront(
     const char* const text,
     const int text_length,
     const int score) {
+  // Grow score-indexed wavefronts (if needed)
+  if (score >= affine_wavefronts->num_wavefronts_allocated) {
+    affine_wavefronts_grow_wavefront_components(affine_wavefronts,score+1);
+  }
   // Select wavefronts
   affine_wavefront_set wavefront_set;
   affine_wavefronts_fetch_wavefronts(affine_wavefronts,&wavefront_set,score);
@@ -290,7 +441,10 @@ void affine_wavefronts_compute_wavefront(
   if (wavefront_set.in_mwavefront_sub->null &&
       wavefront_set.in_mwavefront_gap->null &&
       wavefront_set.in_iwavefront_ext->null &&
-      wavefront_set.in_dwavefront_ext->null) {
+      wavefront_set.in_dwavefront_ext->null &&
+      wavefront_set.in_mwavefront_gap2->null &&
+      wavefront_set.in_i2wavefront_ext->null &&
+      wavefront_set.in_d2wavefront_ext->null) {
     WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_steps_null,1);
     return;
   }
@@ -304,21 +458,26 @@ void affine_wavefronts_compute_wavefront(
   // Allocate score-wavefronts
   affine_wavefronts_allocate_wavefronts(affine_wavefronts,&wavefront_set,score,lo,hi);
   // Compute WF
-  const int kernel = ((wavefront_set.out_iwavefront!=NULL) << 1) | (wavefront_set.out_dwavefront!=NULL);
-  WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_compute_kernel[kernel],1);
-  switch (kernel) {
-    case 3: // 11b
-      affine_wavefronts_compute_offsets_idm(affine_wavefronts,&wavefront_set,lo,hi);
-      break;
-    case 2: // 10b
-      affine_wavefronts_compute_offsets_im(affine_wavefronts,&wavefront_set,lo,hi);
-      break;
-    case 1: // 01b
-      affine_wavefronts_compute_offsets_dm(affine_wavefronts,&wavefront_set,lo,hi);
-      break;
-    case 0: // 00b
-      affine_wavefronts_compute_offsets_m(affine_wavefronts,&wavefront_set,lo,hi);
-      break;
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    // Two-piece gap-affine (all components allocated)
+    affine_wavefronts_compute_offsets_idm2p(affine_wavefronts,&wavefront_set,lo,hi);
+  } else {
+    const int kernel = ((wavefront_set.out_iwavefront!=NULL) << 1) | (wavefront_set.out_dwavefront!=NULL);
+    WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_compute_kernel[kernel],1);
+    switch (kernel) {
+      case 3: // 11b
+        affine_wavefronts_compute_offsets_idm(affine_wavefronts,&wavefront_set,lo,hi);
+        break;
+      case 2: // 10b
+        affine_wavefronts_compute_offsets_im(affine_wavefronts,&wavefront_set,lo,hi);
+        break;
+      case 1: // 01b
+        affine_wavefronts_compute_offsets_dm(affine_wavefronts,&wavefront_set,lo,hi);
+        break;
+      case 0: // 00b
+        affine_wavefronts_compute_offsets_m(affine_wavefronts,&wavefront_set,lo,hi);
+        break;
+    }
   }
   // Account for WF operations performed
   WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_operations,hi-lo+1);
@@ -337,39 +496,57 @@ void affine_wavefronts_compute_wavefront(
 /*
  * Computation using Wavefronts
  */
-void affine_wavefronts_align(
+affine_wavefronts_status_t affine_wavefronts_align_wavefronts(
     affine_wavefronts_t* const affine_wavefronts,
     const char* const pattern,
     const int pattern_length,
     const char* const text,
     const int text_length) {
-  // Init padded strings
-  strings_padded_t* const strings_padded =
-      strings_padded_new_rhomb(
-          pattern,pattern_length,text,text_length,
-          AFFINE_WAVEFRONT_PADDING,affine_wavefronts->mm_allocator);
+  // Bound diagonals to the aligned (trimmed) sequences
+  const int min_k = affine_wavefronts->min_k;
+  const int max_k = affine_wavefronts->max_k;
+  affine_wavefronts->min_k = MAX(min_k,-pattern_length);
+  affine_wavefronts->max_k = MIN(max_k,text_length);
+  // Init padded strings (unless aligning on the caller buffers)
+  strings_padded_t* strings_padded = NULL;
+  const char* pattern_aligned = pattern;
+  const char* text_aligned = text;
+  if (!affine_wavefronts->zero_copy) {
+    strings_padded = strings_padded_new_rhomb(
+        pattern,pattern_length,text,text_length,
+        AFFINE_WAVEFRONT_PADDING,affine_wavefronts->mm_allocator);
+    pattern_aligned = strings_padded->pattern_padded;
+    text_aligned = strings_padded->text_padded;
+  }
   // Initialize wavefront
   affine_wavefront_initialize(affine_wavefronts);
   // Compute wavefronts for increasing score
+  mm_allocator_t* const mm_allocator = affine_wavefronts->mm_allocator;
+  affine_wavefronts_status_t status = affine_wavefronts_status_successful;
   int score = 0;
   while (true) {
     // Exact extend s-wavefront
     affine_wavefronts_extend_wavefront_packed(
-        affine_wavefronts,strings_padded->pattern_padded,pattern_length,
-        strings_padded->text_padded,text_length,score);
+        affine_wavefronts,pattern_aligned,pattern_length,
+        text_aligned,text_length,score);
     // Exit condition
     if (affine_wavefront_end_reached(affine_wavefronts,pattern_length,text_length,score)) {
       // Backtrace & check alignment reached
       affine_wavefronts_backtrace(
-          affine_wavefronts,strings_padded->pattern_padded,pattern_length,
-          strings_padded->text_padded,text_length,score);
+          affine_wavefronts,pattern_aligned,pattern_length,
+          text_aligned,text_length,score);
       break;
     }
     // Update all wavefronts
     ++score; // Increase score
     affine_wavefronts_compute_wavefront(
-        affine_wavefronts,strings_padded->pattern_padded,pattern_length,
-        strings_padded->text_padded,text_length,score);
+        affine_wavefronts,pattern_aligned,pattern_length,
+        text_aligned,text_length,score);
+    // Check memory budget
+    if (mm_allocator_over_budget(mm_allocator)) {
+      status = affine_wavefronts_status_out_of_budget;
+      break;
+    }
     // DEBUG
     //affine_wavefronts_debug_step(affine_wavefronts,pattern,text,score);
     WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_steps,1);
@@ -378,6 +555,110 @@ void affine_wavefronts_align(
   //affine_wavefronts_debug_step(affine_wavefronts,pattern,text,score);
   WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_score,score); // STATS
   // Free
-  strings_padded_delete(strings_padded);
+  if (strings_padded != NULL) strings_padded_delete(strings_padded);
+  // Restore limits
+  affine_wavefronts->min_k = min_k;
+  affine_wavefronts->max_k = max_k;
+  // Return
+  return status;
+}
+int affine_wavefronts_gap_free_max_mismatches(
+    affine_wavefronts_t* const affine_wavefronts) {
+  // Any gapped alignment of equal-length sequences has (at least) one
+  // insertion and one deletion. Thus, a gap-free alignment is optimal
+  // if its mismatches cost no more than two single gaps.
+  const affine_wavefronts_penalties_t* const penalties = &affine_wavefronts->penalties;
+  const affine_penalties_t* const wavefront_penalties = &penalties->wavefront_penalties;
+  int min_gap_penalty = wavefront_penalties->gap_opening + wavefront_penalties->gap_extension;
+  if (penalties->gap_affine_2p) {
+    const affine2p_penalties_t* const wavefront_penalties_2p = &penalties->wavefront_penalties_2p;
+    min_gap_penalty = MIN(min_gap_penalty,
+        wavefront_penalties_2p->gap_opening2+wavefront_penalties_2p->gap_extension2);
+  }
+  if (wavefront_penalties->mismatch <= 0) return INT_MAX;
+  return (2*min_gap_penalty) / wavefront_penalties->mismatch;
+}
+bool affine_wavefronts_align_gap_free(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const char* const text,
+    const int length) {
+  // CIGAR mode writes in place (RLE-CIGAR mode uses the CIGAR buffer as scratch)
+  edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
+  char* const operations = (affine_wavefronts->cigar_rle) ? edit_cigar->operations :
+      edit_cigar->operations+edit_cigar->begin_offset-length+1;
+  const int max_mismatches = affine_wavefronts_gap_free_max_mismatches(affine_wavefronts);
+  if (affine_wavefronts_extend_gap_free(
+      affine_wavefronts,pattern,text,length,max_mismatches,operations) < 0) return false;
+  affine_wavefronts_backtrace_prepend_operations(affine_wavefronts,operations,length);
+  return true;
+}
+affine_wavefronts_status_t affine_wavefronts_align_pair(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Trim common prefix & suffix (always part of an optimal alignment)
+  const int min_length = MIN(pattern_length,text_length);
+  const int prefix_length = affine_wavefronts_extend_common_prefix(
+      affine_wavefronts,pattern,text,min_length);
+  const int suffix_length = affine_wavefronts_extend_common_suffix(
+      affine_wavefronts,pattern+pattern_length,text+text_length,min_length-prefix_length);
+  const int core_pattern_length = pattern_length - prefix_length - suffix_length;
+  const int core_text_length = text_length - prefix_length - suffix_length;
+  // Add suffix matches (CIGAR is traced backwards)
+  edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
+  affine_wavefronts_backtrace_prepend(affine_wavefronts,'M',suffix_length);
+  // Align the divergent core
+  if (core_pattern_length == 0 || core_text_length == 0) {
+    // Single gap (or nothing) left
+    affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',core_pattern_length);
+    affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',core_text_length);
+  } else if (core_pattern_length == core_text_length &&
+             affine_wavefronts_align_gap_free(
+                 affine_wavefronts,pattern+prefix_length,
+                 text+prefix_length,core_text_length)) {
+    // Gap-free alignment (provably optimal)
+  } else {
+    const affine_wavefronts_status_t status = affine_wavefronts_align_wavefronts(
+        affine_wavefronts,pattern+prefix_length,core_pattern_length,
+        text+prefix_length,core_text_length);
+    if (status != affine_wavefronts_status_successful) return status;
+  }
+  // Add prefix matches
+  affine_wavefronts_backtrace_prepend(affine_wavefronts,'M',prefix_length);
+  // Set CIGAR length
+  if (!affine_wavefronts->cigar_rle) ++(edit_cigar->begin_offset);
+  // Return
+  return affine_wavefronts_status_successful;
+}
+affine_wavefronts_status_t affine_wavefronts_align(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Align
+  affine_wavefronts_status_t status = affine_wavefronts_align_pair(
+      affine_wavefronts,pattern,pattern_length,text,text_length);
+  if (status == affine_wavefronts_status_successful) return status;
+  // Out of budget (release the wavefronts memory)
+  affine_wavefronts_reap(affine_wavefronts);
+  // Retry using the adaptive reduction (if enabled)
+  if (affine_wavefronts->budget_reduction.reduction_strategy != wavefronts_reduction_none) {
+    const affine_wavefronts_reduction_t reduction = affine_wavefronts->reduction;
+    affine_wavefronts->reduction = affine_wavefronts->budget_reduction;
+    status = affine_wavefronts_align_pair(
+        affine_wavefronts,pattern,pattern_length,text,text_length);
+    affine_wavefronts->reduction = reduction;
+    if (status == affine_wavefronts_status_successful) return status;
+    affine_wavefronts_reap(affine_wavefronts);
+  }
+  // Leave an empty CIGAR (no alignment)
+  edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
+  edit_cigar->begin_offset = edit_cigar->end_offset;
+  // Return
+  return status;
 }
 
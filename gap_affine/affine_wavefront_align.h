@@ -37,8 +37,12 @@
 
 /*
  * Computation using Wavefronts
+ *   Returns affine_wavefronts_status_out_of_budget (and an empty CIGAR)
+ *   if the MM-Allocator went over its budget (and the retry, if any,
+ *   did too). The allocator memory is released back down to the aligner
+ *   baseline before returning.
  */
-void affine_wavefronts_align(
+affine_wavefronts_status_t affine_wavefronts_align(
     affine_wavefronts_t* const affine_wavefronts,
     const char* const pattern,
     const int pattern_length,
@@ -31,6 +31,43 @@
 
 #include "gap_affine/affine_wavefront_backtrace.h"
 
+/*
+ * Backtrace CIGAR
+ */
+void affine_wavefronts_backtrace_prepend(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char operation,
+    const int length) {
+  if (affine_wavefronts->cigar_rle) {
+    edit_cigar_rle_prepend(&affine_wavefronts->edit_cigar_rle,operation,length);
+  } else {
+    // CIGAR is traced backwards (begin_offset points to the next free position)
+    edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
+    edit_cigar->begin_offset -= length;
+    memset(edit_cigar->operations+edit_cigar->begin_offset+1,operation,length);
+  }
+}
+void affine_wavefronts_backtrace_prepend_operations(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const operations,
+    const int num_operations) {
+  if (affine_wavefronts->cigar_rle) {
+    // Compact into runs (traversing backwards)
+    int i = num_operations-1;
+    while (i >= 0) {
+      const char operation = operations[i];
+      int length = 0;
+      while (i >= 0 && operations[i] == operation) {
+        ++length; --i;
+      }
+      edit_cigar_rle_prepend(&affine_wavefronts->edit_cigar_rle,operation,length);
+    }
+  } else {
+    edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
+    edit_cigar->begin_offset -= num_operations;
+    memmove(edit_cigar->operations+edit_cigar->begin_offset+1,operations,num_operations);
+  }
+}
 /*
  * Backtrace Detect Limits
  */
@@ -46,20 +83,15 @@ bool affine_wavefronts_valid_location(
           h > 0 && h <= text_length);
 }
 void affine_wavefronts_offset_add_trailing_gap(
-    edit_cigar_t* const edit_cigar,
+    affine_wavefronts_t* const affine_wavefronts,
     const int k,
     const int alignment_k) {
-  // Parameters
-  char* const operations = edit_cigar->operations;
-  int op_sentinel = edit_cigar->begin_offset;
   // Add trailing gap
-  int i;
   if (k < alignment_k) {
-    for (i=k;i<alignment_k;++i) operations[op_sentinel--] = 'I';
+    affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',alignment_k-k);
   } else if (k > alignment_k) {
-    for (i=alignment_k;i<k;++i) operations[op_sentinel--] = 'D';
+    affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',k-alignment_k);
   }
-  edit_cigar->begin_offset = op_sentinel;
 }
 /*
  * Backtrace Paths Offsets
@@ -124,6 +156,36 @@ awf_offset_t backtrace_wavefront_trace_insertion_extend_offset(
     return AFFINE_WAVEFRONT_OFFSET_NULL;
   }
 }
+awf_offset_t backtrace_wavefront_trace_deletion2_extend_offset(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int score,
+    const int k,
+    const awf_offset_t offset) {
+  if (score < 0) return AFFINE_WAVEFRONT_OFFSET_NULL;
+  affine_wavefront_t* const d2wavefront = affine_wavefronts->d2wavefronts[score];
+  if (d2wavefront != NULL &&
+      d2wavefront->lo <= k+1 &&
+      k+1 <= d2wavefront->hi) {
+    return d2wavefront->offsets[k+1];
+  } else {
+    return AFFINE_WAVEFRONT_OFFSET_NULL;
+  }
+}
+awf_offset_t backtrace_wavefront_trace_insertion2_extend_offset(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int score,
+    const int k,
+    const awf_offset_t offset) {
+  if (score < 0) return AFFINE_WAVEFRONT_OFFSET_NULL;
+  affine_wavefront_t* const i2wavefront = affine_wavefronts->i2wavefronts[score];
+  if (i2wavefront != NULL &&
+      i2wavefront->lo <= k-1 &&
+      k-1 <= i2wavefront->hi) {
+    return i2wavefront->offsets[k-1] + 1;
+  } else {
+    return AFFINE_WAVEFRONT_OFFSET_NULL;
+  }
+}
 awf_offset_t backtrace_wavefront_trace_mismatch_offset(
     affine_wavefronts_t* const affine_wavefronts,
     const int score,
@@ -149,12 +211,11 @@ void affine_wavefronts_backtrace_matches__check(
     const int k,
     awf_offset_t offset,
     const bool valid_location,
-    const int num_matches,
-    edit_cigar_t* const edit_cigar) {
+    const int num_matches) {
+  // DEBUG
+#ifdef AFFINE_WAVEFRONT_DEBUG
   int i;
   for (i=0;i<num_matches;++i) {
-    // DEBUG
-#ifdef AFFINE_WAVEFRONT_DEBUG
     const int v = AFFINE_WAVEFRONT_V(k,offset);
     const int h = AFFINE_WAVEFRONT_H(k,offset);
     if (!valid_location) { // Check inside table
@@ -164,30 +225,21 @@ void affine_wavefronts_backtrace_matches__check(
       fprintf(stderr,"Backtrace error: Not a match traceback\n");
       exit(1);
     }
-#endif
-    // Set Match
-    edit_cigar->operations[(edit_cigar->begin_offset)--] = 'M';
     // Update state
     --offset;
   }
-}
-void affine_wavefronts_backtrace_matches(
-    edit_cigar_t* const edit_cigar,
-    const int num_matches) {
+#endif
   // Set Matches
-  int i;
-  for (i=0;i<num_matches;++i) {
-    edit_cigar->operations[(edit_cigar->begin_offset)--] = 'M';
-  }
+  affine_wavefronts_backtrace_prepend(affine_wavefronts,'M',num_matches);
 }
 /*
  * Backtrace (single solution)
  */
 void affine_wavefronts_backtrace(
     affine_wavefronts_t* const affine_wavefronts,
-    char* const pattern,
+    const char* const pattern,
     const int pattern_length,
-    char* const text,
+    const char* const text,
     const int text_length,
     const int alignment_score) {
   // STATS
@@ -195,7 +247,9 @@ void affine_wavefronts_backtrace(
   // Parameters
   const affine_penalties_t* const wavefront_penalties =
       &(affine_wavefronts->penalties.wavefront_penalties);
-  edit_cigar_t* const cigar = &affine_wavefronts->edit_cigar;
+  const affine2p_penalties_t* const wavefront_penalties_2p =
+      &(affine_wavefronts->penalties.wavefront_penalties_2p);
+  const bool gap_affine_2p = affine_wavefronts->penalties.gap_affine_2p;
   const int alignment_k = AFFINE_WAVEFRONT_DIAGONAL(text_length,pattern_length);
   // Compute starting location
   int score = alignment_score;
@@ -211,33 +265,49 @@ void affine_wavefronts_backtrace(
     if (!valid_location) {
       valid_location = affine_wavefronts_valid_location(k,offset,pattern_length,text_length);
       if (valid_location) {
-        affine_wavefronts_offset_add_trailing_gap(cigar,k,alignment_k);
+        affine_wavefronts_offset_add_trailing_gap(affine_wavefronts,k,alignment_k);
       }
     }
     // Compute scores
     const int gap_open_score = score - wavefront_penalties->gap_opening - wavefront_penalties->gap_extension;
     const int gap_extend_score = score - wavefront_penalties->gap_extension;
+    const int gap_open2_score = score - wavefront_penalties_2p->gap_opening2 - wavefront_penalties_2p->gap_extension2;
+    const int gap_extend2_score = score - wavefront_penalties_2p->gap_extension2;
     const int mismatch_score = score - wavefront_penalties->mismatch;
     // Compute source offsets
-    const awf_offset_t del_ext = (backtrace_type == backtrace_wavefront_I) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+    const bool trace_del = (backtrace_type == backtrace_wavefront_M || backtrace_type == backtrace_wavefront_D);
+    const bool trace_ins = (backtrace_type == backtrace_wavefront_M || backtrace_type == backtrace_wavefront_I);
+    const bool trace_del2 = gap_affine_2p &&
+        (backtrace_type == backtrace_wavefront_M || backtrace_type == backtrace_wavefront_D2);
+    const bool trace_ins2 = gap_affine_2p &&
+        (backtrace_type == backtrace_wavefront_M || backtrace_type == backtrace_wavefront_I2);
+    const awf_offset_t del_ext = (!trace_del) ? AFFINE_WAVEFRONT_OFFSET_NULL:
         backtrace_wavefront_trace_deletion_extend_offset(affine_wavefronts,gap_extend_score,k,offset);
-    const awf_offset_t del_open = (backtrace_type == backtrace_wavefront_I) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+    const awf_offset_t del_open = (!trace_del) ? AFFINE_WAVEFRONT_OFFSET_NULL:
         backtrace_wavefront_trace_deletion_open_offset(affine_wavefronts,gap_open_score,k,offset);
-    const awf_offset_t ins_ext = (backtrace_type == backtrace_wavefront_D) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+    const awf_offset_t ins_ext = (!trace_ins) ? AFFINE_WAVEFRONT_OFFSET_NULL:
         backtrace_wavefront_trace_insertion_extend_offset(affine_wavefronts,gap_extend_score,k,offset);
-    const awf_offset_t ins_open = (backtrace_type == backtrace_wavefront_D) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+    const awf_offset_t ins_open = (!trace_ins) ? AFFINE_WAVEFRONT_OFFSET_NULL:
         backtrace_wavefront_trace_insertion_open_offset(affine_wavefronts,gap_open_score,k,offset);
+    const awf_offset_t del2_ext = (!trace_del2) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+        backtrace_wavefront_trace_deletion2_extend_offset(affine_wavefronts,gap_extend2_score,k,offset);
+    const awf_offset_t del2_open = (!trace_del2) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+        backtrace_wavefront_trace_deletion_open_offset(affine_wavefronts,gap_open2_score,k,offset);
+    const awf_offset_t ins2_ext = (!trace_ins2) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+        backtrace_wavefront_trace_insertion2_extend_offset(affine_wavefronts,gap_extend2_score,k,offset);
+    const awf_offset_t ins2_open = (!trace_ins2) ? AFFINE_WAVEFRONT_OFFSET_NULL:
+        backtrace_wavefront_trace_insertion_open_offset(affine_wavefronts,gap_open2_score,k,offset);
     const awf_offset_t misms = (backtrace_type != backtrace_wavefront_M) ? AFFINE_WAVEFRONT_OFFSET_NULL:
         backtrace_wavefront_trace_mismatch_offset(affine_wavefronts,mismatch_score,k,offset);
     // Compute maximum offset
-    const awf_offset_t max_del = MAX(del_ext,del_open);
-    const awf_offset_t max_ins = MAX(ins_ext,ins_open);
+    const awf_offset_t max_del = MAX(MAX(del_ext,del_open),MAX(del2_ext,del2_open));
+    const awf_offset_t max_ins = MAX(MAX(ins_ext,ins_open),MAX(ins2_ext,ins2_open));
     const awf_offset_t max_all = MAX(misms,MAX(max_ins,max_del));
     // Traceback Matches
     if (backtrace_type == backtrace_wavefront_M) {
       const int num_matches = offset - max_all;
       affine_wavefronts_backtrace_matches__check(affine_wavefronts,
-          pattern,text,k,offset,valid_location,num_matches,cigar);
+          pattern,text,k,offset,valid_location,num_matches);
       offset = max_all;
       // Update coordinates
       v = AFFINE_WAVEFRONT_V(k,offset);
@@ -247,21 +317,35 @@ void affine_wavefronts_backtrace(
     // Traceback Operation
     if (max_all == del_ext) {
       // Add Deletion
-      if (valid_location) cigar->operations[(cigar->begin_offset)--] = 'D';
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',1);
       // Update state
       score = gap_extend_score;
       ++k;
       backtrace_type = backtrace_wavefront_D;
     } else if (max_all == del_open) {
       // Add Deletion
-      if (valid_location) cigar->operations[(cigar->begin_offset)--] = 'D';
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',1);
       // Update state
       score = gap_open_score;
       ++k;
       backtrace_type = backtrace_wavefront_M;
+    } else if (max_all == del2_ext) {
+      // Add Deletion
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',1);
+      // Update state
+      score = gap_extend2_score;
+      ++k;
+      backtrace_type = backtrace_wavefront_D2;
+    } else if (max_all == del2_open) {
+      // Add Deletion
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',1);
+      // Update state
+      score = gap_open2_score;
+      ++k;
+      backtrace_type = backtrace_wavefront_M;
     } else if (max_all == ins_ext) {
       // Add Insertion
-      if (valid_location) cigar->operations[(cigar->begin_offset)--] = 'I';
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',1);
       // Update state
       score = gap_extend_score;
       --k;
@@ -269,15 +353,31 @@ void affine_wavefronts_backtrace(
       backtrace_type = backtrace_wavefront_I;
     } else if (max_all == ins_open) {
       // Add Insertion
-      if (valid_location) cigar->operations[(cigar->begin_offset)--] = 'I';
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',1);
       // Update state
       score = gap_open_score;
       --k;
       --offset;
       backtrace_type = backtrace_wavefront_M;
+    } else if (max_all == ins2_ext) {
+      // Add Insertion
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',1);
+      // Update state
+      score = gap_extend2_score;
+      --k;
+      --offset;
+      backtrace_type = backtrace_wavefront_I2;
+    } else if (max_all == ins2_open) {
+      // Add Insertion
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',1);
+      // Update state
+      score = gap_open2_score;
+      --k;
+      --offset;
+      backtrace_type = backtrace_wavefront_M;
     } else if (max_all == misms) {
       // Add Mismatch
-      if (valid_location) cigar->operations[(cigar->begin_offset)--] = 'X';
+      if (valid_location) affine_wavefronts_backtrace_prepend(affine_wavefronts,'X',1);
       // Update state
       score = mismatch_score;
       --offset;
@@ -293,13 +393,12 @@ void affine_wavefronts_backtrace(
   if (score == 0) {
     // Account for last stroke of matches
     affine_wavefronts_backtrace_matches__check(affine_wavefronts,
-        pattern,text,k,offset,valid_location,offset,cigar);
+        pattern,text,k,offset,valid_location,offset);
   } else {
     // Account for last stroke of insertion/deletion
-    while (v > 0) {cigar->operations[(cigar->begin_offset)--] = 'D'; --v;};
-    while (h > 0) {cigar->operations[(cigar->begin_offset)--] = 'I'; --h;};
+    if (v > 0) affine_wavefronts_backtrace_prepend(affine_wavefronts,'D',v);
+    if (h > 0) affine_wavefronts_backtrace_prepend(affine_wavefronts,'I',h);
   }
-  ++(cigar->begin_offset); // Set CIGAR length
   // STATS
   WAVEFRONT_STATS_TIMER_STOP(affine_wavefronts,wf_time_backtrace);
 }
@@ -50,17 +50,31 @@ typedef struct {
 typedef enum {
   backtrace_wavefront_M = 0,
   backtrace_wavefront_I = 1,
-  backtrace_wavefront_D = 2
+  backtrace_wavefront_D = 2,
+  backtrace_wavefront_I2 = 3,
+  backtrace_wavefront_D2 = 4
 } backtrace_wavefront_type;
 
+/*
+ * Backtrace CIGAR (prepend operations to the CIGAR/RLE-CIGAR being traced)
+ */
+void affine_wavefronts_backtrace_prepend(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char operation,
+    const int length);
+void affine_wavefronts_backtrace_prepend_operations(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const operations,
+    const int num_operations);
+
 /*
  * Backtrace
  */
 void affine_wavefronts_backtrace(
     affine_wavefronts_t* const affine_wavefronts,
-    char* const pattern,
+    const char* const pattern,
     const int pattern_length,
-    char* const text,
+    const char* const text,
     const int text_length,
     const int alignment_score);
 
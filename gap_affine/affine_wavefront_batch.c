@@ -0,0 +1,194 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA batch alignment (many independent pairs)
+ */
+
+#include "gap_affine/affine_wavefront_batch.h"
+#include "gap_affine/affine_wavefront_align.h"
+
+/*
+ * Setup
+ */
+affine_wavefronts_batch_t* affine_wavefronts_batch_new(
+    affine_penalties_t* const penalties,
+    affine2p_penalties_t* const penalties_2p,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  affine_wavefronts_batch_t* const affine_wavefronts_batch =
+      mm_allocator_alloc(mm_allocator,affine_wavefronts_batch_t);
+  // Penalties (single-piece or two-piece gap-affine; the unused ones are cleared)
+  memset(&affine_wavefronts_batch->penalties,0,sizeof(affine_penalties_t));
+  memset(&affine_wavefronts_batch->penalties_2p,0,sizeof(affine2p_penalties_t));
+  if (penalties_2p != NULL) {
+    affine_wavefronts_batch->penalties_2p = *penalties_2p;
+    affine_wavefronts_batch->gap_affine_2p = true;
+  } else {
+    affine_wavefronts_batch->penalties = *penalties;
+    affine_wavefronts_batch->gap_affine_2p = false;
+  }
+  // Aligners (allocated on demand)
+  memset(affine_wavefronts_batch->aligners,0,sizeof(affine_wavefronts_batch->aligners));
+  // Scheduling
+  affine_wavefronts_batch->order = NULL;
+  affine_wavefronts_batch->order_allocated = 0;
+  // MM
+  affine_wavefronts_batch->mm_allocator = mm_allocator;
+  // Return
+  return affine_wavefronts_batch;
+}
+void affine_wavefronts_batch_delete(
+    affine_wavefronts_batch_t* const affine_wavefronts_batch) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts_batch->mm_allocator;
+  // Free aligners
+  int i;
+  for (i=0;i<AFFINE_WAVEFRONTS_BATCH_CLASSES;++i) {
+    if (affine_wavefronts_batch->aligners[i] != NULL) {
+      affine_wavefronts_delete(affine_wavefronts_batch->aligners[i]);
+    }
+  }
+  // Free scheduling
+  if (affine_wavefronts_batch->order != NULL) {
+    mm_allocator_free(mm_allocator,affine_wavefronts_batch->order);
+  }
+  // Free handler
+  mm_allocator_free(mm_allocator,affine_wavefronts_batch);
+}
+/*
+ * Scheduling
+ */
+int affine_wavefronts_batch_length_class(
+    affine_wavefronts_pair_t* const pair) {
+  // Smallest power of two covering both sequences
+  const uint64_t length = MAX(pair->pattern_length,pair->text_length);
+  return (length <= 1) ? 0 : 64 - __builtin_clzl(length-1);
+}
+void affine_wavefronts_batch_schedule(
+    affine_wavefronts_batch_t* const affine_wavefronts_batch,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs) {
+  // Allocate order (grow only)
+  if (num_pairs > affine_wavefronts_batch->order_allocated) {
+    mm_allocator_t* const mm_allocator = affine_wavefronts_batch->mm_allocator;
+    if (affine_wavefronts_batch->order != NULL) {
+      mm_allocator_free(mm_allocator,affine_wavefronts_batch->order);
+    }
+    affine_wavefronts_batch->order = mm_allocator_calloc(mm_allocator,num_pairs,int,false);
+    affine_wavefronts_batch->order_allocated = num_pairs;
+  }
+  // Count pairs per class
+  int class_begin[AFFINE_WAVEFRONTS_BATCH_CLASSES+1];
+  memset(class_begin,0,sizeof(class_begin));
+  int i;
+  for (i=0;i<num_pairs;++i) {
+    ++class_begin[affine_wavefronts_batch_length_class(pairs+i)+1];
+  }
+  for (i=0;i<AFFINE_WAVEFRONTS_BATCH_CLASSES;++i) {
+    class_begin[i+1] += class_begin[i];
+  }
+  // Sort pairs by class (stable)
+  int* const order = affine_wavefronts_batch->order;
+  for (i=0;i<num_pairs;++i) {
+    order[class_begin[affine_wavefronts_batch_length_class(pairs+i)]++] = i;
+  }
+}
+affine_wavefronts_t* affine_wavefronts_batch_get_aligner(
+    affine_wavefronts_batch_t* const affine_wavefronts_batch,
+    const int length_class) {
+  // Allocate the class aligner (sized for the longest pair of the class)
+  affine_wavefronts_t* affine_wavefronts = affine_wavefronts_batch->aligners[length_class];
+  if (affine_wavefronts == NULL) {
+    const int max_length = MIN(1ul << length_class,INT_MAX);
+    if (affine_wavefronts_batch->gap_affine_2p) {
+      affine_wavefronts = affine_wavefronts_new_complete_2p(
+          max_length,max_length,&affine_wavefronts_batch->penalties_2p,
+          NULL,affine_wavefronts_batch->mm_allocator);
+    } else {
+      affine_wavefronts = affine_wavefronts_new_complete(
+          max_length,max_length,&affine_wavefronts_batch->penalties,
+          NULL,affine_wavefronts_batch->mm_allocator);
+    }
+    affine_wavefronts_batch->aligners[length_class] = affine_wavefronts;
+  }
+  return affine_wavefronts;
+}
+/*
+ * Batch alignment
+ */
+uint64_t affine_wavefronts_batch_arena_size(
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs) {
+  uint64_t arena_size = 0;
+  int i;
+  for (i=0;i<num_pairs;++i) {
+    arena_size += pairs[i].pattern_length + pairs[i].text_length;
+  }
+  return arena_size;
+}
+void affine_wavefronts_align_batch(
+    affine_wavefronts_batch_t* const affine_wavefronts_batch,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    affine_wavefronts_result_t* const results,
+    char* const results_arena) {
+  // Assign CIGAR buffers (in input order)
+  char* cigar_buffer = results_arena;
+  int i;
+  for (i=0;i<num_pairs;++i) {
+    results[i].cigar = cigar_buffer;
+    cigar_buffer += pairs[i].pattern_length + pairs[i].text_length;
+  }
+  // Schedule by length class
+  affine_wavefronts_batch_schedule(affine_wavefronts_batch,pairs,num_pairs);
+  // Align
+  const int* const order = affine_wavefronts_batch->order;
+  for (i=0;i<num_pairs;++i) {
+    affine_wavefronts_pair_t* const pair = pairs + order[i];
+    affine_wavefronts_result_t* const result = results + order[i];
+    // Fetch class aligner
+    affine_wavefronts_t* const affine_wavefronts = affine_wavefronts_batch_get_aligner(
+        affine_wavefronts_batch,affine_wavefronts_batch_length_class(pair));
+    affine_wavefronts_resize(affine_wavefronts,pair->pattern_length,pair->text_length);
+    // Align
+    result->status = affine_wavefronts_align(affine_wavefronts,
+        pair->pattern,pair->pattern_length,pair->text,pair->text_length);
+    if (result->status != affine_wavefronts_status_successful) {
+      result->score = 0;
+      result->cigar_length = 0;
+      continue;
+    }
+    // Store result
+    edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
+    result->cigar_length = edit_cigar->end_offset - edit_cigar->begin_offset;
+    memcpy(result->cigar,edit_cigar->operations+edit_cigar->begin_offset,result->cigar_length);
+    result->score = (affine_wavefronts_batch->gap_affine_2p) ?
+        edit_cigar_score_gap_affine2p(edit_cigar,&affine_wavefronts_batch->penalties_2p) :
+        edit_cigar_score_gap_affine(edit_cigar,&affine_wavefronts_batch->penalties);
+  }
+}
@@ -0,0 +1,105 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA batch alignment (many independent pairs)
+ */
+
+#ifndef AFFINE_WAVEFRONT_BATCH_H_
+#define AFFINE_WAVEFRONT_BATCH_H_
+
+#include "utils/commons.h"
+#include "gap_affine/affine_wavefront.h"
+
+/*
+ * Constants
+ */
+#define AFFINE_WAVEFRONTS_BATCH_CLASSES 32 // Length classes (ceil(log2) of the longest sequence)
+
+/*
+ * Batch pairs & results
+ */
+typedef struct {
+  const char* pattern;               // Pattern
+  int pattern_length;                // Pattern length
+  const char* text;                  // Text
+  int text_length;                   // Text length
+} affine_wavefronts_pair_t;
+typedef struct {
+  affine_wavefronts_status_t status; // Alignment status
+  int score;                         // Alignment score (as given by edit_cigar_score_gap_affine*)
+  char* cigar;                       // CIGAR operations (within the results arena; not NULL-terminated)
+  int cigar_length;                  // CIGAR length (0 if not aligned)
+} affine_wavefronts_result_t;
+
+/*
+ * Batch aligner
+ *   Pairs are scheduled by length class (power of two of the longest
+ *   sequence) so each class reuses its own aligner, already sized for
+ *   it. Aligners persist across batches.
+ */
+typedef struct {
+  // Penalties
+  affine_penalties_t penalties;      // Gap-affine penalties
+  affine2p_penalties_t penalties_2p; // Two-piece gap-affine penalties
+  bool gap_affine_2p;                // Use two-piece gap-affine
+  // Aligners
+  affine_wavefronts_t* aligners[AFFINE_WAVEFRONTS_BATCH_CLASSES]; // Aligner per length class (or NULL)
+  // Scheduling
+  int* order;                        // Pairs sorted by length class
+  int order_allocated;               // Pairs allocated
+  // MM
+  mm_allocator_t* mm_allocator;      // MM-Allocator
+} affine_wavefronts_batch_t;
+
+/*
+ * Setup
+ */
+affine_wavefronts_batch_t* affine_wavefronts_batch_new(
+    affine_penalties_t* const penalties,
+    affine2p_penalties_t* const penalties_2p,
+    mm_allocator_t* const mm_allocator);
+void affine_wavefronts_batch_delete(
+    affine_wavefronts_batch_t* const affine_wavefronts_batch);
+
+/*
+ * Batch alignment
+ *   Aligns all the pairs, writing each result into @results (same order
+ *   as @pairs). CIGARs are written into @results_arena, which must hold
+ *   affine_wavefronts_batch_arena_size() bytes (pattern plus text lengths).
+ */
+uint64_t affine_wavefronts_batch_arena_size(
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs);
+void affine_wavefronts_align_batch(
+    affine_wavefronts_batch_t* const affine_wavefronts_batch,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    affine_wavefronts_result_t* const results,
+    char* const results_arena);
+
+#endif /* AFFINE_WAVEFRONT_BATCH_H_ */
@@ -128,11 +128,13 @@ void affine_wavefronts_print_wavefronts_block(
       affine_wavefront_t* const mwavefront = affine_wavefronts->mwavefronts[s];
       affine_wavefront_t* const iwavefront = affine_wavefronts->iwavefronts[s];
       affine_wavefront_t* const dwavefront = affine_wavefronts->dwavefronts[s];
+      affine_wavefront_t* const i2wavefront = (affine_wavefronts->i2wavefronts!=NULL) ? affine_wavefronts->i2wavefronts[s] : NULL;
+      affine_wavefront_t* const d2wavefront = (affine_wavefronts->d2wavefronts!=NULL) ? affine_wavefronts->d2wavefronts[s] : NULL;
       AFFINE_WAVEFRONTS_PRINT_ELEMENT(mwavefront,k);
       AFFINE_WAVEFRONTS_PRINT_ELEMENT(iwavefront,k);
-      fprintf(stream,"    ");
+      AFFINE_WAVEFRONTS_PRINT_ELEMENT(i2wavefront,k);
       AFFINE_WAVEFRONTS_PRINT_ELEMENT(dwavefront,k);
-      fprintf(stream,"    ");
+      AFFINE_WAVEFRONTS_PRINT_ELEMENT(d2wavefront,k);
     }
     fprintf(stream,"|\n");
   }
@@ -111,6 +111,21 @@ void affine_wavefronts_reduce_wavefronts(
     if (mwavefront->hi < dwavefront->hi) dwavefront->hi = mwavefront->hi;
     if (dwavefront->lo > dwavefront->hi) dwavefront->null = true;
   }
+  // Reduce two-piece wavefronts
+  if (affine_wavefronts->penalties.gap_affine_2p) {
+    affine_wavefront_t* const i2wavefront = affine_wavefronts->i2wavefronts[score];
+    if (i2wavefront!=NULL) {
+      if (mwavefront->lo > i2wavefront->lo) i2wavefront->lo = mwavefront->lo;
+      if (mwavefront->hi < i2wavefront->hi) i2wavefront->hi = mwavefront->hi;
+      if (i2wavefront->lo > i2wavefront->hi) i2wavefront->null = true;
+    }
+    affine_wavefront_t* const d2wavefront = affine_wavefronts->d2wavefronts[score];
+    if (d2wavefront!=NULL) {
+      if (mwavefront->lo > d2wavefront->lo) d2wavefront->lo = mwavefront->lo;
+      if (mwavefront->hi < d2wavefront->hi) d2wavefront->hi = mwavefront->hi;
+      if (d2wavefront->lo > d2wavefront->hi) d2wavefront->null = true;
+    }
+  }
 }
 /*
  * Wavefront offset extension comparing characters
@@ -188,6 +203,241 @@ void affine_wavefronts_extend_mwavefront_compute_packed(
   affine_wavefronts_extend_mwavefront_epiloge(
       affine_wavefronts,score,pattern_length,text_length);
 }
+/*
+ * Wavefront offset extension with configurable matching (SWAR masks)
+ *   Each 64-bit block is compared as 8 independent bytes. Bytes that only
+ *   differ in case (both letters) are cleared from the XOR when case-insensitive,
+ *   and bytes holding N/n are either cleared (N matches any) or forced to
+ *   mismatch (N matches none). Extension is clamped to the sequence ends as
+ *   the relaxed comparison can match against the padding.
+ */
+#define SWAR_LOWER_BYTES(v) \
+  ((((v) & SWAR_LOW7) + 0x1F*SWAR_ONES) & ~(((v) & SWAR_LOW7) + 0x05*SWAR_ONES) & ~(v) & SWAR_HIGH) /* 0x80 on ['a','z'] */
+uint64_t affine_wavefronts_extend_block_compare(
+    const uint64_t pattern_block,
+    const uint64_t text_block,
+    const uint64_t case_mask,
+    const uint64_t n_any_mask,
+    const uint64_t n_none_mask) {
+  uint64_t cmp = pattern_block ^ text_block;
+  // Fold case (only bytes where both characters are letters)
+  const uint64_t pattern_folded = pattern_block | (0x20*SWAR_ONES);
+  const uint64_t text_folded = text_block | (0x20*SWAR_ONES);
+  const uint64_t letters = SWAR_LOWER_BYTES(pattern_folded) & SWAR_LOWER_BYTES(text_folded);
+  cmp &= ~((letters >> 2) & case_mask);
+  // Ambiguous bases (N/n on either sequence)
+  const uint64_t n_bytes =
+      SWAR_ZERO_BYTES(pattern_folded ^ ('n'*SWAR_ONES)) |
+      SWAR_ZERO_BYTES(text_folded ^ ('n'*SWAR_ONES));
+  const uint64_t n_mask = (n_bytes >> 7) * 0xFF;
+  cmp &= ~(n_mask & n_any_mask);
+  cmp |= (n_mask & n_none_mask);
+  return cmp;
+}
+void affine_wavefronts_extend_mwavefront_compute_packed_masked(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    const int score) {
+  // Fetch m-wavefront
+  affine_wavefront_t* const mwavefront = affine_wavefronts->mwavefronts[score];
+  if (mwavefront==NULL) return;
+  // Matching masks
+  const affine_wavefronts_match_t* const match = &affine_wavefronts->match;
+  const uint64_t case_mask = (match->case_insensitive) ? UINT64_MAX : 0ull;
+  const uint64_t n_any_mask = (match->n==wavefronts_match_n_any) ? UINT64_MAX : 0ull;
+  const uint64_t n_none_mask = (match->n==wavefronts_match_n_none) ? UINT64_MAX : 0ull;
+  // Extend diagonally each wavefront point
+  awf_offset_t* const offsets = mwavefront->offsets;
+  int k;
+  for (k=mwavefront->lo;k<=mwavefront->hi;++k) {
+    // Fetch offset & positions
+    const awf_offset_t offset = offsets[k];
+    const uint32_t h = AFFINE_WAVEFRONT_H(k,offset); // Make unsigned to avoid checking negative
+    if (h >= text_length) continue;
+    const uint32_t v = AFFINE_WAVEFRONT_V(k,offset); // Make unsigned to avoid checking negative
+    if (v >= pattern_length) continue;
+    // Fetch pattern/text blocks
+    uint64_t* pattern_blocks = (uint64_t*)(pattern+v);
+    uint64_t* text_blocks = (uint64_t*)(text+h);
+    // Compare 64-bits blocks
+    uint64_t cmp = affine_wavefronts_extend_block_compare(
+        *pattern_blocks,*text_blocks,case_mask,n_any_mask,n_none_mask);
+    while (__builtin_expect(!cmp,0)) {
+      // Increment offset (full block)
+      offsets[k] += 8;
+      // Next blocks
+      ++pattern_blocks;
+      ++text_blocks;
+      // Compare
+      cmp = affine_wavefronts_extend_block_compare(
+          *pattern_blocks,*text_blocks,case_mask,n_any_mask,n_none_mask);
+      WAVEFRONT_STATS_COUNTER_ADD(affine_wavefronts,wf_extend_inner_loop,1); // STATS
+    }
+    // Count equal characters
+    const int equal_right_bits = __builtin_ctzl(cmp);
+    const int equal_chars = DIV_FLOOR(equal_right_bits,8);
+    // Increment offset (bounded to the end of both sequences)
+    const awf_offset_t max_offset = MIN(text_length,pattern_length+k);
+    offsets[k] = MIN(offsets[k]+equal_chars,max_offset);
+  }
+  // DEBUG
+  affine_wavefronts_extend_mwavefront_epiloge(
+      affine_wavefronts,score,pattern_length,text_length);
+}
+/*
+ * Common prefix/suffix (trimming before the wavefront setup)
+ *   Sequences are not padded here, so the last partial block is copied
+ *   into a zeroed word and the bytes beyond the sequence are forced to
+ *   mismatch.
+ */
+uint64_t affine_wavefronts_extend_affix_compare(
+    const affine_wavefronts_match_t* const match,
+    const uint64_t pattern_block,
+    const uint64_t text_block) {
+  if (!match->case_insensitive && match->n == wavefronts_match_n_exact) {
+    return pattern_block ^ text_block;
+  }
+  return affine_wavefronts_extend_block_compare(
+      pattern_block,text_block,
+      (match->case_insensitive) ? UINT64_MAX : 0ull,
+      (match->n==wavefronts_match_n_any) ? UINT64_MAX : 0ull,
+      (match->n==wavefronts_match_n_none) ? UINT64_MAX : 0ull);
+}
+int affine_wavefronts_extend_common_prefix(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const char* const text,
+    const int length) {
+  // Parameters
+  const affine_wavefronts_match_t* const match = &affine_wavefronts->match;
+  // Compare 64-bits blocks
+  int offset = 0;
+  while (offset+8 <= length) {
+    const uint64_t cmp = affine_wavefronts_extend_affix_compare(match,
+        *((uint64_t*)(pattern+offset)),*((uint64_t*)(text+offset)));
+    if (cmp) return offset + DIV_FLOOR(__builtin_ctzl(cmp),8);
+    offset += 8;
+  }
+  // Compare last partial block
+  const int remaining = length - offset;
+  if (remaining == 0) return length;
+  uint64_t pattern_block, text_block;
+  if (remaining + affine_wavefronts->zero_copy_slack >= 8) {
+    pattern_block = *((uint64_t*)(pattern+offset));
+    text_block = *((uint64_t*)(text+offset));
+  } else {
+    pattern_block = 0; text_block = 0;
+    memcpy(&pattern_block,pattern+offset,remaining);
+    memcpy(&text_block,text+offset,remaining);
+  }
+  uint64_t cmp = affine_wavefronts_extend_affix_compare(match,pattern_block,text_block);
+  cmp |= UINT64_MAX << (8*remaining); // Sentinel (beyond the sequence)
+  return offset + DIV_FLOOR(__builtin_ctzl(cmp),8);
+}
+int affine_wavefronts_extend_common_suffix(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern_end,
+    const char* const text_end,
+    const int length) {
+  // Parameters
+  const affine_wavefronts_match_t* const match = &affine_wavefronts->match;
+  // Compare 64-bits blocks (backwards)
+  int offset = 0;
+  while (offset+8 <= length) {
+    const uint64_t cmp = affine_wavefronts_extend_affix_compare(match,
+        *((uint64_t*)(pattern_end-offset-8)),*((uint64_t*)(text_end-offset-8)));
+    if (cmp) return offset + DIV_FLOOR(__builtin_clzl(cmp),8);
+    offset += 8;
+  }
+  // Compare last partial block (placed at the most significant bytes)
+  const int remaining = length - offset;
+  if (remaining == 0) return length;
+  uint64_t pattern_block = 0, text_block = 0;
+  memcpy((char*)&pattern_block+(8-remaining),pattern_end-offset-remaining,remaining);
+  memcpy((char*)&text_block+(8-remaining),text_end-offset-remaining,remaining);
+  uint64_t cmp = affine_wavefronts_extend_affix_compare(match,pattern_block,text_block);
+  cmp |= UINT64_MAX >> (8*remaining); // Sentinel (beyond the sequence)
+  return offset + DIV_FLOOR(__builtin_clzl(cmp),8);
+}
+/*
+ * Wavefront offset extension on unpadded sequences (zero-copy)
+ */
+void affine_wavefronts_extend_mwavefront_compute_bounded(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    const int score) {
+  // Fetch m-wavefront
+  affine_wavefront_t* const mwavefront = affine_wavefronts->mwavefronts[score];
+  if (mwavefront==NULL) return;
+  // Extend diagonally each wavefront point
+  awf_offset_t* const offsets = mwavefront->offsets;
+  int k;
+  for (k=mwavefront->lo;k<=mwavefront->hi;++k) {
+    // Fetch offset & positions
+    const awf_offset_t offset = offsets[k];
+    const uint32_t h = AFFINE_WAVEFRONT_H(k,offset); // Make unsigned to avoid checking negative
+    if (h >= text_length) continue;
+    const uint32_t v = AFFINE_WAVEFRONT_V(k,offset); // Make unsigned to avoid checking negative
+    if (v >= pattern_length) continue;
+    // Extend up to the end of either sequence
+    const int max_chars = MIN(pattern_length-v,text_length-h);
+    offsets[k] += affine_wavefronts_extend_common_prefix(
+        affine_wavefronts,pattern+v,text+h,max_chars);
+  }
+  // DEBUG
+  affine_wavefronts_extend_mwavefront_epiloge(
+      affine_wavefronts,score,pattern_length,text_length);
+}
+/*
+ * Gap-free alignment (equal-length sequences)
+ *   Compares 64-bit blocks, counting mismatching bytes with a popcount,
+ *   and writes the M/X operations. Returns the number of mismatches or
+ *   -1 as soon as there are more than @max_mismatches.
+ */
+int affine_wavefronts_extend_gap_free(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const char* const text,
+    const int length,
+    const int max_mismatches,
+    char* const operations) {
+  // Parameters
+  const affine_wavefronts_match_t* const match = &affine_wavefronts->match;
+  int offset = 0, mismatches = 0, i;
+  while (offset < length) {
+    // Fetch blocks (zero-filling the last partial block)
+    const int block_length = MIN(8,length-offset);
+    uint64_t pattern_block, text_block;
+    if (block_length == 8) {
+      pattern_block = *((uint64_t*)(pattern+offset));
+      text_block = *((uint64_t*)(text+offset));
+    } else {
+      pattern_block = 0; text_block = 0;
+      memcpy(&pattern_block,pattern+offset,block_length);
+      memcpy(&text_block,text+offset,block_length);
+    }
+    // Compare & count mismatching bytes
+    const uint64_t cmp = affine_wavefronts_extend_affix_compare(match,pattern_block,text_block);
+    if (cmp == 0) {
+      memset(operations+offset,'M',block_length);
+    } else {
+      const uint64_t mismatch_bytes = ~SWAR_ZERO_BYTES(cmp) & SWAR_HIGH;
+      mismatches += __builtin_popcountl(mismatch_bytes);
+      if (mismatches > max_mismatches) return -1;
+      for (i=0;i<block_length;++i) {
+        operations[offset+i] = ((mismatch_bytes >> (8*i)) & 0x80) ? 'X' : 'M';
+      }
+    }
+    offset += block_length;
+  }
+  return mismatches;
+}
 /*
  * Gap-Affine Wavefront exact extension
  */
@@ -199,9 +449,20 @@ void affine_wavefronts_extend_wavefront_packed(
     const int text_length,
     const int score) {
   // Extend wavefront
-  affine_wavefronts_extend_mwavefront_compute_packed(
-      affine_wavefronts,pattern,pattern_length,
-      text,text_length,score);
+  if (affine_wavefronts->zero_copy) {
+    affine_wavefronts_extend_mwavefront_compute_bounded(
+        affine_wavefronts,pattern,pattern_length,
+        text,text_length,score);
+  } else if (!affine_wavefronts->match.case_insensitive &&
+      affine_wavefronts->match.n == wavefronts_match_n_exact) {
+    affine_wavefronts_extend_mwavefront_compute_packed(
+        affine_wavefronts,pattern,pattern_length,
+        text,text_length,score);
+  } else {
+    affine_wavefronts_extend_mwavefront_compute_packed_masked(
+        affine_wavefronts,pattern,pattern_length,
+        text,text_length,score);
+  }
   // Reduce wavefront dynamically
   if (affine_wavefronts->reduction.reduction_strategy == wavefronts_reduction_dynamic) {
     affine_wavefronts_reduce_wavefronts(
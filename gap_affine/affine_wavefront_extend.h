@@ -50,4 +50,29 @@ void affine_wavefronts_extend_wavefront_packed(
     const int text_length,
     const int score);
 
+/*
+ * Common prefix/suffix (unpadded sequences)
+ */
+int affine_wavefronts_extend_common_prefix(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const char* const text,
+    const int length);
+int affine_wavefronts_extend_common_suffix(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern_end,
+    const char* const text_end,
+    const int length);
+
+/*
+ * Gap-free alignment (equal-length sequences)
+ */
+int affine_wavefronts_extend_gap_free(
+    affine_wavefronts_t* const affine_wavefronts,
+    const char* const pattern,
+    const char* const text,
+    const int length,
+    const int max_mismatches,
+    char* const operations);
+
 #endif /* AFFINE_WAVEFRONT_EXTEND_H_ */
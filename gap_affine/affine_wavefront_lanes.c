@@ -0,0 +1,410 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA lane-parallel engine (many pairs aligned in lockstep)
+ */
+
+#include "gap_affine/affine_wavefront_lanes.h"
+#include "gap_affine/affine_wavefront_penalties.h"
+
+/*
+ * Setup
+ */
+void affine_wavefronts_lanes_allocate_wavefronts(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    const int max_pattern_length,
+    const int max_text_length) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts_lanes->mm_allocator;
+  const int num_diagonals = max_pattern_length + max_text_length + 3; // Diagonals [-(plen+1),tlen+1]
+  const uint64_t component_offsets = (uint64_t)num_diagonals*AFFINE_WAVEFRONT_LANES;
+  const uint64_t base_shift = (uint64_t)(max_pattern_length+1)*AFFINE_WAVEFRONT_LANES;
+  // Allocate wavefronts (circular buffer plus null wavefront)
+  int i;
+  for (i=0;i<=affine_wavefronts_lanes->num_wavefronts;++i) {
+    affine_lanes_wavefront_t* const wavefront = (i < affine_wavefronts_lanes->num_wavefronts) ?
+        affine_wavefronts_lanes->wavefronts + i : &affine_wavefronts_lanes->wavefront_null;
+    wavefront->offsets_mem = mm_allocator_calloc_aligned(mm_allocator,
+        3*component_offsets,awf_offset_t,false,AFFINE_WAVEFRONT_LANES_ALIGNMENT);
+    wavefront->moffsets = wavefront->offsets_mem + base_shift;
+    wavefront->ioffsets = wavefront->offsets_mem + component_offsets + base_shift;
+    wavefront->doffsets = wavefront->offsets_mem + 2*component_offsets + base_shift;
+  }
+  affine_wavefronts_lanes->max_pattern_length = max_pattern_length;
+  affine_wavefronts_lanes->max_text_length = max_text_length;
+}
+void affine_wavefronts_lanes_free_wavefronts(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts_lanes->mm_allocator;
+  // Free wavefronts (circular buffer plus null wavefront)
+  int i;
+  for (i=0;i<affine_wavefronts_lanes->num_wavefronts;++i) {
+    mm_allocator_free(mm_allocator,affine_wavefronts_lanes->wavefronts[i].offsets_mem);
+  }
+  mm_allocator_free(mm_allocator,affine_wavefronts_lanes->wavefront_null.offsets_mem);
+}
+affine_wavefronts_lanes_t* affine_wavefronts_lanes_new(
+    affine_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  affine_wavefronts_lanes_t* const affine_wavefronts_lanes =
+      mm_allocator_alloc(mm_allocator,affine_wavefronts_lanes_t);
+  affine_wavefronts_lanes->mm_allocator = mm_allocator;
+  // Penalties (match forced to zero)
+  affine_wavefronts_penalties_t wavefronts_penalties;
+  affine_wavefronts_penalties_init(&wavefronts_penalties,penalties,wavefronts_penalties_force_zero_match);
+  affine_wavefronts_lanes->penalties = wavefronts_penalties.wavefront_penalties;
+  // Wavefronts (circular buffer spanning the furthest score dependency)
+  const affine_penalties_t* const wavefront_penalties = &affine_wavefronts_lanes->penalties;
+  affine_wavefronts_lanes->num_wavefronts = 1 + MAX(wavefront_penalties->mismatch,
+      wavefront_penalties->gap_opening+wavefront_penalties->gap_extension);
+  affine_wavefronts_lanes->wavefronts = mm_allocator_calloc(mm_allocator,
+      affine_wavefronts_lanes->num_wavefronts,affine_lanes_wavefront_t,false);
+  affine_wavefronts_lanes_allocate_wavefronts(affine_wavefronts_lanes,0,0);
+  // Return
+  return affine_wavefronts_lanes;
+}
+void affine_wavefronts_lanes_resize(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    const int max_pattern_length,
+    const int max_text_length) {
+  // Grow only
+  if (max_pattern_length <= affine_wavefronts_lanes->max_pattern_length &&
+      max_text_length <= affine_wavefronts_lanes->max_text_length) return;
+  // Reallocate
+  affine_wavefronts_lanes_free_wavefronts(affine_wavefronts_lanes);
+  affine_wavefronts_lanes_allocate_wavefronts(affine_wavefronts_lanes,
+      MAX(max_pattern_length,affine_wavefronts_lanes->max_pattern_length),
+      MAX(max_text_length,affine_wavefronts_lanes->max_text_length));
+}
+void affine_wavefronts_lanes_delete(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = affine_wavefronts_lanes->mm_allocator;
+  // Free
+  affine_wavefronts_lanes_free_wavefronts(affine_wavefronts_lanes);
+  mm_allocator_free(mm_allocator,affine_wavefronts_lanes->wavefronts);
+  mm_allocator_free(mm_allocator,affine_wavefronts_lanes);
+}
+/*
+ * Wavefront accessors
+ */
+affine_lanes_wavefront_t* affine_wavefronts_lanes_get_wavefront(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    const int score) {
+  return (score < 0) ?
+      &affine_wavefronts_lanes->wavefront_null :
+      affine_wavefronts_lanes->wavefronts + (score % affine_wavefronts_lanes->num_wavefronts);
+}
+void affine_wavefronts_lanes_clear_wavefront(
+    affine_lanes_wavefront_t* const wavefront) {
+  wavefront->null = true;
+  wavefront->init_lo = 0;
+  wavefront->init_hi = -1;
+}
+void affine_wavefronts_lanes_null_diagonals(
+    affine_lanes_wavefront_t* const wavefront,
+    const int lo,
+    const int hi) {
+  const int begin = lo*AFFINE_WAVEFRONT_LANES;
+  const int end = (hi+1)*AFFINE_WAVEFRONT_LANES;
+  int i;
+  for (i=begin;i<end;++i) {
+    wavefront->moffsets[i] = AFFINE_WAVEFRONT_OFFSET_NULL;
+    wavefront->ioffsets[i] = AFFINE_WAVEFRONT_OFFSET_NULL;
+    wavefront->doffsets[i] = AFFINE_WAVEFRONT_OFFSET_NULL;
+  }
+}
+void affine_wavefronts_lanes_init_wavefront(
+    affine_lanes_wavefront_t* const wavefront,
+    const int lo,
+    const int hi) {
+  // Set NULL all diagonals in [lo,hi] not yet initialized (so they read as NULL)
+  if (wavefront->init_lo > wavefront->init_hi) {
+    affine_wavefronts_lanes_null_diagonals(wavefront,lo,hi);
+    wavefront->init_lo = lo;
+    wavefront->init_hi = hi;
+    return;
+  }
+  if (lo < wavefront->init_lo) {
+    affine_wavefronts_lanes_null_diagonals(wavefront,lo,wavefront->init_lo-1);
+    wavefront->init_lo = lo;
+  }
+  if (hi > wavefront->init_hi) {
+    affine_wavefronts_lanes_null_diagonals(wavefront,wavefront->init_hi+1,hi);
+    wavefront->init_hi = hi;
+  }
+}
+/*
+ * Compute wavefront offsets (all lanes)
+ *   Diagonals outside a lane's own [-pattern_length,text_length] range
+ *   are set to NULL afterwards, so each lane behaves as if aligned on its own.
+ */
+void affine_wavefronts_lanes_compute_offsets(
+    affine_lanes_wavefront_t* const in_mwavefront_sub,
+    affine_lanes_wavefront_t* const in_mwavefront_gap,
+    affine_lanes_wavefront_t* const in_iwavefront_ext,
+    affine_lanes_wavefront_t* const in_dwavefront_ext,
+    affine_lanes_wavefront_t* const out_wavefront,
+    const int* const min_k,
+    const int* const max_k) {
+  // Parameters
+  const awf_offset_t* const m_sub_offsets = in_mwavefront_sub->moffsets;
+  const awf_offset_t* const m_gap_offsets = in_mwavefront_gap->moffsets;
+  const awf_offset_t* const i_ext_offsets = in_iwavefront_ext->ioffsets;
+  const awf_offset_t* const d_ext_offsets = in_dwavefront_ext->doffsets;
+  awf_offset_t* const out_moffsets = out_wavefront->moffsets;
+  awf_offset_t* const out_ioffsets = out_wavefront->ioffsets;
+  awf_offset_t* const out_doffsets = out_wavefront->doffsets;
+  const int lo = out_wavefront->lo;
+  const int hi = out_wavefront->hi;
+  // Compute score wavefronts (diagonals [lo,hi] of all lanes are contiguous)
+  const int begin = lo*AFFINE_WAVEFRONT_LANES;
+  const int end = (hi+1)*AFFINE_WAVEFRONT_LANES;
+  int i;
+#if defined(__clang__)
+  #pragma clang loop vectorize(enable)
+#elif defined(__GNUC__) || defined(__GNUG__)
+  #pragma GCC ivdep
+#else
+  #pragma ivdep
+#endif
+  for (i=begin;i<end;++i) {
+    // Update I
+    const awf_offset_t ins_g = m_gap_offsets[i-AFFINE_WAVEFRONT_LANES];
+    const awf_offset_t ins_i = i_ext_offsets[i-AFFINE_WAVEFRONT_LANES];
+    const awf_offset_t ins = MAX(ins_g,ins_i) + 1;
+    out_ioffsets[i] = ins;
+    // Update D
+    const awf_offset_t del_g = m_gap_offsets[i+AFFINE_WAVEFRONT_LANES];
+    const awf_offset_t del_d = d_ext_offsets[i+AFFINE_WAVEFRONT_LANES];
+    const awf_offset_t del = MAX(del_g,del_d);
+    out_doffsets[i] = del;
+    // Update M
+    const awf_offset_t sub = m_sub_offsets[i] + 1;
+    out_moffsets[i] = MAX(del,MAX(sub,ins));
+  }
+  // Mask diagonals out of each lane's range
+  int k, l;
+  for (l=0;l<AFFINE_WAVEFRONT_LANES;++l) {
+    for (k=lo;k<min_k[l];++k) {
+      out_ioffsets[k*AFFINE_WAVEFRONT_LANES+l] = AFFINE_WAVEFRONT_OFFSET_NULL;
+      out_doffsets[k*AFFINE_WAVEFRONT_LANES+l] = AFFINE_WAVEFRONT_OFFSET_NULL;
+      out_moffsets[k*AFFINE_WAVEFRONT_LANES+l] = AFFINE_WAVEFRONT_OFFSET_NULL;
+    }
+    for (k=max_k[l]+1;k<=hi;++k) {
+      out_ioffsets[k*AFFINE_WAVEFRONT_LANES+l] = AFFINE_WAVEFRONT_OFFSET_NULL;
+      out_doffsets[k*AFFINE_WAVEFRONT_LANES+l] = AFFINE_WAVEFRONT_OFFSET_NULL;
+      out_moffsets[k*AFFINE_WAVEFRONT_LANES+l] = AFFINE_WAVEFRONT_OFFSET_NULL;
+    }
+  }
+}
+void affine_wavefronts_lanes_compute_next(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    const int score,
+    const int min_k_all,
+    const int max_k_all,
+    const int* const min_k,
+    const int* const max_k) {
+  // Parameters
+  const affine_penalties_t* const wavefront_penalties = &affine_wavefronts_lanes->penalties;
+  const int mismatch = wavefront_penalties->mismatch;
+  const int gap_open = wavefront_penalties->gap_opening + wavefront_penalties->gap_extension;
+  const int gap_extend = wavefront_penalties->gap_extension;
+  // Fetch wavefronts
+  affine_lanes_wavefront_t* const in_mwavefront_sub =
+      affine_wavefronts_lanes_get_wavefront(affine_wavefronts_lanes,score-mismatch);
+  affine_lanes_wavefront_t* const in_mwavefront_gap =
+      affine_wavefronts_lanes_get_wavefront(affine_wavefronts_lanes,score-gap_open);
+  affine_lanes_wavefront_t* const in_idwavefront_ext =
+      affine_wavefronts_lanes_get_wavefront(affine_wavefronts_lanes,score-gap_extend);
+  affine_lanes_wavefront_t* const out_wavefront =
+      affine_wavefronts_lanes_get_wavefront(affine_wavefronts_lanes,score);
+  affine_wavefronts_lanes_clear_wavefront(out_wavefront);
+  // Set limits (union of the input ranges, plus one)
+  int lo = INT_MAX, hi = INT_MIN;
+  if (!in_mwavefront_sub->null) {
+    lo = MIN(lo,in_mwavefront_sub->lo);
+    hi = MAX(hi,in_mwavefront_sub->hi);
+  }
+  if (!in_mwavefront_gap->null) {
+    lo = MIN(lo,in_mwavefront_gap->lo);
+    hi = MAX(hi,in_mwavefront_gap->hi);
+  }
+  if (!in_idwavefront_ext->null) {
+    lo = MIN(lo,in_idwavefront_ext->lo);
+    hi = MAX(hi,in_idwavefront_ext->hi);
+  }
+  if (lo > hi) return; // All inputs null
+  lo = MAX(lo-1,min_k_all);
+  hi = MIN(hi+1,max_k_all);
+  if (lo > hi) return;
+  // Initialize inputs (neighbouring diagonals read as NULL)
+  affine_wavefronts_lanes_init_wavefront(in_mwavefront_sub,lo-1,hi+1);
+  affine_wavefronts_lanes_init_wavefront(in_mwavefront_gap,lo-1,hi+1);
+  affine_wavefronts_lanes_init_wavefront(in_idwavefront_ext,lo-1,hi+1);
+  // Compute
+  out_wavefront->null = false;
+  out_wavefront->lo = lo;
+  out_wavefront->hi = hi;
+  affine_wavefronts_lanes_compute_offsets(
+      in_mwavefront_sub,in_mwavefront_gap,in_idwavefront_ext,in_idwavefront_ext,
+      out_wavefront,min_k,max_k);
+  out_wavefront->init_lo = lo;
+  out_wavefront->init_hi = hi;
+}
+/*
+ * Extend exact-matches (per lane)
+ */
+int affine_wavefronts_lanes_extend_matches(
+    const char* const pattern,
+    const char* const text,
+    const int max_chars) {
+  // Compare 64-bits blocks
+  int equal_chars = 0;
+  while (max_chars-equal_chars >= 8) {
+    const uint64_t pattern_block = *((uint64_t*)(pattern+equal_chars));
+    const uint64_t text_block = *((uint64_t*)(text+equal_chars));
+    const uint64_t cmp = pattern_block ^ text_block;
+    if (cmp) return equal_chars + DIV_FLOOR(__builtin_ctzl(cmp),8);
+    equal_chars += 8;
+  }
+  // Compare remaining characters
+  while (equal_chars < max_chars && pattern[equal_chars]==text[equal_chars]) ++equal_chars;
+  return equal_chars;
+}
+void affine_wavefronts_lanes_extend(
+    affine_lanes_wavefront_t* const mwavefront,
+    affine_wavefronts_pair_t* const* const lane_pairs,
+    const bool* const active) {
+  // Extend diagonally each wavefront point of the active lanes
+  int k, l;
+  for (l=0;l<AFFINE_WAVEFRONT_LANES;++l) {
+    if (!active[l]) continue;
+    // Parameters (lane)
+    const affine_wavefronts_pair_t* const pair = lane_pairs[l];
+    const char* const pattern = pair->pattern;
+    const char* const text = pair->text;
+    const int pattern_length = pair->pattern_length;
+    const int text_length = pair->text_length;
+    awf_offset_t* const lane_offsets = mwavefront->moffsets + l;
+    for (k=mwavefront->lo;k<=mwavefront->hi;++k) {
+      // Fetch offset & positions
+      const awf_offset_t offset = lane_offsets[k*AFFINE_WAVEFRONT_LANES];
+      const uint32_t h = AFFINE_WAVEFRONT_H(k,offset); // Make unsigned to avoid checking negative
+      if (h >= text_length) continue;
+      const uint32_t v = AFFINE_WAVEFRONT_V(k,offset); // Make unsigned to avoid checking negative
+      if (v >= pattern_length) continue;
+      // Extend
+      const int max_chars = MIN(pattern_length-(int)v,text_length-(int)h);
+      lane_offsets[k*AFFINE_WAVEFRONT_LANES] +=
+          affine_wavefronts_lanes_extend_matches(pattern+v,text+h,max_chars);
+    }
+  }
+}
+/*
+ * Lane-parallel alignment
+ */
+void affine_wavefronts_align_lanes_group(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    int* const scores) {
+  // Lanes (unused lanes start finished on an empty pair)
+  affine_wavefronts_pair_t empty_pair = { .pattern="", .pattern_length=0, .text="", .text_length=0 };
+  affine_wavefronts_pair_t* lane_pairs[AFFINE_WAVEFRONT_LANES];
+  int min_k[AFFINE_WAVEFRONT_LANES], max_k[AFFINE_WAVEFRONT_LANES];
+  bool active[AFFINE_WAVEFRONT_LANES];
+  int min_k_all = 0, max_k_all = 0, max_pattern_length = 0, max_text_length = 0;
+  int l, num_active = 0;
+  for (l=0;l<AFFINE_WAVEFRONT_LANES;++l) {
+    lane_pairs[l] = (l < num_pairs) ? pairs + l : &empty_pair;
+    min_k[l] = -lane_pairs[l]->pattern_length;
+    max_k[l] = lane_pairs[l]->text_length;
+    active[l] = (l < num_pairs);
+    min_k_all = MIN(min_k_all,min_k[l]);
+    max_k_all = MAX(max_k_all,max_k[l]);
+    max_pattern_length = MAX(max_pattern_length,lane_pairs[l]->pattern_length);
+    max_text_length = MAX(max_text_length,lane_pairs[l]->text_length);
+    if (active[l]) ++num_active;
+  }
+  // Resize & clear wavefronts
+  affine_wavefronts_lanes_resize(affine_wavefronts_lanes,max_pattern_length,max_text_length);
+  int i;
+  for (i=0;i<affine_wavefronts_lanes->num_wavefronts;++i) {
+    affine_wavefronts_lanes_clear_wavefront(affine_wavefronts_lanes->wavefronts+i);
+  }
+  affine_wavefronts_lanes_clear_wavefront(&affine_wavefronts_lanes->wavefront_null);
+  // Initialize wavefront (score 0)
+  affine_lanes_wavefront_t* const initial_wavefront =
+      affine_wavefronts_lanes_get_wavefront(affine_wavefronts_lanes,0);
+  affine_wavefronts_lanes_init_wavefront(initial_wavefront,0,0);
+  for (l=0;l<AFFINE_WAVEFRONT_LANES;++l) initial_wavefront->moffsets[l] = 0;
+  initial_wavefront->null = false;
+  initial_wavefront->lo = 0;
+  initial_wavefront->hi = 0;
+  // Compute wavefronts for increasing score
+  int score = 0;
+  while (true) {
+    affine_lanes_wavefront_t* const mwavefront =
+        affine_wavefronts_lanes_get_wavefront(affine_wavefronts_lanes,score);
+    if (!mwavefront->null) {
+      // Extend diagonally each wavefront point
+      affine_wavefronts_lanes_extend(mwavefront,lane_pairs,active);
+      // Exit condition (per lane)
+      for (l=0;l<AFFINE_WAVEFRONT_LANES;++l) {
+        if (!active[l]) continue;
+        const int alignment_k = AFFINE_WAVEFRONT_DIAGONAL(lane_pairs[l]->text_length,lane_pairs[l]->pattern_length);
+        if (alignment_k < mwavefront->lo || alignment_k > mwavefront->hi) continue;
+        const awf_offset_t offset = mwavefront->moffsets[alignment_k*AFFINE_WAVEFRONT_LANES+l];
+        if (offset >= lane_pairs[l]->text_length) {
+          scores[l] = -score;
+          active[l] = false;
+          --num_active;
+        }
+      }
+      if (num_active == 0) return;
+    }
+    // Update all wavefronts
+    ++score;
+    affine_wavefronts_lanes_compute_next(
+        affine_wavefronts_lanes,score,min_k_all,max_k_all,min_k,max_k);
+  }
+}
+void affine_wavefronts_align_lanes(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    int* const scores) {
+  int i;
+  for (i=0;i<num_pairs;i+=AFFINE_WAVEFRONT_LANES) {
+    affine_wavefronts_align_lanes_group(affine_wavefronts_lanes,
+        pairs+i,MIN(num_pairs-i,AFFINE_WAVEFRONT_LANES),scores+i);
+  }
+}
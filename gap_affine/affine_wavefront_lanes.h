@@ -0,0 +1,109 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: WFA lane-parallel engine (many pairs aligned in lockstep)
+ */
+
+#ifndef AFFINE_WAVEFRONT_LANES_H_
+#define AFFINE_WAVEFRONT_LANES_H_
+
+#include "utils/commons.h"
+#include "gap_affine/affine_wavefront.h"
+#include "gap_affine/affine_wavefront_batch.h"
+
+/*
+ * Constants
+ */
+#define AFFINE_WAVEFRONT_LANES           16 // Pairs aligned in lockstep (one per lane)
+#define AFFINE_WAVEFRONT_LANES_ALIGNMENT 64 // Offsets alignment (bytes)
+
+/*
+ * Lane wavefront (M/I/D offsets of all lanes for one score)
+ *   Offsets are stored lane-major, offsets[k*AFFINE_WAVEFRONT_LANES+lane],
+ *   so all lanes of a diagonal are contiguous and computed with the same
+ *   vector instructions. Cells in [init_lo,init_hi] hold valid values
+ *   (computed or NULL); cells outside may be stale.
+ */
+typedef struct {
+  bool null;                       // Is null (no diagonal computed)
+  int lo;                          // Effective lowest diagonal (inclusive)
+  int hi;                          // Effective highest diagonal (inclusive)
+  int init_lo;                     // Lowest initialized diagonal (inclusive)
+  int init_hi;                     // Highest initialized diagonal (inclusive)
+  awf_offset_t* moffsets;          // M-offsets (shifted to diagonal 0)
+  awf_offset_t* ioffsets;          // I-offsets (shifted to diagonal 0)
+  awf_offset_t* doffsets;          // D-offsets (shifted to diagonal 0)
+  awf_offset_t* offsets_mem;       // Offsets memory
+} affine_lanes_wavefront_t;
+
+/*
+ * Lane-parallel aligner (score-only)
+ *   Only the last max(X,O+E)+1 scores are needed to compute the next one,
+ *   so wavefronts live in a circular buffer indexed by score. No CIGAR is
+ *   produced (no backtrace wavefronts are kept).
+ */
+typedef struct {
+  // Penalties
+  affine_penalties_t penalties;              // Wavefront penalties (match forced to zero)
+  // Wavefronts
+  affine_lanes_wavefront_t* wavefronts;      // Circular buffer of wavefronts (by score)
+  affine_lanes_wavefront_t wavefront_null;   // Null wavefront (negative scores)
+  int num_wavefronts;                        // Total wavefronts in the buffer
+  int max_pattern_length;                    // Maximum pattern length allocated
+  int max_text_length;                       // Maximum text length allocated
+  // MM
+  mm_allocator_t* mm_allocator;              // MM-Allocator
+} affine_wavefronts_lanes_t;
+
+/*
+ * Setup
+ */
+affine_wavefronts_lanes_t* affine_wavefronts_lanes_new(
+    affine_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator);
+void affine_wavefronts_lanes_delete(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes);
+
+/*
+ * Lane-parallel alignment
+ *   Aligns the pairs in groups of AFFINE_WAVEFRONT_LANES (consecutive
+ *   pairs), writing the score of each pair into @scores (same order as
+ *   @pairs). Scores follow edit_cigar_score_gap_affine() with the match
+ *   score forced to zero (i.e. minus the alignment penalty). Pairs of
+ *   similar length should be grouped together, as each group runs until
+ *   its slowest lane finishes. Only the wavefront computation runs across
+ *   lanes; the exact-match extension is scalar per lane (block-wise
+ *   comparison), as each lane diverges at a different character.
+ */
+void affine_wavefronts_align_lanes(
+    affine_wavefronts_lanes_t* const affine_wavefronts_lanes,
+    affine_wavefronts_pair_t* const pairs,
+    const int num_pairs,
+    int* const scores);
+
+#endif /* AFFINE_WAVEFRONT_LANES_H_ */
@@ -39,6 +39,10 @@ void affine_wavefronts_penalties_init(
     affine_penalties_t* const penalties,
     const wavefronts_penalties_strategy penalties_strategy) {
   wavefronts_penalties->base_penalties = *penalties;
+  wavefronts_penalties->gap_affine_2p = false;
+  // Clear two-piece penalties (unused)
+  memset(&wavefronts_penalties->base_penalties_2p,0,sizeof(affine2p_penalties_t));
+  memset(&wavefronts_penalties->wavefront_penalties_2p,0,sizeof(affine2p_penalties_t));
   wavefronts_penalties->penalties_strategy =
       (penalties->match==0) ? wavefronts_penalties_match_zero : penalties_strategy;
   switch (wavefronts_penalties->penalties_strategy) {
@@ -56,6 +60,39 @@ void affine_wavefronts_penalties_init(
       break;
   }
 }
+void affine_wavefronts_penalties_init_2p(
+    affine_wavefronts_penalties_t* const wavefronts_penalties,
+    affine2p_penalties_t* const penalties,
+    const wavefronts_penalties_strategy penalties_strategy) {
+  wavefronts_penalties->base_penalties_2p = *penalties;
+  wavefronts_penalties->gap_affine_2p = true;
+  wavefronts_penalties->penalties_strategy =
+      (penalties->match==0) ? wavefronts_penalties_match_zero : penalties_strategy;
+  switch (wavefronts_penalties->penalties_strategy) {
+    case wavefronts_penalties_match_zero:
+    case wavefronts_penalties_force_zero_match:
+      affine2p_penalties_mzero(penalties,&(wavefronts_penalties->wavefront_penalties_2p));
+      break;
+    case wavefronts_penalties_shifted_penalties:
+    case wavefronts_penalties_odd_pair_penalties: // Odd/Pair heuristic not supported (plain shift)
+      affine2p_penalties_shift(penalties,&(wavefronts_penalties->wavefront_penalties_2p));
+      break;
+    default:
+      break;
+  }
+  // Mirror first gap-piece as single-piece penalties
+  affine_penalties_t* const base_penalties = &(wavefronts_penalties->base_penalties);
+  affine_penalties_t* const wavefront_penalties = &(wavefronts_penalties->wavefront_penalties);
+  affine2p_penalties_t* const wavefront_penalties_2p = &(wavefronts_penalties->wavefront_penalties_2p);
+  base_penalties->match = penalties->match;
+  base_penalties->mismatch = penalties->mismatch;
+  base_penalties->gap_opening = penalties->gap_opening1;
+  base_penalties->gap_extension = penalties->gap_extension1;
+  wavefront_penalties->match = wavefront_penalties_2p->match;
+  wavefront_penalties->mismatch = wavefront_penalties_2p->mismatch;
+  wavefront_penalties->gap_opening = wavefront_penalties_2p->gap_opening1;
+  wavefront_penalties->gap_extension = wavefront_penalties_2p->gap_extension1;
+}
 /*
  * Score Adjustment
  */
@@ -123,3 +160,50 @@ void affine_penalties_shift(
   }
 }
 
+void affine2p_penalties_mzero(
+    affine2p_penalties_t* const base_penalties,
+    affine2p_penalties_t* const shifted_penalties) {
+  // Check base penalties
+  if (base_penalties->match > 0) {
+    fprintf(stderr,"Match score must be negative or zero (M=%d)\n",base_penalties->match);
+    exit(1);
+  }
+  if (base_penalties->mismatch <= 0 ||
+      base_penalties->gap_opening1 < 0 || base_penalties->gap_extension1 <= 0 ||
+      base_penalties->gap_opening2 < 0 || base_penalties->gap_extension2 <= 0) {
+    fprintf(stderr,"Mismatch/Gap scores must be strictly positive (X=%d,O1=%d,E1=%d,O2=%d,E2=%d)\n",
+        base_penalties->mismatch,base_penalties->gap_opening1,base_penalties->gap_extension1,
+        base_penalties->gap_opening2,base_penalties->gap_extension2);
+    exit(1);
+  }
+  // Copy base penalties
+  *shifted_penalties = *base_penalties;
+  // Zero match score
+  shifted_penalties->match = 0;
+}
+void affine2p_penalties_shift(
+    affine2p_penalties_t* const base_penalties,
+    affine2p_penalties_t* const shifted_penalties) {
+  // Check base penalties
+  if (base_penalties->match > 0) {
+    fprintf(stderr,"Match score must be negative (M=%d)\n",base_penalties->match);
+    exit(1);
+  }
+  if (base_penalties->mismatch <= 0 ||
+      base_penalties->gap_opening1 <= 0 || base_penalties->gap_extension1 <= 0 ||
+      base_penalties->gap_opening2 <= 0 || base_penalties->gap_extension2 <= 0) {
+    fprintf(stderr,"Mismatch/Gap scores must be strictly positive (X=%d,O1=%d,E1=%d,O2=%d,E2=%d)\n",
+        base_penalties->mismatch,base_penalties->gap_opening1,base_penalties->gap_extension1,
+        base_penalties->gap_opening2,base_penalties->gap_extension2);
+    exit(1);
+  }
+  // Copy base penalties
+  *shifted_penalties = *base_penalties;
+  // Shift to zero match score
+  shifted_penalties->match = 0;
+  shifted_penalties->mismatch -= base_penalties->match;
+  shifted_penalties->gap_opening1 -= base_penalties->match;
+  shifted_penalties->gap_extension1 -= base_penalties->match;
+  shifted_penalties->gap_opening2 -= base_penalties->match;
+  shifted_penalties->gap_extension2 -= base_penalties->match;
+}
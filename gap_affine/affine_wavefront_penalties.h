@@ -52,6 +52,10 @@ typedef struct {
   affine_penalties_t base_penalties;                // Input base Gap-Affine penalties
   affine_penalties_t wavefront_penalties;           // Wavefront Gap-Affine penalties
   wavefronts_penalties_strategy penalties_strategy; // Penalties adaptation strategy
+  // Two-piece Gap-Affine (dual-cost)
+  bool gap_affine_2p;                               // Enabled two-piece gap-affine (I2/D2 wavefronts)
+  affine2p_penalties_t base_penalties_2p;           // Input base two-piece Gap-Affine penalties
+  affine2p_penalties_t wavefront_penalties_2p;      // Wavefront two-piece Gap-Affine penalties
 } affine_wavefronts_penalties_t;
 
 /*
@@ -61,6 +65,10 @@ void affine_wavefronts_penalties_init(
     affine_wavefronts_penalties_t* const wavefronts_penalties,
     affine_penalties_t* const penalties,
     const wavefronts_penalties_strategy penalties_strategy);
+void affine_wavefronts_penalties_init_2p(
+    affine_wavefronts_penalties_t* const wavefronts_penalties,
+    affine2p_penalties_t* const penalties,
+    const wavefronts_penalties_strategy penalties_strategy);
 
 /*
  * Score Adjustment
@@ -72,6 +80,12 @@ void affine_penalties_shift(
     affine_penalties_t* const base_penalties,
     affine_penalties_t* const shifted_penalties,
     const bool pair_odd_heuristic);
+void affine2p_penalties_mzero(
+    affine2p_penalties_t* const base_penalties,
+    affine2p_penalties_t* const shifted_penalties);
+void affine2p_penalties_shift(
+    affine2p_penalties_t* const base_penalties,
+    affine2p_penalties_t* const shifted_penalties);
 
 
 #endif /* AFFINE_WAVEFRONT_PENALTIES_H_ */
@@ -37,21 +37,43 @@
 affine_wavefront_t* affine_wavefronts_get_source_mwavefront(
     affine_wavefronts_t* const affine_wavefronts,
     const int score) {
-  return (score < 0 || affine_wavefronts->mwavefronts[score] == NULL) ?
+  return (score < 0 ||
+          affine_wavefronts->mwavefronts[score] == NULL ||
+          affine_wavefronts->mwavefronts[score]->null) ?
       &affine_wavefronts->wavefront_null : affine_wavefronts->mwavefronts[score];
 }
 affine_wavefront_t* affine_wavefronts_get_source_iwavefront(
     affine_wavefronts_t* const affine_wavefronts,
     const int score) {
-  return (score < 0 || affine_wavefronts->iwavefronts[score] == NULL) ?
+  return (score < 0 ||
+          affine_wavefronts->iwavefronts[score] == NULL ||
+          affine_wavefronts->iwavefronts[score]->null) ?
       &affine_wavefronts->wavefront_null : affine_wavefronts->iwavefronts[score];
 }
 affine_wavefront_t* affine_wavefronts_get_source_dwavefront(
     affine_wavefronts_t* const affine_wavefronts,
     const int score) {
-  return (score < 0 || affine_wavefronts->dwavefronts[score] == NULL) ?
+  return (score < 0 ||
+          affine_wavefronts->dwavefronts[score] == NULL ||
+          affine_wavefronts->dwavefronts[score]->null) ?
       &affine_wavefronts->wavefront_null : affine_wavefronts->dwavefronts[score];
 }
+affine_wavefront_t* affine_wavefronts_get_source_i2wavefront(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int score) {
+  return (score < 0 ||
+          affine_wavefronts->i2wavefronts[score] == NULL ||
+          affine_wavefronts->i2wavefronts[score]->null) ?
+      &affine_wavefronts->wavefront_null : affine_wavefronts->i2wavefronts[score];
+}
+affine_wavefront_t* affine_wavefronts_get_source_d2wavefront(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int score) {
+  return (score < 0 ||
+          affine_wavefronts->d2wavefronts[score] == NULL ||
+          affine_wavefronts->d2wavefronts[score]->null) ?
+      &affine_wavefronts->wavefront_null : affine_wavefronts->d2wavefronts[score];
+}
 int affine_wavefronts_diagonal_length(
     affine_wavefronts_t* const affine_wavefronts,
     const int k) {
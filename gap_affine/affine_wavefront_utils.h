@@ -46,6 +46,12 @@ affine_wavefront_t* affine_wavefronts_get_source_iwavefront(
 affine_wavefront_t* affine_wavefronts_get_source_dwavefront(
     affine_wavefronts_t* const affine_wavefronts,
     const int score);
+affine_wavefront_t* affine_wavefronts_get_source_i2wavefront(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int score);
+affine_wavefront_t* affine_wavefronts_get_source_d2wavefront(
+    affine_wavefronts_t* const affine_wavefronts,
+    const int score);
 int affine_wavefronts_diagonal_length(
     affine_wavefronts_t* const affine_wavefronts,
     const int k);
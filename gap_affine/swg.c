@@ -140,6 +140,56 @@ void swg_compute(
   // DEBUG
   //affine_table_print(stderr,affine_table,pattern,text);
 }
+/*
+ * SWG distance computation using raw DP-Table (relaxed matching)
+ */
+void swg_compute_match(
+    affine_table_t* const affine_table,
+    affine_penalties_t* const penalties,
+    const affine_wavefronts_match_t* const match,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Parameters
+  affine_cell_t** const dp = affine_table->columns;
+  int h, v;
+  // Init DP
+  dp[0][0].D = SCORE_MAX;
+  dp[0][0].I = SCORE_MAX;
+  dp[0][0].M = 0;
+  for (v=1;v<=pattern_length;++v) { // Init first column
+    dp[0][v].D = penalties->gap_opening + v*penalties->gap_extension;
+    dp[0][v].I = SCORE_MAX;
+    dp[0][v].M = dp[0][v].D;
+  }
+  for (h=1;h<=text_length;++h) { // Init first row
+    dp[h][0].D = SCORE_MAX;
+    dp[h][0].I = penalties->gap_opening + h*penalties->gap_extension;
+    dp[h][0].M = dp[h][0].I;
+  }
+  // Compute DP
+  for (h=1;h<=text_length;++h) {
+    for (v=1;v<=pattern_length;++v) {
+      // Update DP.D
+      const int del_new = dp[h][v-1].M + penalties->gap_opening + penalties->gap_extension;
+      const int del_ext = dp[h][v-1].D + penalties->gap_extension;
+      const int del = MIN(del_new,del_ext);
+      dp[h][v].D = del;
+      // Update DP.I
+      const int ins_new = dp[h-1][v].M + penalties->gap_opening + penalties->gap_extension;
+      const int ins_ext = dp[h-1][v].I + penalties->gap_extension;
+      const int ins = MIN(ins_new,ins_ext);
+      dp[h][v].I = ins;
+      // Update DP.M
+      const bool is_match = affine_wavefronts_match_chars(match,pattern[v-1],text[h-1]);
+      const int m_match = dp[h-1][v-1].M + (is_match ? penalties->match : penalties->mismatch);
+      dp[h][v].M = MIN(m_match,MIN(ins,del));
+    }
+  }
+  // Compute traceback
+  swg_traceback(affine_table,penalties);
+}
 /*
  * SWG distance computation using raw DP-Table (banded)
  */
@@ -212,3 +262,153 @@ void swg_compute_banded(
   // Compute traceback
   swg_traceback(affine_table,penalties);
 }
+/*
+ * SWG distance computation using raw DP-Table (two-piece gap-affine)
+ */
+typedef enum {
+  swg2p_M_layer,
+  swg2p_I1_layer,
+  swg2p_D1_layer,
+  swg2p_I2_layer,
+  swg2p_D2_layer
+} swg2p_layer_type;
+void swg_traceback_2p(
+    affine2p_table_t* const affine2p_table,
+    affine2p_penalties_t* const penalties) {
+  // Parameters
+  affine2p_cell_t** const dp = affine2p_table->columns;
+  char* const operations = affine2p_table->edit_cigar.operations;
+  int op_sentinel = affine2p_table->edit_cigar.end_offset-1;
+  int h, v;
+  // Compute traceback
+  h = affine2p_table->num_columns-1;
+  v = affine2p_table->num_rows-1;
+  swg2p_layer_type swg_layer = swg2p_M_layer;
+  while (h>0 && v>0) {
+    switch (swg_layer) {
+      case swg2p_D1_layer:
+        // Traceback D1-matrix
+        operations[op_sentinel--] = 'D';
+        if (dp[h][v].D1 == dp[h][v-1].M + penalties->gap_opening1 + penalties->gap_extension1) {
+          swg_layer = swg2p_M_layer;
+        }
+        --v;
+        break;
+      case swg2p_D2_layer:
+        // Traceback D2-matrix
+        operations[op_sentinel--] = 'D';
+        if (dp[h][v].D2 == dp[h][v-1].M + penalties->gap_opening2 + penalties->gap_extension2) {
+          swg_layer = swg2p_M_layer;
+        }
+        --v;
+        break;
+      case swg2p_I1_layer:
+        // Traceback I1-matrix
+        operations[op_sentinel--] = 'I';
+        if (dp[h][v].I1 == dp[h-1][v].M + penalties->gap_opening1 + penalties->gap_extension1) {
+          swg_layer = swg2p_M_layer;
+        }
+        --h;
+        break;
+      case swg2p_I2_layer:
+        // Traceback I2-matrix
+        operations[op_sentinel--] = 'I';
+        if (dp[h][v].I2 == dp[h-1][v].M + penalties->gap_opening2 + penalties->gap_extension2) {
+          swg_layer = swg2p_M_layer;
+        }
+        --h;
+        break;
+      case swg2p_M_layer:
+        // Traceback M-matrix
+        if (dp[h][v].M == dp[h][v].D1) {
+          swg_layer = swg2p_D1_layer;
+        } else if (dp[h][v].M == dp[h][v].D2) {
+          swg_layer = swg2p_D2_layer;
+        } else if (dp[h][v].M == dp[h][v].I1) {
+          swg_layer = swg2p_I1_layer;
+        } else if (dp[h][v].M == dp[h][v].I2) {
+          swg_layer = swg2p_I2_layer;
+        } else if (dp[h][v].M == dp[h-1][v-1].M + penalties->match) {
+          operations[op_sentinel--] = 'M';
+          --h; --v;
+        } else if (dp[h][v].M == dp[h-1][v-1].M + penalties->mismatch) {
+          operations[op_sentinel--] = 'X';
+          --h; --v;
+        } else {
+          fprintf(stderr,"SWG-2P backtrace. No backtrace operation found");
+          exit(1);
+        }
+        break;
+    }
+  }
+  while (h>0) {operations[op_sentinel--] = 'I'; --h;}
+  while (v>0) {operations[op_sentinel--] = 'D'; --v;}
+  affine2p_table->edit_cigar.begin_offset = op_sentinel+1;
+}
+void swg_compute_2p_match(
+    affine2p_table_t* const affine2p_table,
+    affine2p_penalties_t* const penalties,
+    const affine_wavefronts_match_t* const match,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Parameters
+  affine2p_cell_t** const dp = affine2p_table->columns;
+  const int gap_open1 = penalties->gap_opening1 + penalties->gap_extension1;
+  const int gap_open2 = penalties->gap_opening2 + penalties->gap_extension2;
+  int h, v;
+  // Init DP
+  dp[0][0].D1 = SCORE_MAX;
+  dp[0][0].D2 = SCORE_MAX;
+  dp[0][0].I1 = SCORE_MAX;
+  dp[0][0].I2 = SCORE_MAX;
+  dp[0][0].M = 0;
+  for (v=1;v<=pattern_length;++v) { // Init first column
+    dp[0][v].D1 = penalties->gap_opening1 + v*penalties->gap_extension1;
+    dp[0][v].D2 = penalties->gap_opening2 + v*penalties->gap_extension2;
+    dp[0][v].I1 = SCORE_MAX;
+    dp[0][v].I2 = SCORE_MAX;
+    dp[0][v].M = MIN(dp[0][v].D1,dp[0][v].D2);
+  }
+  for (h=1;h<=text_length;++h) { // Init first row
+    dp[h][0].D1 = SCORE_MAX;
+    dp[h][0].D2 = SCORE_MAX;
+    dp[h][0].I1 = penalties->gap_opening1 + h*penalties->gap_extension1;
+    dp[h][0].I2 = penalties->gap_opening2 + h*penalties->gap_extension2;
+    dp[h][0].M = MIN(dp[h][0].I1,dp[h][0].I2);
+  }
+  // Compute DP
+  for (h=1;h<=text_length;++h) {
+    for (v=1;v<=pattern_length;++v) {
+      // Update DP.D1 & DP.D2
+      const int del1 = MIN(dp[h][v-1].M + gap_open1,dp[h][v-1].D1 + penalties->gap_extension1);
+      const int del2 = MIN(dp[h][v-1].M + gap_open2,dp[h][v-1].D2 + penalties->gap_extension2);
+      dp[h][v].D1 = del1;
+      dp[h][v].D2 = del2;
+      // Update DP.I1 & DP.I2
+      const int ins1 = MIN(dp[h-1][v].M + gap_open1,dp[h-1][v].I1 + penalties->gap_extension1);
+      const int ins2 = MIN(dp[h-1][v].M + gap_open2,dp[h-1][v].I2 + penalties->gap_extension2);
+      dp[h][v].I1 = ins1;
+      dp[h][v].I2 = ins2;
+      // Update DP.M
+      const bool is_match = (match==NULL) ? (pattern[v-1]==text[h-1]) :
+          affine_wavefronts_match_chars(match,pattern[v-1],text[h-1]);
+      const int m_match = dp[h-1][v-1].M + (is_match ? penalties->match : penalties->mismatch);
+      const int gap = MIN(MIN(del1,del2),MIN(ins1,ins2));
+      dp[h][v].M = MIN(m_match,gap);
+    }
+  }
+  // Compute traceback
+  swg_traceback_2p(affine2p_table,penalties);
+}
+void swg_compute_2p(
+    affine2p_table_t* const affine2p_table,
+    affine2p_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  swg_compute_2p_match(affine2p_table,penalties,NULL,
+      pattern,pattern_length,text,text_length); // Exact matching
+}
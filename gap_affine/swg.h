@@ -36,6 +36,7 @@
 #include "utils/commons.h"
 #include "edit/edit_table.h"
 #include "gap_affine/affine_table.h"
+#include "gap_affine/affine_wavefront.h"
 
 /*
  * SWG distance computation using raw DP-Table
@@ -48,6 +49,20 @@ void swg_compute(
     const char* const text,
     const int text_length);
 
+/*
+ * SWG distance computation using raw DP-Table (relaxed matching)
+ *   Characters match as in the WFA extension using @match
+ *   (see affine_wavefronts_set_match())
+ */
+void swg_compute_match(
+    affine_table_t* const affine_table,
+    affine_penalties_t* const penalties,
+    const affine_wavefronts_match_t* const match,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+
 /*
  * SWG distance computation using raw DP-Table (banded)
  */
@@ -60,4 +75,23 @@ void swg_compute_banded(
     const int text_length,
     const int bandwidth);
 
+/*
+ * SWG distance computation using raw DP-Table (two-piece gap-affine)
+ */
+void swg_compute_2p(
+    affine2p_table_t* const affine2p_table,
+    affine2p_penalties_t* const penalties,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+void swg_compute_2p_match(
+    affine2p_table_t* const affine2p_table,
+    affine2p_penalties_t* const penalties,
+    const affine_wavefronts_match_t* const match,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+
 #endif /* SWG_H_ */
@@ -0,0 +1,120 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Bump-allocation slab for wavefront offsets (reset in O(1))
+ */
+
+#include "gap_affine/wavefront_slab.h"
+
+/*
+ * Segments
+ */
+void wavefront_slab_segment_allocate(
+    wavefront_slab_t* const slab,
+    const uint64_t segment_size) {
+  // Allocate (aligned base)
+  slab->segment_mem = mm_allocator_malloc_aligned(slab->mm_allocator,segment_size,WAVEFRONT_SLAB_ALIGNMENT);
+  slab->segment_size = segment_size;
+  slab->segment_used = 0;
+}
+void wavefront_slab_segment_retire(
+    wavefront_slab_t* const slab) {
+  vector_insert(slab->segments_retired,slab->segment_mem,void*);
+  slab->size_retired += slab->segment_size;
+}
+void wavefront_slab_segments_free_retired(
+    wavefront_slab_t* const slab) {
+  void** const segments = vector_get_mem(slab->segments_retired,void*);
+  const int num_segments = vector_get_used(slab->segments_retired);
+  int i;
+  for (i=0;i<num_segments;++i) {
+    mm_allocator_free(slab->mm_allocator,segments[i]);
+  }
+  vector_clear(slab->segments_retired);
+  slab->size_retired = 0;
+}
+/*
+ * Setup
+ */
+void wavefront_slab_init(
+    wavefront_slab_t* const slab,
+    const uint64_t segment_size,
+    mm_allocator_t* const mm_allocator) {
+  slab->mm_allocator = mm_allocator;
+  slab->segments_retired = vector_new(10,void*);
+  slab->size_retired = 0;
+  wavefront_slab_segment_allocate(slab,segment_size);
+}
+void wavefront_slab_clear(
+    wavefront_slab_t* const slab) {
+  // Merge all segments into one (big enough for the last usage)
+  if (!vector_is_empty(slab->segments_retired)) {
+    const uint64_t segment_size = slab->size_retired + slab->segment_size;
+    wavefront_slab_segments_free_retired(slab);
+    mm_allocator_free(slab->mm_allocator,slab->segment_mem);
+    wavefront_slab_segment_allocate(slab,segment_size);
+  } else {
+    slab->segment_used = 0;
+  }
+}
+void wavefront_slab_reap(
+    wavefront_slab_t* const slab) {
+  // Release all segments (back to a single initial-size segment)
+  wavefront_slab_segments_free_retired(slab);
+  if (slab->segment_size > WAVEFRONT_SLAB_INITIAL_SIZE) {
+    mm_allocator_free(slab->mm_allocator,slab->segment_mem);
+    wavefront_slab_segment_allocate(slab,WAVEFRONT_SLAB_INITIAL_SIZE);
+  } else {
+    slab->segment_used = 0;
+  }
+}
+void wavefront_slab_free(
+    wavefront_slab_t* const slab) {
+  wavefront_slab_segments_free_retired(slab);
+  vector_delete(slab->segments_retired);
+  mm_allocator_free(slab->mm_allocator,slab->segment_mem);
+}
+/*
+ * Allocate
+ */
+void* wavefront_slab_allocate(
+    wavefront_slab_t* const slab,
+    const uint64_t num_bytes) {
+  // Aligned stride
+  const uint64_t stride = (num_bytes + (WAVEFRONT_SLAB_ALIGNMENT-1)) & ~((uint64_t)WAVEFRONT_SLAB_ALIGNMENT-1);
+  // Check available space (grow geometrically)
+  if (slab->segment_used + stride > slab->segment_size) {
+    const uint64_t segment_size = MAX(2*slab->segment_size,stride);
+    wavefront_slab_segment_retire(slab);
+    wavefront_slab_segment_allocate(slab,segment_size);
+  }
+  // Bump
+  void* const memory = slab->segment_mem + slab->segment_used;
+  slab->segment_used += stride;
+  return memory;
+}
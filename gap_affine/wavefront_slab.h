@@ -0,0 +1,85 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Bump-allocation slab for wavefront offsets (reset in O(1))
+ */
+
+#ifndef WAVEFRONT_SLAB_H_
+#define WAVEFRONT_SLAB_H_
+
+#include "utils/commons.h"
+#include "utils/vector.h"
+#include "system/mm_allocator.h"
+
+/*
+ * Constants
+ */
+#define WAVEFRONT_SLAB_ALIGNMENT     64          // Allocations stride/alignment (cache-line)
+#define WAVEFRONT_SLAB_INITIAL_SIZE  BUFFER_SIZE_64K
+
+/*
+ * Wavefront Slab
+ *   Contiguous memory segment handing out aligned blocks with no header.
+ *   When the segment is exhausted, a new (larger) one is allocated and the
+ *   old one is retired until the next clear. On clear, retired segments are
+ *   merged into a single segment so the steady state is one pointer reset.
+ */
+typedef struct {
+  // Current segment
+  char* segment_mem;           // Segment memory (aligned)
+  uint64_t segment_size;       // Segment size (bytes)
+  uint64_t segment_used;       // Segment used (bytes)
+  // Retired segments
+  vector_t* segments_retired;  // Exhausted segments (void*)
+  uint64_t size_retired;       // Total size of the retired segments (bytes)
+  // MM
+  mm_allocator_t* mm_allocator;
+} wavefront_slab_t;
+
+/*
+ * Setup
+ */
+void wavefront_slab_init(
+    wavefront_slab_t* const slab,
+    const uint64_t segment_size,
+    mm_allocator_t* const mm_allocator);
+void wavefront_slab_clear(
+    wavefront_slab_t* const slab);
+void wavefront_slab_reap(
+    wavefront_slab_t* const slab);
+void wavefront_slab_free(
+    wavefront_slab_t* const slab);
+
+/*
+ * Allocate
+ */
+void* wavefront_slab_allocate(
+    wavefront_slab_t* const slab,
+    const uint64_t num_bytes);
+
+#endif /* WAVEFRONT_SLAB_H_ */
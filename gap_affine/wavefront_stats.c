@@ -53,6 +53,27 @@ void wavefronts_stats_clear(wavefronts_stats_t* const wavefronts_stats) {
   counter_reset(&(wavefronts_stats->wf_backtrace_paths));
   counter_reset(&(wavefronts_stats->wf_backtrace_alg));
 }
+void wavefronts_stats_combine(
+    wavefronts_stats_t* const wavefronts_stats_dst,
+    wavefronts_stats_t* const wavefronts_stats_src) {
+  counter_combine_sum(&(wavefronts_stats_dst->wf_score),&(wavefronts_stats_src->wf_score));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_steps),&(wavefronts_stats_src->wf_steps));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_steps_null),&(wavefronts_stats_src->wf_steps_null));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_steps_extra),&(wavefronts_stats_src->wf_steps_extra));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_operations),&(wavefronts_stats_src->wf_operations));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_extensions),&(wavefronts_stats_src->wf_extensions));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_reduction),&(wavefronts_stats_src->wf_reduction));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_reduced_cells),&(wavefronts_stats_src->wf_reduced_cells));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_null_used),&(wavefronts_stats_src->wf_null_used));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_extend_inner_loop),&(wavefronts_stats_src->wf_extend_inner_loop));
+  int i;
+  for (i=0;i<4;++i) {
+    counter_combine_sum(&(wavefronts_stats_dst->wf_compute_kernel[i]),&(wavefronts_stats_src->wf_compute_kernel[i]));
+  }
+  counter_combine_sum(&(wavefronts_stats_dst->wf_time_backtrace.time_ns),&(wavefronts_stats_src->wf_time_backtrace.time_ns));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_backtrace_paths),&(wavefronts_stats_src->wf_backtrace_paths));
+  counter_combine_sum(&(wavefronts_stats_dst->wf_backtrace_alg),&(wavefronts_stats_src->wf_backtrace_alg));
+}
 /*
  * Display
  */
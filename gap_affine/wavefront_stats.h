@@ -76,6 +76,9 @@ typedef struct {
  * Setup
  */
 void wavefronts_stats_clear(wavefronts_stats_t* const wavefronts_stats);
+void wavefronts_stats_combine(
+    wavefronts_stats_t* const wavefronts_stats_dst,
+    wavefronts_stats_t* const wavefronts_stats_src);
 
 /*
  * Display
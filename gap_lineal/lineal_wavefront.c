@@ -0,0 +1,537 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Wavefront alignment algorithm for pairwise gap-lineal
+ *   alignment
+ */
+
+#include "gap_lineal/lineal_wavefront.h"
+#include "utils/string_padded.h"
+
+/*
+ * Penalties
+ */
+void lineal_wavefronts_penalties_adapt(
+    lineal_penalties_t* const base_penalties,
+    lineal_penalties_t* const wavefront_penalties) {
+  // Check base penalties
+  if (base_penalties->match > 0) {
+    fprintf(stderr,"Match score must be negative or zero (M=%d)\n",base_penalties->match);
+    exit(1);
+  }
+  if (base_penalties->mismatch <= 0 ||
+      base_penalties->insertion <= 0 ||
+      base_penalties->deletion <= 0) {
+    fprintf(stderr,"Mismatch/Gap scores must be strictly positive (X=%d,I=%d,D=%d)\n",
+        base_penalties->mismatch,base_penalties->insertion,base_penalties->deletion);
+    exit(1);
+  }
+  // Copy base penalties
+  *wavefront_penalties = *base_penalties;
+  if (base_penalties->match == 0) return;
+  // Shift to zero match score. For global alignments, each match accounts
+  // for one pattern and one text character; thus, the score of any alignment
+  // is M*(n+m)/2 + (X-M)*#X + (I-M/2)*#I + (D-M/2)*#D. Doubling the
+  // penalties keeps them integer and preserves the optimal alignments
+  wavefront_penalties->match = 0;
+  wavefront_penalties->mismatch = 2*base_penalties->mismatch - 2*base_penalties->match;
+  wavefront_penalties->insertion = 2*base_penalties->insertion - base_penalties->match;
+  wavefront_penalties->deletion = 2*base_penalties->deletion - base_penalties->match;
+}
+/*
+ * Setup
+ */
+void lineal_wavefronts_allocate_wavefront_null(
+    lineal_wavefronts_t* const lineal_wavefronts) {
+  // Allocate null wavefront (covering diagonals [-pattern_length-1,text_length+1])
+  const int wavefront_length = lineal_wavefronts->pattern_length + lineal_wavefronts->text_length + 3;
+  lwf_offset_t* const offsets_null = mm_allocator_calloc(
+      lineal_wavefronts->mm_allocator,wavefront_length,lwf_offset_t,false);
+  // Initialize
+  lineal_wavefronts->wavefront_null.null = true;
+  lineal_wavefronts->wavefront_null.lo =  1;
+  lineal_wavefronts->wavefront_null.hi = -1;
+  lineal_wavefronts->wavefront_null.lo_base =  1;
+  lineal_wavefronts->wavefront_null.hi_base = -1;
+  lineal_wavefronts->wavefront_null.offsets = offsets_null + lineal_wavefronts->pattern_length + 1; // Center at k=0
+  int i;
+  for (i=0;i<wavefront_length;++i) {
+    offsets_null[i] = LINEAL_WAVEFRONT_OFFSET_NULL;
+  }
+}
+lineal_wavefronts_t* lineal_wavefronts_new(
+    const int pattern_length,
+    const int text_length,
+    lineal_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator) {
+  // Allocate
+  lineal_wavefronts_t* const lineal_wavefronts = mm_allocator_alloc(mm_allocator,lineal_wavefronts_t);
+  // Penalties
+  lineal_wavefronts->base_penalties = *penalties;
+  lineal_wavefronts_penalties_adapt(penalties,&lineal_wavefronts->wavefront_penalties);
+  // Dimensions
+  const lineal_penalties_t* const wavefront_penalties = &lineal_wavefronts->wavefront_penalties;
+  const int max_score_misms = MIN(pattern_length,text_length) * wavefront_penalties->mismatch;
+  const int max_score_indel = (pattern_length > text_length) ?
+      (pattern_length-text_length) * wavefront_penalties->deletion :
+      (text_length-pattern_length) * wavefront_penalties->insertion;
+  const int num_wavefronts = max_score_misms + max_score_indel + 1;
+  lineal_wavefronts->pattern_length = pattern_length;
+  lineal_wavefronts->text_length = text_length;
+  lineal_wavefronts->num_wavefronts = num_wavefronts;
+  // MM
+  lineal_wavefronts->mm_allocator = mm_allocator;
+  // Allocate wavefronts
+  lineal_wavefronts->mwavefronts =
+      mm_allocator_calloc(mm_allocator,num_wavefronts,lineal_wavefront_t*,true);
+  lineal_wavefronts->wavefronts_mem =
+      mm_allocator_calloc(mm_allocator,num_wavefronts,lineal_wavefront_t,false);
+  lineal_wavefronts->wavefronts_current = lineal_wavefronts->wavefronts_mem;
+  lineal_wavefronts_allocate_wavefront_null(lineal_wavefronts);
+  // CIGAR
+  edit_cigar_allocate(&lineal_wavefronts->edit_cigar,pattern_length,text_length,mm_allocator);
+  // Return
+  return lineal_wavefronts;
+}
+lineal_wavefronts_t* lineal_wavefronts_new_complete(
+    const int pattern_length,
+    const int text_length,
+    lineal_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator) {
+  // Create new
+  lineal_wavefronts_t* const lineal_wavefronts =
+      lineal_wavefronts_new(pattern_length,text_length,penalties,mm_allocator);
+  // Reduction
+  affine_wavefronts_reduction_set_none(&lineal_wavefronts->reduction);
+  // Return
+  return lineal_wavefronts;
+}
+lineal_wavefronts_t* lineal_wavefronts_new_reduced(
+    const int pattern_length,
+    const int text_length,
+    lineal_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold,
+    mm_allocator_t* const mm_allocator) {
+  // Create new
+  lineal_wavefronts_t* const lineal_wavefronts =
+      lineal_wavefronts_new(pattern_length,text_length,penalties,mm_allocator);
+  // Reduction
+  affine_wavefronts_reduction_set_dynamic(
+      &lineal_wavefronts->reduction,min_wavefront_length,max_distance_threshold);
+  // Return
+  return lineal_wavefronts;
+}
+void lineal_wavefronts_clear(
+    lineal_wavefronts_t* const lineal_wavefronts) {
+  // Clear wavefronts (reverse order)
+  mm_allocator_t* const mm_allocator = lineal_wavefronts->mm_allocator;
+  lineal_wavefront_t** const mwavefronts = lineal_wavefronts->mwavefronts;
+  int i;
+  for (i=lineal_wavefronts->num_wavefronts-1;i>=0;--i) {
+    if (mwavefronts[i]!=NULL) {
+      mm_allocator_free(mm_allocator,mwavefronts[i]->offsets + mwavefronts[i]->lo_base);
+      mwavefronts[i] = NULL;
+    }
+  }
+  // Clear CIGAR
+  edit_cigar_clear(&lineal_wavefronts->edit_cigar);
+  // Clear bulk memory
+  lineal_wavefronts->wavefronts_current = lineal_wavefronts->wavefronts_mem;
+}
+void lineal_wavefronts_delete(
+    lineal_wavefronts_t* const lineal_wavefronts) {
+  // Parameters
+  mm_allocator_t* const mm_allocator = lineal_wavefronts->mm_allocator;
+  // Clear wavefronts
+  lineal_wavefronts_clear(lineal_wavefronts);
+  // CIGAR
+  edit_cigar_free(&lineal_wavefronts->edit_cigar,mm_allocator);
+  // Free wavefronts
+  mm_allocator_free(mm_allocator,lineal_wavefronts->wavefront_null.offsets - (lineal_wavefronts->pattern_length+1));
+  mm_allocator_free(mm_allocator,lineal_wavefronts->wavefronts_mem);
+  mm_allocator_free(mm_allocator,lineal_wavefronts->mwavefronts);
+  // Free handler
+  mm_allocator_free(mm_allocator,lineal_wavefronts);
+}
+/*
+ * Accessors
+ */
+lineal_wavefront_t* lineal_wavefronts_get_source_mwavefront(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const int score) {
+  if (score < 0) return &lineal_wavefronts->wavefront_null;
+  lineal_wavefront_t* const mwavefront = lineal_wavefronts->mwavefronts[score];
+  return (mwavefront == NULL || mwavefront->null) ? &lineal_wavefronts->wavefront_null : mwavefront;
+}
+lineal_wavefront_t* lineal_wavefronts_allocate_wavefront(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const int lo_base,
+    const int hi_base) {
+  // Allocate wavefront
+  lineal_wavefront_t* const wavefront = lineal_wavefronts->wavefronts_current;
+  ++(lineal_wavefronts->wavefronts_current); // Next
+  // Configure offsets
+  wavefront->null = false;
+  wavefront->lo = lo_base;
+  wavefront->hi = hi_base;
+  wavefront->lo_base = lo_base;
+  wavefront->hi_base = hi_base;
+  // Allocate offsets
+  const int wavefront_length = hi_base - lo_base + 1;
+  lwf_offset_t* const offsets_mem = mm_allocator_calloc(
+      lineal_wavefronts->mm_allocator,wavefront_length,lwf_offset_t,false);
+  wavefront->offsets = offsets_mem - lo_base; // Center at k=0
+  // Return
+  return wavefront;
+}
+/*
+ * Reduce wavefront
+ */
+int lineal_wavefronts_compute_distance(
+    const int pattern_length,
+    const int text_length,
+    const lwf_offset_t offset,
+    const int k) {
+  const int left_v = pattern_length - LINEAL_WAVEFRONT_V(k,offset);
+  const int left_h = text_length - LINEAL_WAVEFRONT_H(k,offset);
+  return MAX(left_v,left_h);
+}
+void lineal_wavefronts_reduce_wavefront(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const int pattern_length,
+    const int text_length,
+    const int score) {
+  // Parameters
+  const int min_wavefront_length = lineal_wavefronts->reduction.min_wavefront_length;
+  const int max_distance_threshold = lineal_wavefronts->reduction.max_distance_threshold;
+  const int alignment_k = LINEAL_WAVEFRONT_DIAGONAL(text_length,pattern_length);
+  // Fetch m-wavefront
+  lineal_wavefront_t* const mwavefront = lineal_wavefronts->mwavefronts[score];
+  if (mwavefront==NULL || mwavefront->null) return;
+  if ((mwavefront->hi - mwavefront->lo + 1) < min_wavefront_length) return;
+  // Compute min-distance
+  const lwf_offset_t* const offsets = mwavefront->offsets;
+  int min_distance = MAX(pattern_length,text_length);
+  int k;
+  for (k=mwavefront->lo;k<=mwavefront->hi;++k) {
+    const int distance = lineal_wavefronts_compute_distance(pattern_length,text_length,offsets[k],k);
+    min_distance = MIN(min_distance,distance);
+  }
+  // Reduce from bottom
+  const int top_limit = MIN(alignment_k-1,mwavefront->hi);
+  for (k=mwavefront->lo;k<top_limit;++k) {
+    const int distance = lineal_wavefronts_compute_distance(pattern_length,text_length,offsets[k],k);
+    if (distance - min_distance <= max_distance_threshold) break;
+    ++(mwavefront->lo);
+  }
+  // Reduce from top
+  const int botton_limit = MAX(alignment_k+1,mwavefront->lo);
+  for (k=mwavefront->hi;k>botton_limit;--k) {
+    const int distance = lineal_wavefronts_compute_distance(pattern_length,text_length,offsets[k],k);
+    if (distance - min_distance <= max_distance_threshold) break;
+    --(mwavefront->hi);
+  }
+  // Check hi/lo range
+  if (mwavefront->lo > mwavefront->hi) {
+    mwavefront->null = true;
+  }
+}
+/*
+ * Wavefront offset extension comparing characters
+ */
+void lineal_wavefronts_extend_packed(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length,
+    const int score) {
+  // Fetch m-wavefront
+  lineal_wavefront_t* const mwavefront = lineal_wavefronts->mwavefronts[score];
+  if (mwavefront==NULL) return;
+  // Extend diagonally each wavefront point
+  lwf_offset_t* const offsets = mwavefront->offsets;
+  int k;
+  for (k=mwavefront->lo;k<=mwavefront->hi;++k) {
+    // Fetch offset & positions
+    const lwf_offset_t offset = offsets[k];
+    const uint32_t h = LINEAL_WAVEFRONT_H(k,offset); // Make unsigned to avoid checking negative
+    if (h >= text_length) continue;
+    const uint32_t v = LINEAL_WAVEFRONT_V(k,offset); // Make unsigned to avoid checking negative
+    if (v >= pattern_length) continue;
+    // Fetch pattern/text blocks
+    uint64_t* pattern_blocks = (uint64_t*)(pattern+v);
+    uint64_t* text_blocks = (uint64_t*)(text+h);
+    uint64_t pattern_block = *pattern_blocks;
+    uint64_t text_block = *text_blocks;
+    // Compare 64-bits blocks
+    uint64_t cmp = pattern_block ^ text_block;
+    while (__builtin_expect(!cmp,0)) {
+      // Increment offset (full block)
+      offsets[k] += 8;
+      // Next blocks
+      ++pattern_blocks;
+      ++text_blocks;
+      // Fetch
+      pattern_block = *pattern_blocks;
+      text_block = *text_blocks;
+      // Compare
+      cmp = pattern_block ^ text_block;
+    }
+    // Count equal characters
+    const int equal_right_bits = __builtin_ctzl(cmp);
+    const int equal_chars = DIV_FLOOR(equal_right_bits,8);
+    // Increment offset
+    offsets[k] += equal_chars;
+  }
+  // Reduce wavefront dynamically
+  if (lineal_wavefronts->reduction.reduction_strategy == wavefronts_reduction_dynamic) {
+    lineal_wavefronts_reduce_wavefront(lineal_wavefronts,pattern_length,text_length,score);
+  }
+}
+/*
+ * Compute wavefront offsets
+ *   Offsets are kept within the DP-table, so that every stored offset
+ *   corresponds to a valid cell (transitions leaving the table are nullified)
+ */
+#define LINEAL_WAVEFRONT_DECLARE(wavefront,prefix) \
+  const lwf_offset_t* const prefix ## _offsets = wavefront->offsets; \
+  const int prefix ## _hi = wavefront->hi; \
+  const int prefix ## _lo = wavefront->lo
+#define LINEAL_WAVEFRONT_COND_FETCH(prefix,index,value) \
+  (prefix ## _lo <= (index) && (index) <= prefix ## _hi) ? (value) : LINEAL_WAVEFRONT_OFFSET_NULL
+#define LINEAL_WAVEFRONT_MAX_VALID(k,ins_value,del_value,sub_value) \
+  MAX( \
+    MAX( \
+      ((ins_value) > text_length) ? LINEAL_WAVEFRONT_OFFSET_NULL : (ins_value), \
+      (LINEAL_WAVEFRONT_V(k,del_value) > pattern_length) ? LINEAL_WAVEFRONT_OFFSET_NULL : (del_value)), \
+    ((sub_value) > text_length || LINEAL_WAVEFRONT_V(k,sub_value) > pattern_length) ? \
+      LINEAL_WAVEFRONT_OFFSET_NULL : (sub_value))
+void lineal_wavefronts_compute_offsets(
+    lineal_wavefront_t* const in_mwavefront_sub,
+    lineal_wavefront_t* const in_mwavefront_ins,
+    lineal_wavefront_t* const in_mwavefront_del,
+    lineal_wavefront_t* const out_mwavefront,
+    const int pattern_length,
+    const int text_length) {
+  // Parameters
+  LINEAL_WAVEFRONT_DECLARE(in_mwavefront_sub,m_sub);
+  LINEAL_WAVEFRONT_DECLARE(in_mwavefront_ins,m_ins);
+  LINEAL_WAVEFRONT_DECLARE(in_mwavefront_del,m_del);
+  lwf_offset_t* const out_moffsets = out_mwavefront->offsets;
+  const int lo = out_mwavefront->lo;
+  const int hi = out_mwavefront->hi;
+  // Compute loop peeling offset (min_hi)
+  int min_hi = hi;
+  if (!in_mwavefront_sub->null && min_hi > m_sub_hi) min_hi = m_sub_hi;
+  if (!in_mwavefront_ins->null && min_hi > m_ins_hi+1) min_hi = m_ins_hi+1;
+  if (!in_mwavefront_del->null && min_hi > m_del_hi-1) min_hi = m_del_hi-1;
+  // Compute loop peeling offset (max_lo)
+  int max_lo = lo;
+  if (!in_mwavefront_sub->null && max_lo < m_sub_lo) max_lo = m_sub_lo;
+  if (!in_mwavefront_ins->null && max_lo < m_ins_lo+1) max_lo = m_ins_lo+1;
+  if (!in_mwavefront_del->null && max_lo < m_del_lo-1) max_lo = m_del_lo-1;
+  // Compute score wavefronts (prologue)
+  int k;
+  for (k=lo;k<max_lo && k<=hi;++k) {
+    const lwf_offset_t ins = LINEAL_WAVEFRONT_COND_FETCH(m_ins,k-1,m_ins_offsets[k-1]+1);
+    const lwf_offset_t del = LINEAL_WAVEFRONT_COND_FETCH(m_del,k+1,m_del_offsets[k+1]);
+    const lwf_offset_t sub = LINEAL_WAVEFRONT_COND_FETCH(m_sub,k,m_sub_offsets[k]+1);
+    out_moffsets[k] = LINEAL_WAVEFRONT_MAX_VALID(k,ins,del,sub);
+  }
+  // Compute score wavefronts (core)
+#if defined(__clang__)
+  #pragma clang loop vectorize(enable)
+#elif defined(__GNUC__) || defined(__GNUG__)
+  #pragma GCC ivdep
+#else
+  #pragma ivdep
+#endif
+  for (k=max_lo;k<=min_hi;++k) {
+    const lwf_offset_t ins = m_ins_offsets[k-1] + 1;
+    const lwf_offset_t del = m_del_offsets[k+1];
+    const lwf_offset_t sub = m_sub_offsets[k] + 1;
+    out_moffsets[k] = LINEAL_WAVEFRONT_MAX_VALID(k,ins,del,sub);
+  }
+  // Compute score wavefronts (epilogue)
+  for (k=MAX(min_hi+1,max_lo);k<=hi;++k) {
+    const lwf_offset_t ins = LINEAL_WAVEFRONT_COND_FETCH(m_ins,k-1,m_ins_offsets[k-1]+1);
+    const lwf_offset_t del = LINEAL_WAVEFRONT_COND_FETCH(m_del,k+1,m_del_offsets[k+1]);
+    const lwf_offset_t sub = LINEAL_WAVEFRONT_COND_FETCH(m_sub,k,m_sub_offsets[k]+1);
+    out_moffsets[k] = LINEAL_WAVEFRONT_MAX_VALID(k,ins,del,sub);
+  }
+}
+void lineal_wavefronts_compute_wavefront(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const int pattern_length,
+    const int text_length,
+    const int score) {
+  // Fetch wavefronts
+  const lineal_penalties_t* const wavefront_penalties = &lineal_wavefronts->wavefront_penalties;
+  lineal_wavefront_t* const in_mwavefront_sub =
+      lineal_wavefronts_get_source_mwavefront(lineal_wavefronts,score-wavefront_penalties->mismatch);
+  lineal_wavefront_t* const in_mwavefront_ins =
+      lineal_wavefronts_get_source_mwavefront(lineal_wavefronts,score-wavefront_penalties->insertion);
+  lineal_wavefront_t* const in_mwavefront_del =
+      lineal_wavefronts_get_source_mwavefront(lineal_wavefronts,score-wavefront_penalties->deletion);
+  // Set limits
+  int lo = INT_MAX, hi = INT_MIN;
+  if (!in_mwavefront_sub->null) {
+    lo = MIN(lo,in_mwavefront_sub->lo);
+    hi = MAX(hi,in_mwavefront_sub->hi);
+  }
+  if (!in_mwavefront_ins->null) {
+    lo = MIN(lo,in_mwavefront_ins->lo+1);
+    hi = MAX(hi,in_mwavefront_ins->hi+1);
+  }
+  if (!in_mwavefront_del->null) {
+    lo = MIN(lo,in_mwavefront_del->lo-1);
+    hi = MAX(hi,in_mwavefront_del->hi-1);
+  }
+  // Trim to the diagonals of the DP-table
+  lo = MAX(lo,-pattern_length);
+  hi = MIN(hi,text_length);
+  if (lo > hi) return; // Null wavefronts (or out of the DP-table)
+  // Allocate & compute M-wavefront
+  lineal_wavefront_t* const out_mwavefront =
+      lineal_wavefronts_allocate_wavefront(lineal_wavefronts,lo,hi);
+  lineal_wavefronts->mwavefronts[score] = out_mwavefront;
+  lineal_wavefronts_compute_offsets(
+      in_mwavefront_sub,in_mwavefront_ins,in_mwavefront_del,
+      out_mwavefront,pattern_length,text_length);
+}
+/*
+ * Backtrace
+ */
+lwf_offset_t lineal_wavefronts_backtrace_offset(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const int score,
+    const int k) {
+  lineal_wavefront_t* const mwavefront = lineal_wavefronts_get_source_mwavefront(lineal_wavefronts,score);
+  return (mwavefront->lo <= k && k <= mwavefront->hi) ?
+      mwavefront->offsets[k] : LINEAL_WAVEFRONT_OFFSET_NULL;
+}
+void lineal_wavefronts_backtrace(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const int pattern_length,
+    const int text_length,
+    const int alignment_score) {
+  // Parameters
+  const lineal_penalties_t* const wavefront_penalties = &lineal_wavefronts->wavefront_penalties;
+  edit_cigar_t* const cigar = &lineal_wavefronts->edit_cigar;
+  char* const operations = cigar->operations;
+  // Compute starting location
+  int score = alignment_score;
+  int k = LINEAL_WAVEFRONT_DIAGONAL(text_length,pattern_length);
+  lwf_offset_t offset = lineal_wavefronts->mwavefronts[alignment_score]->offsets[k];
+  // Trace the alignment back
+  while (score > 0) {
+    // Compute scores
+    const int mismatch_score = score - wavefront_penalties->mismatch;
+    const int insertion_score = score - wavefront_penalties->insertion;
+    const int deletion_score = score - wavefront_penalties->deletion;
+    // Compute source offsets
+    const lwf_offset_t ins = lineal_wavefronts_backtrace_offset(lineal_wavefronts,insertion_score,k-1) + 1;
+    const lwf_offset_t del = lineal_wavefronts_backtrace_offset(lineal_wavefronts,deletion_score,k+1);
+    const lwf_offset_t sub = lineal_wavefronts_backtrace_offset(lineal_wavefronts,mismatch_score,k) + 1;
+    const lwf_offset_t max_all = LINEAL_WAVEFRONT_MAX_VALID(k,ins,del,sub);
+    // Traceback Matches
+    while (offset > max_all) {
+      operations[(cigar->begin_offset)--] = 'M';
+      --offset;
+    }
+    // Traceback Operation
+    if (max_all == sub) {
+      operations[(cigar->begin_offset)--] = 'X';
+      score = mismatch_score;
+      --offset;
+    } else if (max_all == ins) {
+      operations[(cigar->begin_offset)--] = 'I';
+      score = insertion_score;
+      --offset;
+      --k;
+    } else if (max_all == del) {
+      operations[(cigar->begin_offset)--] = 'D';
+      score = deletion_score;
+      ++k;
+    } else {
+      fprintf(stderr,"Backtrace error: No link found during backtrace\n");
+      exit(1);
+    }
+  }
+  // Account for last stroke of matches
+  while (offset > 0) {
+    operations[(cigar->begin_offset)--] = 'M';
+    --offset;
+  }
+  ++(cigar->begin_offset); // Set CIGAR length
+}
+/*
+ * Computation using Wavefronts
+ */
+void lineal_wavefronts_align(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length) {
+  // Init padded strings (offsets never leave the DP-table; only end padding is needed)
+  strings_padded_t* const strings_padded =
+      strings_padded_new(
+          pattern,pattern_length,text,text_length,
+          LINEAL_WAVEFRONT_PADDING,lineal_wavefronts->mm_allocator);
+  // Initialize wavefront
+  lineal_wavefronts->mwavefronts[0] = lineal_wavefronts_allocate_wavefront(lineal_wavefronts,0,0);
+  lineal_wavefronts->mwavefronts[0]->offsets[0] = 0;
+  // Compute wavefronts for increasing score
+  const int alignment_k = LINEAL_WAVEFRONT_DIAGONAL(text_length,pattern_length);
+  const int alignment_offset = LINEAL_WAVEFRONT_OFFSET(text_length,pattern_length);
+  int score = 0;
+  while (true) {
+    // Exact extend s-wavefront
+    lineal_wavefronts_extend_packed(
+        lineal_wavefronts,strings_padded->pattern_padded,pattern_length,
+        strings_padded->text_padded,text_length,score);
+    // Exit condition
+    lineal_wavefront_t* const mwavefront = lineal_wavefronts->mwavefronts[score];
+    if (mwavefront != NULL &&
+        mwavefront->lo <= alignment_k &&
+        alignment_k <= mwavefront->hi &&
+        mwavefront->offsets[alignment_k] >= alignment_offset) {
+      // Backtrace
+      lineal_wavefronts_backtrace(lineal_wavefronts,pattern_length,text_length,score);
+      break;
+    }
+    // Compute (s+1)-wavefront
+    ++score;
+    lineal_wavefronts_compute_wavefront(lineal_wavefronts,pattern_length,text_length,score);
+  }
+  // Free
+  strings_padded_delete(strings_padded);
+}
@@ -0,0 +1,130 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: Wavefront alignment algorithm for pairwise gap-lineal
+ *   alignment
+ */
+
+#ifndef LINEAL_WAVEFRONT_H_
+#define LINEAL_WAVEFRONT_H_
+
+#include "utils/commons.h"
+#include "system/mm_allocator.h"
+#include "edit/edit_cigar.h"
+#include "gap_lineal/lineal_penalties.h"
+#include "gap_affine/affine_wavefront_reduction.h"
+
+/*
+ * Constants
+ */
+#define LINEAL_WAVEFRONT_OFFSET_NULL (INT32_MIN/2)
+#define LINEAL_WAVEFRONT_PADDING     10
+
+/*
+ * Translate k and offset to coordinates h,v
+ */
+#define LINEAL_WAVEFRONT_V(k,offset) ((offset)-(k))
+#define LINEAL_WAVEFRONT_H(k,offset) (offset)
+
+#define LINEAL_WAVEFRONT_DIAGONAL(h,v) ((h)-(v))
+#define LINEAL_WAVEFRONT_OFFSET(h,v)   (h)
+
+/*
+ * Offset size
+ */
+typedef int32_t lwf_offset_t;
+
+/*
+ * Wavefront
+ */
+typedef struct {
+  // Range
+  bool null;                  // Is null interval?
+  int lo;                     // Effective lowest diagonal (inclusive)
+  int hi;                     // Effective highest diagonal (inclusive)
+  int lo_base;                // Lowest diagonal before reduction (inclusive)
+  int hi_base;                // Highest diagonal before reduction (inclusive)
+  // Offsets
+  lwf_offset_t* offsets;      // Offsets
+} lineal_wavefront_t;
+
+/*
+ * Gap-Lineal Wavefronts
+ */
+typedef struct {
+  // Dimensions
+  int pattern_length;                          // Pattern length
+  int text_length;                             // Text length
+  int num_wavefronts;                          // Total number of allocatable wavefronts
+  // Wavefronts
+  lineal_wavefront_t** mwavefronts;            // M-wavefronts
+  lineal_wavefront_t wavefront_null;           // Null wavefront (used to gain orthogonality)
+  // Reduction
+  affine_wavefronts_reduction_t reduction;     // Reduction parameters
+  // Penalties
+  lineal_penalties_t base_penalties;           // Input base Gap-Lineal penalties
+  lineal_penalties_t wavefront_penalties;      // Wavefront Gap-Lineal penalties (zero match)
+  // CIGAR
+  edit_cigar_t edit_cigar;                     // Alignment CIGAR
+  // MM
+  mm_allocator_t* mm_allocator;                // MM-Allocator
+  lineal_wavefront_t* wavefronts_mem;          // MM-Slab for lineal_wavefront_t (base)
+  lineal_wavefront_t* wavefronts_current;      // MM-Slab for lineal_wavefront_t (next)
+} lineal_wavefronts_t;
+
+/*
+ * Setup
+ */
+lineal_wavefronts_t* lineal_wavefronts_new_complete(
+    const int pattern_length,
+    const int text_length,
+    lineal_penalties_t* const penalties,
+    mm_allocator_t* const mm_allocator);
+lineal_wavefronts_t* lineal_wavefronts_new_reduced(
+    const int pattern_length,
+    const int text_length,
+    lineal_penalties_t* const penalties,
+    const int min_wavefront_length,
+    const int max_distance_threshold,
+    mm_allocator_t* const mm_allocator);
+void lineal_wavefronts_clear(
+    lineal_wavefronts_t* const lineal_wavefronts);
+void lineal_wavefronts_delete(
+    lineal_wavefronts_t* const lineal_wavefronts);
+
+/*
+ * Computation using Wavefronts
+ */
+void lineal_wavefronts_align(
+    lineal_wavefronts_t* const lineal_wavefronts,
+    const char* const pattern,
+    const int pattern_length,
+    const char* const text,
+    const int text_length);
+
+#endif /* LINEAL_WAVEFRONT_H_ */
@@ -33,6 +33,7 @@
  */
 
 #include "mm_allocator.h"
+#include <sys/mman.h>
 
 /*
  * Debug
@@ -47,14 +48,21 @@
 #define MM_ALLOCATOR_INITIAL_SEGMENTS              10
 #define MM_ALLOCATOR_INITIAL_MALLOC_REQUESTS       10
 #define MM_ALLOCATOR_INITIAL_STATES                10
+#define MM_ALLOCATOR_INITIAL_FREE_BLOCKS          100
+#define MM_ALLOCATOR_INITIAL_REMOTE_FREES          10
+#define MM_ALLOCATOR_INITIAL_THREADS               16
 
 /*
  * Allocator Segments Freed Cond
  */
 #define MM_ALLOCATOR_FREED_FLAG                 0x80000000ul
+#define MM_ALLOCATOR_LISTED_FLAG                0x40000000ul
 #define MM_ALLOCATOR_REQUEST_IS_FREE(request)  ((request)->size & MM_ALLOCATOR_FREED_FLAG)
 #define MM_ALLOCATOR_REQUEST_SET_FREE(request) ((request)->size |= MM_ALLOCATOR_FREED_FLAG)
-#define MM_ALLOCATOR_REQUEST_SIZE(request)     ((request)->size & ~(MM_ALLOCATOR_FREED_FLAG))
+#define MM_ALLOCATOR_REQUEST_IS_LISTED(request)  ((request)->size & MM_ALLOCATOR_LISTED_FLAG)
+#define MM_ALLOCATOR_REQUEST_SET_LISTED(request) ((request)->size |= MM_ALLOCATOR_LISTED_FLAG)
+#define MM_ALLOCATOR_REQUEST_SIZE(request) \
+  ((request)->size & ~(MM_ALLOCATOR_FREED_FLAG|MM_ALLOCATOR_LISTED_FLAG))
 
 /*
  * Reference (Header of every memory allocated)
@@ -70,6 +78,7 @@ typedef struct {
   // Request
   uint32_t offset;
   uint32_t size;
+  uint32_t ticket;              // Free-list ticket (valid if listed)
   // Log
 #ifdef MM_ALLOCATOR_LOG
   uint64_t timestamp;
@@ -81,6 +90,7 @@ typedef struct {
   // Request
   void* mem;
   uint64_t size;
+  mm_allocator_memory_t memory_mode;
   // Log
 #ifdef MM_ALLOCATOR_LOG
   uint64_t timestamp;
@@ -90,36 +100,241 @@ typedef struct {
   // MM Reference
   mm_allocator_reference_t* reference;
 } mm_malloc_request_t;
+/*
+ * Large Block (large-blocks cache entry)
+ */
+typedef struct {
+  void* mem;
+  uint64_t size;
+  mm_allocator_memory_t memory_mode;
+  bool zeroed;                  // Trimmed mapping (reads as zero)
+} mm_allocator_large_block_t;
+/*
+ * Free Block (free-list entry)
+ */
+typedef struct {
+  uint32_t segment_idx;
+  uint32_t request_idx;
+  uint32_t ticket;
+} mm_allocator_free_block_t;
 /*
  * Memory Segments
  */
 typedef struct {
   // Index (ID)
   uint64_t idx;                 // Index in the segments vector
+  uint64_t ticker;              // Fetch ticker (when it was last set as current)
   // Memory
   uint64_t size;                // Total memory available
   void* memory;                 // Memory
+  mm_allocator_memory_t memory_mode; // Memory kind
   uint64_t used;                // Bytes used (offset to memory next free byte)
+  uint64_t dirty;               // Bytes possibly written (beyond, fresh zero pages)
   // Requests
   vector_t* requests;           // Memory requests (mm_allocator_request_t)
 } mm_allocator_segment_t;
 
+/*
+ * Memory (heap or anonymous mappings)
+ */
+uint64_t mm_allocator_memory_size(
+    const mm_allocator_memory_t memory_mode,
+    const uint64_t size) {
+  if (memory_mode != mm_allocator_memory_hugepages) return size;
+  return (size + MM_ALLOCATOR_HUGEPAGE_SIZE - 1) & ~(MM_ALLOCATOR_HUGEPAGE_SIZE - 1);
+}
+void* mm_allocator_memory_try_allocate(
+    const mm_allocator_memory_t memory_mode,
+    const uint64_t size) {
+  if (memory_mode == mm_allocator_memory_malloc) return malloc(size);
+  // Map anonymous memory (kernel-zeroed)
+  const uint64_t mapped_size = mm_allocator_memory_size(memory_mode,size);
+  void* memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (memory_mode == mm_allocator_memory_hugepages) {
+    memory = mmap(NULL,mapped_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+  }
+#endif
+  if (memory == MAP_FAILED) { // No huge pages reserved (fallback to transparent huge pages)
+    memory = mmap(NULL,mapped_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (memory == MAP_FAILED) return NULL; // Refused by the system
+#ifdef MADV_HUGEPAGE
+    if (memory_mode == mm_allocator_memory_hugepages) madvise(memory,mapped_size,MADV_HUGEPAGE);
+#endif
+  }
+  return memory;
+}
+void* mm_allocator_memory_allocate(
+    const mm_allocator_memory_t memory_mode,
+    const uint64_t size) {
+  void* const memory = mm_allocator_memory_try_allocate(memory_mode,size);
+  if (memory == NULL) {
+    fprintf(stderr,"MMAllocator error. Could not allocate %" PRIu64 " bytes\n",size);
+    exit(1);
+  }
+  return memory;
+}
+void mm_allocator_memory_free(
+    const mm_allocator_memory_t memory_mode,
+    void* const memory,
+    const uint64_t size) {
+  if (memory_mode == mm_allocator_memory_malloc) {
+    free(memory);
+  } else {
+    munmap(memory,mm_allocator_memory_size(memory_mode,size));
+  }
+}
+/*
+ * Spinlock (short critical sections only)
+ */
+void mm_allocator_lock(bool* const lock) {
+  while (__atomic_test_and_set(lock,__ATOMIC_ACQUIRE)) {}
+}
+void mm_allocator_unlock(bool* const lock) {
+  __atomic_clear(lock,__ATOMIC_RELEASE);
+}
+/*
+ * Deferred frees (defined along with the allocator free)
+ */
+void mm_allocator_free_remote_requests(
+    mm_allocator_t* const mm_allocator);
+void mm_allocator_trim(
+    mm_allocator_t* const mm_allocator);
+/*
+ * Pool Segments (lock-free stacks of slots; tagged heads avoid ABA)
+ */
+#define MM_ALLOCATOR_POOL_HEAD(tag,slot_idx) ((((tag)+1) << 32) | ((uint64_t)(slot_idx)+1))
+#define MM_ALLOCATOR_POOL_HEAD_TAG(head)     ((head) >> 32)
+#define MM_ALLOCATOR_POOL_HEAD_SLOT(head)    ((uint32_t)(head))
+void mm_allocator_pool_push(
+    mm_allocator_pool_t* const mm_allocator_pool,
+    uint64_t* const head,
+    const uint32_t slot_idx) {
+  mm_allocator_pool_slot_t* const slot = mm_allocator_pool->slots + slot_idx;
+  uint64_t old_head = __atomic_load_n(head,__ATOMIC_ACQUIRE);
+  uint64_t new_head;
+  do {
+    __atomic_store_n(&slot->next,MM_ALLOCATOR_POOL_HEAD_SLOT(old_head),__ATOMIC_RELAXED);
+    new_head = MM_ALLOCATOR_POOL_HEAD(MM_ALLOCATOR_POOL_HEAD_TAG(old_head),slot_idx);
+  } while (!__atomic_compare_exchange_n(head,&old_head,new_head,true,__ATOMIC_RELEASE,__ATOMIC_ACQUIRE));
+}
+int64_t mm_allocator_pool_pop(
+    mm_allocator_pool_t* const mm_allocator_pool,
+    uint64_t* const head) {
+  uint64_t old_head = __atomic_load_n(head,__ATOMIC_ACQUIRE);
+  uint64_t new_head;
+  uint32_t top;
+  do {
+    top = MM_ALLOCATOR_POOL_HEAD_SLOT(old_head);
+    if (top == 0) return -1; // Empty
+    const uint32_t next = __atomic_load_n(&mm_allocator_pool->slots[top-1].next,__ATOMIC_RELAXED);
+    new_head = (MM_ALLOCATOR_POOL_HEAD_TAG(old_head)+1) << 32 | next;
+  } while (!__atomic_compare_exchange_n(head,&old_head,new_head,true,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE));
+  return top-1;
+}
+void* mm_allocator_pool_fetch_segment(
+    mm_allocator_pool_t* const mm_allocator_pool,
+    bool* const fresh_memory) {
+  // Steal a pooled segment
+  const int64_t slot_idx = mm_allocator_pool_pop(mm_allocator_pool,&mm_allocator_pool->segments_head);
+  if (slot_idx < 0) {
+    void* const memory = mm_allocator_memory_try_allocate(
+        mm_allocator_pool->memory_mode,mm_allocator_pool->segment_size);
+    if (memory == NULL) return NULL; // Refused by the system
+    __atomic_add_fetch(&mm_allocator_pool->segments_allocated,1,__ATOMIC_RELAXED);
+    *fresh_memory = (mm_allocator_pool->memory_mode != mm_allocator_memory_malloc);
+    return memory;
+  }
+  *fresh_memory = false;
+  void* const memory = mm_allocator_pool->slots[slot_idx].memory;
+  mm_allocator_pool_push(mm_allocator_pool,&mm_allocator_pool->empty_head,slot_idx);
+  __atomic_add_fetch(&mm_allocator_pool->segments_reused,1,__ATOMIC_RELAXED);
+  return memory;
+}
+void mm_allocator_pool_return_segment(
+    mm_allocator_pool_t* const mm_allocator_pool,
+    void* const memory) {
+  // Fetch an empty slot (or release the segment if the pool is full)
+  const int64_t slot_idx = mm_allocator_pool_pop(mm_allocator_pool,&mm_allocator_pool->empty_head);
+  if (slot_idx < 0) {
+    mm_allocator_memory_free(mm_allocator_pool->memory_mode,memory,mm_allocator_pool->segment_size);
+    return;
+  }
+  mm_allocator_pool->slots[slot_idx].memory = memory;
+  mm_allocator_pool_push(mm_allocator_pool,&mm_allocator_pool->segments_head,slot_idx);
+  __atomic_add_fetch(&mm_allocator_pool->segments_returned,1,__ATOMIC_RELAXED);
+}
+/*
+ * NUMA placement
+ */
+void mm_allocator_place_memory(
+    mm_allocator_t* const mm_allocator,
+    void* const memory,
+    const uint64_t size,
+    const bool touched) {
+  if (mm_allocator->numa_policy == mm_numa_default) return;
+  if (!mm_numa_set_memory_policy(memory,size,
+      mm_allocator->numa_policy,mm_allocator->numa_node,touched)) {
+    ++(mm_allocator->numa_failures);
+  }
+}
 /*
  * Segments
  */
+bool mm_allocator_segment_refill(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_segment_t* const segment) {
+  // Fetch memory from the pool
+  bool fresh_memory;
+  segment->memory = mm_allocator_pool_fetch_segment(mm_allocator->pool,&fresh_memory);
+  if (segment->memory == NULL) return false; // Refused by the system
+  segment->dirty = (fresh_memory) ? 0 : segment->size;
+  mm_allocator_place_memory(mm_allocator,segment->memory,segment->size,!fresh_memory);
+  return true;
+}
+void mm_allocator_segment_zero(
+    mm_allocator_segment_t* const segment,
+    const uint64_t offset,
+    const uint64_t num_bytes) {
+  // Clear the bytes possibly written (fresh pages are already zero)
+  if (offset < segment->dirty) {
+    memset(segment->memory+offset,0,MIN(num_bytes,segment->dirty-offset));
+  }
+}
 mm_allocator_segment_t* mm_allocator_segment_new(
     mm_allocator_t* const mm_allocator) {
-  // Allocate handler
+  // Allocate handler & requests
   mm_allocator_segment_t* const segment = (mm_allocator_segment_t*) malloc(sizeof(mm_allocator_segment_t));
+  if (segment == NULL) return NULL; // Refused by the system
+  segment->requests = vector_try_new(MM_ALLOCATOR_SEGMENT_INITIAL_REQUESTS,mm_allocator_request_t);
+  if (segment->requests == NULL) {
+    free(segment);
+    return NULL; // Refused by the system
+  }
   // Index
   const uint64_t segment_idx = vector_get_used(mm_allocator->segments);
   segment->idx = segment_idx;
+  segment->ticker = mm_allocator->segment_ticker;
   // Memory
   segment->size = mm_allocator->segment_size;
-  segment->memory = malloc(mm_allocator->segment_size);
+  segment->memory_mode = mm_allocator->memory_mode;
+  if (mm_allocator->pool != NULL) {
+    if (!mm_allocator_segment_refill(mm_allocator,segment)) {
+      vector_delete(segment->requests);
+      free(segment);
+      return NULL; // Refused by the system
+    }
+  } else {
+    segment->memory = mm_allocator_memory_try_allocate(segment->memory_mode,segment->size);
+    if (segment->memory == NULL) {
+      vector_delete(segment->requests);
+      free(segment);
+      return NULL; // Refused by the system
+    }
+    segment->dirty = (segment->memory_mode == mm_allocator_memory_malloc) ? segment->size : 0;
+    mm_allocator_place_memory(mm_allocator,segment->memory,segment->size,segment->dirty>0);
+  }
   segment->used = 0;
-  // Requests
-  segment->requests = vector_new(MM_ALLOCATOR_SEGMENT_INITIAL_REQUESTS,mm_allocator_request_t);
   // Add to segments
   vector_insert(mm_allocator->segments,segment,mm_allocator_segment_t*);
   // Return
@@ -131,11 +346,27 @@ void mm_allocator_segment_clear(
   vector_clear(segment->requests);
 }
 void mm_allocator_segment_delete(
+    mm_allocator_t* const mm_allocator,
     mm_allocator_segment_t* const segment) {
   vector_delete(segment->requests);
-  free(segment->memory);
+  if (mm_allocator->pool != NULL) {
+    if (segment->memory != NULL) mm_allocator_pool_return_segment(mm_allocator->pool,segment->memory);
+  } else {
+    mm_allocator_memory_free(segment->memory_mode,segment->memory,segment->size);
+  }
   free(segment);
 }
+void mm_allocator_add_segment_free(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_segment_t* const segment) {
+  // Return the segment memory to the pool (beyond the cached ones)
+  if (mm_allocator->pool != NULL && segment->memory != NULL &&
+      vector_get_used(mm_allocator->segments_free) >= MM_ALLOCATOR_POOL_CACHED_SEGMENTS) {
+    mm_allocator_pool_return_segment(mm_allocator->pool,segment->memory);
+    segment->memory = NULL;
+  }
+  vector_insert(mm_allocator->segments_free,segment,mm_allocator_segment_t*);
+}
 mm_allocator_request_t* mm_allocator_segment_get_request(
     mm_allocator_segment_t* const segment,
     const uint64_t request_idx) {
@@ -145,63 +376,558 @@ uint64_t mm_allocator_segment_get_num_requests(
     mm_allocator_segment_t* const segment) {
   return vector_get_used(segment->requests);
 }
+uint64_t mm_allocator_segment_get_bytes_used(
+    mm_allocator_segment_t* const segment,
+    const uint64_t first_request_idx) {
+  // Bytes of the requests (not freed) from the given one
+  const uint64_t num_requests = mm_allocator_segment_get_num_requests(segment);
+  mm_allocator_request_t* const requests = vector_get_mem(segment->requests,mm_allocator_request_t);
+  uint64_t i, bytes_used = 0;
+  for (i=first_request_idx;i<num_requests;++i) {
+    if (!MM_ALLOCATOR_REQUEST_IS_FREE(requests+i)) bytes_used += MM_ALLOCATOR_REQUEST_SIZE(requests+i);
+  }
+  return bytes_used;
+}
+/*
+ * Large-blocks cache
+ */
+void mm_allocator_large_cache_evict(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t max_blocks,
+    const uint64_t max_bytes) {
+  // Release the oldest blocks
+  const uint64_t num_blocks = vector_get_used(mm_allocator->large_blocks);
+  mm_allocator_large_block_t* const blocks =
+      vector_get_mem(mm_allocator->large_blocks,mm_allocator_large_block_t);
+  uint64_t i = 0;
+  while (i < num_blocks &&
+         (num_blocks-i > max_blocks || mm_allocator->large_blocks_bytes > max_bytes)) {
+    mm_allocator_memory_free(blocks[i].memory_mode,blocks[i].mem,blocks[i].size);
+    mm_allocator->large_blocks_bytes -= blocks[i].size;
+    ++i;
+  }
+  if (i > 0) {
+    memmove(blocks,blocks+i,(num_blocks-i)*sizeof(mm_allocator_large_block_t));
+    vector_set_used(mm_allocator->large_blocks,num_blocks-i);
+  }
+}
+void mm_allocator_set_large_cache(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t max_bytes,
+    const bool trim) {
+  if (max_bytes > 0 && mm_allocator->large_blocks == NULL) {
+    mm_allocator->large_blocks = vector_new(MM_ALLOCATOR_LARGE_CACHE_BLOCKS,mm_allocator_large_block_t);
+  }
+  if (mm_allocator->large_blocks != NULL) {
+    mm_allocator_large_cache_evict(mm_allocator,(max_bytes>0)?MM_ALLOCATOR_LARGE_CACHE_BLOCKS:0,max_bytes);
+    if (max_bytes == 0) {
+      vector_delete(mm_allocator->large_blocks);
+      mm_allocator->large_blocks = NULL;
+    }
+  }
+  mm_allocator->large_blocks_max_bytes = max_bytes;
+  mm_allocator->large_blocks_trim = trim;
+}
+void mm_allocator_large_cache_release(
+    mm_allocator_t* const mm_allocator,
+    mm_malloc_request_t* const request) {
+  // Release to the system (not cacheable)
+  if (mm_allocator->large_blocks == NULL || request->size > mm_allocator->large_blocks_max_bytes) {
+    mm_allocator_memory_free(request->memory_mode,request->mem,request->size);
+    return;
+  }
+  // Trim (keep the address range)
+  bool zeroed = false;
+  if (mm_allocator->large_blocks_trim) {
+    const bool mapped = (request->memory_mode != mm_allocator_memory_malloc); // Whole mapping
+    const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    const uintptr_t begin = ((uintptr_t)request->mem + page_size - 1) & ~(page_size - 1);
+    const uintptr_t end = (mapped) ?
+        (uintptr_t)request->mem + mm_allocator_memory_size(request->memory_mode,request->size) :
+        ((uintptr_t)request->mem + request->size) & ~(page_size - 1);
+    if (end > begin) {
+      zeroed = (madvise((void*)begin,end-begin,MADV_DONTNEED) == 0) && mapped;
+    }
+  }
+  // Cache (evict to fit)
+  mm_allocator_large_block_t large_block = {
+      .mem = request->mem,
+      .size = request->size,
+      .memory_mode = request->memory_mode,
+      .zeroed = zeroed,
+  };
+  vector_insert(mm_allocator->large_blocks,large_block,mm_allocator_large_block_t);
+  mm_allocator->large_blocks_bytes += request->size;
+  mm_allocator_large_cache_evict(mm_allocator,
+      MM_ALLOCATOR_LARGE_CACHE_BLOCKS,mm_allocator->large_blocks_max_bytes);
+}
+void* mm_allocator_large_cache_fetch(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    uint64_t* const block_size,
+    mm_allocator_memory_t* const memory_mode,
+    bool* const zeroed) {
+  // Best fit (wasting at most half of the block)
+  const uint64_t num_blocks = vector_get_used(mm_allocator->large_blocks);
+  mm_allocator_large_block_t* const blocks =
+      vector_get_mem(mm_allocator->large_blocks,mm_allocator_large_block_t);
+  uint64_t i, best = num_blocks;
+  for (i=0;i<num_blocks;++i) {
+    if (blocks[i].size < num_bytes || blocks[i].size/2 > num_bytes) continue;
+    if (best == num_blocks || blocks[i].size < blocks[best].size) best = i;
+  }
+  if (best == num_blocks) return NULL;
+  // Remove from the cache
+  void* const memory = blocks[best].mem;
+  *block_size = blocks[best].size;
+  *memory_mode = blocks[best].memory_mode;
+  *zeroed = blocks[best].zeroed;
+  mm_allocator->large_blocks_bytes -= blocks[best].size;
+  memmove(blocks+best,blocks+best+1,(num_blocks-best-1)*sizeof(mm_allocator_large_block_t));
+  vector_dec_used(mm_allocator->large_blocks);
+  ++(mm_allocator->large_blocks_reused);
+  return memory;
+}
+/*
+ * Budget
+ */
+void mm_allocator_set_budget(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t max_bytes) {
+  mm_allocator->budget = max_bytes;
+}
+bool mm_allocator_over_budget(
+    mm_allocator_t* const mm_allocator) {
+  return mm_allocator->budget > 0 && mm_allocator->stats.bytes_current > mm_allocator->budget;
+}
+/*
+ * Alignment
+ */
+void mm_allocator_set_alignment(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t alignment) {
+  if (alignment == 0 || (alignment & (alignment-1)) != 0 || alignment > MM_ALLOCATOR_ALIGNMENT_PAGE) {
+    fprintf(stderr,"MMAllocator error. Alignment must be a power of two (up to %d bytes)\n",
+        MM_ALLOCATOR_ALIGNMENT_PAGE);
+    exit(1);
+  }
+  mm_allocator->alignment = alignment;
+}
+/*
+ * Segments memory
+ */
+void mm_allocator_set_memory(
+    mm_allocator_t* const mm_allocator,
+    const mm_allocator_memory_t memory_mode) {
+  // Pooled allocators share the pool memory
+  if (mm_allocator->pool != NULL) {
+    fprintf(stderr,"MMAllocator error. Pooled allocators use the pool memory (mm_allocator_pool_set_memory)\n");
+    exit(1);
+  }
+  if (mm_allocator->memory_mode == memory_mode) return;
+  mm_allocator->memory_mode = memory_mode;
+  // Remap empty segments
+  VECTOR_ITERATE(mm_allocator->segments,segment_ptr,p,mm_allocator_segment_t*) {
+    mm_allocator_segment_t* const segment = *segment_ptr;
+    if (mm_allocator_segment_get_num_requests(segment) > 0) continue;
+    mm_allocator_memory_free(segment->memory_mode,segment->memory,segment->size);
+    segment->memory_mode = memory_mode;
+    segment->memory = mm_allocator_memory_allocate(memory_mode,segment->size);
+    segment->dirty = (memory_mode == mm_allocator_memory_malloc) ? segment->size : 0;
+    mm_allocator_place_memory(mm_allocator,segment->memory,segment->size,segment->dirty>0);
+  }
+}
+/*
+ * NUMA placement
+ */
+void mm_allocator_set_numa_policy(
+    mm_allocator_t* const mm_allocator,
+    const mm_numa_policy_t numa_policy,
+    const int numa_node) {
+  mm_allocator->numa_policy = numa_policy;
+  mm_allocator->numa_node = numa_node;
+  // Migrate the segments already allocated
+  VECTOR_ITERATE(mm_allocator->segments,segment_ptr,p,mm_allocator_segment_t*) {
+    mm_allocator_segment_t* const segment = *segment_ptr;
+    if (segment->memory == NULL) continue; // Returned to the pool
+    if (numa_policy == mm_numa_default) {
+      mm_numa_set_memory_policy(segment->memory,segment->size,mm_numa_default,0,false);
+    } else {
+      mm_allocator_place_memory(mm_allocator,segment->memory,segment->size,segment->dirty>0);
+    }
+  }
+}
+/*
+ * Free lists
+ */
+void mm_allocator_set_free_lists(
+    mm_allocator_t* const mm_allocator,
+    const bool enabled) {
+  if (enabled && mm_allocator->free_blocks == NULL) {
+    mm_allocator->free_blocks = malloc(MM_ALLOCATOR_SIZE_CLASSES*sizeof(vector_t*));
+    int i;
+    for (i=0;i<MM_ALLOCATOR_SIZE_CLASSES;++i) {
+      mm_allocator->free_blocks[i] = vector_new(MM_ALLOCATOR_INITIAL_FREE_BLOCKS,mm_allocator_free_block_t);
+    }
+  } else if (!enabled && mm_allocator->free_blocks != NULL) {
+    int i;
+    for (i=0;i<MM_ALLOCATOR_SIZE_CLASSES;++i) {
+      vector_delete(mm_allocator->free_blocks[i]);
+    }
+    free(mm_allocator->free_blocks);
+    mm_allocator->free_blocks = NULL;
+  }
+}
+void mm_allocator_flush_free_lists(
+    mm_allocator_t* const mm_allocator) {
+  if (mm_allocator->free_blocks == NULL) return;
+  int i;
+  for (i=0;i<MM_ALLOCATOR_SIZE_CLASSES;++i) {
+    vector_clear(mm_allocator->free_blocks[i]);
+  }
+}
+uint64_t mm_allocator_size_class(
+    const uint64_t num_bytes) {
+  // Largest class such that 2^class <= num_bytes
+  const uint64_t size_class = 63 - __builtin_clzl(num_bytes);
+  return MIN(size_class,MM_ALLOCATOR_SIZE_CLASSES-1);
+}
 /*
  * Setup
  */
-mm_allocator_t* mm_allocator_new(
-    const uint64_t segment_size) {
+mm_allocator_t* mm_allocator_new_(
+    const uint64_t segment_size,
+    mm_allocator_pool_t* const mm_allocator_pool) {
   // Allocate handler
   mm_allocator_t* const mm_allocator = (mm_allocator_t*) malloc(sizeof(mm_allocator_t));
   mm_allocator->request_ticker = 0;
+  // Pool
+  mm_allocator->memory_mode = (mm_allocator_pool != NULL) ?
+      mm_allocator_pool->memory_mode : mm_allocator_memory_malloc;
+  mm_allocator->pool = mm_allocator_pool;
+  mm_allocator->owner = pthread_self();
+  mm_allocator->orphan = false;
+  // NUMA
+  mm_allocator->numa_policy = mm_numa_default;
+  mm_allocator->numa_node = 0;
+  mm_allocator->numa_failures = 0;
+  mm_allocator->remote_frees = vector_new(MM_ALLOCATOR_INITIAL_REMOTE_FREES,void*);
+  mm_allocator->remote_frees_pending = 0;
+  mm_allocator->remote_frees_lock = false;
   // Segments
   mm_allocator->segment_size = segment_size;
+  mm_allocator->alignment = MM_ALLOCATOR_ALIGNMENT;
+  mm_allocator->segment_ticker = 0;
   mm_allocator->segments = vector_new(MM_ALLOCATOR_INITIAL_SEGMENTS,mm_allocator_segment_t*);
   mm_allocator->segments_free = vector_new(MM_ALLOCATOR_INITIAL_SEGMENTS,mm_allocator_segment_t*);
   // Allocate an initial segment
 #ifndef MM_ALLOCATOR_FORCE_MALLOC
 #ifndef MM_ALLOCATOR_DISABLE
-  mm_allocator_segment_new(mm_allocator);
+  if (mm_allocator_segment_new(mm_allocator) == NULL) {
+    fprintf(stderr,"MMAllocator error. Could not allocate the initial segment\n");
+    exit(1);
+  }
 #endif
 #endif
   mm_allocator->current_segment_idx = 0;
   // Malloc Memory
   mm_allocator->malloc_requests = vector_new(MM_ALLOCATOR_INITIAL_MALLOC_REQUESTS,mm_malloc_request_t);
   mm_allocator->malloc_requests_freed = 0;
+  // Stats
+  memset(&mm_allocator->stats,0,sizeof(mm_allocator_stats_t));
+  mm_allocator->callsites = NULL;
+  // Large-blocks cache (disabled)
+  mm_allocator->large_blocks = NULL;
+  mm_allocator->large_blocks_bytes = 0;
+  mm_allocator->large_blocks_max_bytes = 0;
+  mm_allocator->large_blocks_trim = false;
+  mm_allocator->large_blocks_reused = 0;
+  // Budget (unlimited)
+  mm_allocator->budget = 0;
+  mm_allocator->budget_refused = 0;
+  // Free lists (disabled)
+  mm_allocator->free_blocks = NULL;
+  mm_allocator->free_blocks_ticket = 0;
+  mm_allocator->free_blocks_listed = 0;
+  mm_allocator->free_blocks_reused = 0;
+  mm_allocator->free_bytes_reused = 0;
   // Return
   return mm_allocator;
 }
+mm_allocator_t* mm_allocator_new(
+    const uint64_t segment_size) {
+  return mm_allocator_new_(segment_size,NULL);
+}
+mm_allocator_t* mm_allocator_new_pooled(
+    mm_allocator_pool_t* const mm_allocator_pool) {
+  return mm_allocator_new_(mm_allocator_pool->segment_size,mm_allocator_pool);
+}
 void mm_allocator_clear(
     mm_allocator_t* const mm_allocator) {
+  // Apply deferred frees (from other threads)
+  mm_allocator_free_remote_requests(mm_allocator);
   // Clear segments
   vector_clear(mm_allocator->segments_free);
   VECTOR_ITERATE(mm_allocator->segments,segment_ptr,p,mm_allocator_segment_t*) {
     mm_allocator_segment_clear(*segment_ptr); // Clear segment
-    vector_insert(mm_allocator->segments_free,*segment_ptr,mm_allocator_segment_t*); // Add to free segments
+    if ((*segment_ptr)->idx == 0) continue; // Current segment
+    mm_allocator_add_segment_free(mm_allocator,*segment_ptr); // Add to free segments
   }
   mm_allocator->current_segment_idx = 0;
   // Clear malloc memory
   VECTOR_ITERATE(mm_allocator->malloc_requests,malloc_request,m,mm_malloc_request_t) {
-    if (malloc_request->size > 0) free(malloc_request->mem); // Free malloc requests
+    if (malloc_request->size > 0) { // Free malloc requests
+      mm_allocator_large_cache_release(mm_allocator,malloc_request);
+    }
   }
   vector_clear(mm_allocator->malloc_requests);
   mm_allocator->malloc_requests_freed = 0;
+  // Clear free lists (memory already released)
+  mm_allocator_flush_free_lists(mm_allocator);
+  // Stats
+  mm_allocator->stats.bytes_current = 0;
 }
 void mm_allocator_delete(
     mm_allocator_t* const mm_allocator) {
   // Free segments
   VECTOR_ITERATE(mm_allocator->segments,segment_ptr,p,mm_allocator_segment_t*) {
-    mm_allocator_segment_delete(*segment_ptr);
+    mm_allocator_segment_delete(mm_allocator,*segment_ptr);
   }
   vector_delete(mm_allocator->segments);
   vector_delete(mm_allocator->segments_free);
   // Free malloc memory
   VECTOR_ITERATE(mm_allocator->malloc_requests,malloc_request,m,mm_malloc_request_t) {
-    if (malloc_request->size > 0) free(malloc_request->mem); // Free malloc requests
+    if (malloc_request->size > 0) { // Free malloc requests
+      mm_allocator_memory_free(malloc_request->memory_mode,malloc_request->mem,malloc_request->size);
+    }
   }
   vector_delete(mm_allocator->malloc_requests);
+  // Free lists & large-blocks cache
+  mm_allocator_set_free_lists(mm_allocator,false);
+  mm_allocator_set_large_cache(mm_allocator,0,false);
+  // Deferred frees
+  vector_delete(mm_allocator->remote_frees);
+  // Stats
+  mm_allocator_set_callsite_stats(mm_allocator,false);
   // Free handler
   free(mm_allocator);
 }
+/*
+ * Stats
+ */
+void mm_allocator_stats_callsite(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    const char* const func_name,
+    const uint64_t line_no) {
+  // Hash callsite (open addressing)
+  uint64_t pos = (((uintptr_t)func_name >> 3) ^ (line_no * 0x9E3779B1ul)) % MM_ALLOCATOR_CALLSITES;
+  uint64_t i;
+  for (i=0;i<MM_ALLOCATOR_CALLSITES;++i) {
+    mm_allocator_callsite_t* const callsite = mm_allocator->callsites + pos;
+    if (callsite->func_name == NULL) { // New callsite
+      callsite->func_name = func_name;
+      callsite->line_no = line_no;
+    }
+    if (callsite->func_name == func_name && callsite->line_no == line_no) {
+      ++(callsite->num_requests);
+      callsite->num_bytes += num_bytes;
+      return;
+    }
+    pos = (pos+1) % MM_ALLOCATOR_CALLSITES;
+  }
+  // Table full (callsite not tracked)
+}
+void mm_allocator_stats_allocate(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    const char* const func_name,
+    const uint64_t line_no) {
+  mm_allocator_stats_t* const stats = &mm_allocator->stats;
+  ++(stats->num_requests);
+  stats->num_bytes_requested += num_bytes;
+  ++(stats->size_histogram[mm_allocator_size_class(num_bytes)]);
+  if (stats->bytes_current > stats->bytes_peak) stats->bytes_peak = stats->bytes_current;
+  if (mm_allocator->callsites != NULL) {
+    mm_allocator_stats_callsite(mm_allocator,num_bytes,func_name,line_no);
+  }
+}
+void mm_allocator_get_stats(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_stats_t* const stats) {
+  *stats = mm_allocator->stats;
+  stats->num_segments = vector_get_used(mm_allocator->segments);
+}
+void mm_allocator_reset_stats(
+    mm_allocator_t* const mm_allocator) {
+  // Keep the memory currently allocated (peak restarts from it)
+  const uint64_t bytes_current = mm_allocator->stats.bytes_current;
+  memset(&mm_allocator->stats,0,sizeof(mm_allocator_stats_t));
+  mm_allocator->stats.bytes_current = bytes_current;
+  mm_allocator->stats.bytes_peak = bytes_current;
+  if (mm_allocator->callsites != NULL) {
+    memset(mm_allocator->callsites,0,MM_ALLOCATOR_CALLSITES*sizeof(mm_allocator_callsite_t));
+  }
+}
+void mm_allocator_set_callsite_stats(
+    mm_allocator_t* const mm_allocator,
+    const bool enabled) {
+  if (enabled && mm_allocator->callsites == NULL) {
+    mm_allocator->callsites = calloc(MM_ALLOCATOR_CALLSITES,sizeof(mm_allocator_callsite_t));
+  } else if (!enabled && mm_allocator->callsites != NULL) {
+    free(mm_allocator->callsites);
+    mm_allocator->callsites = NULL;
+  }
+}
+/*
+ * Pool
+ */
+void mm_allocator_pool_reclaim_orphans(
+    mm_allocator_pool_t* const mm_allocator_pool) {
+  // Apply the deferred frees of the orphans (under the pool lock) and delete the emptied ones
+  uint64_t num_orphans = vector_get_used(mm_allocator_pool->orphan_allocators);
+  mm_allocator_t** const orphans = vector_get_mem(mm_allocator_pool->orphan_allocators,mm_allocator_t*);
+  uint64_t i = 0;
+  while (i < num_orphans) {
+    mm_allocator_free_remote_requests(orphans[i]);
+    if (orphans[i]->stats.bytes_current > 0) {
+      ++i;
+      continue;
+    }
+    mm_allocator_delete(orphans[i]);
+    orphans[i] = orphans[--num_orphans];
+    vector_dec_used(mm_allocator_pool->orphan_allocators);
+  }
+}
+void mm_allocator_pool_thread_exit(
+    void* const mm_allocator_ptr) {
+  mm_allocator_t* const mm_allocator = (mm_allocator_t*) mm_allocator_ptr;
+  mm_allocator_pool_t* const mm_allocator_pool = mm_allocator->pool;
+  // Apply deferred frees (from other threads)
+  mm_allocator_free_remote_requests(mm_allocator);
+  // Remove from the live thread allocators
+  mm_allocator_lock(&mm_allocator_pool->thread_allocators_lock);
+  const uint64_t num_allocators = vector_get_used(mm_allocator_pool->thread_allocators);
+  mm_allocator_t** const allocators = vector_get_mem(mm_allocator_pool->thread_allocators,mm_allocator_t*);
+  uint64_t i;
+  for (i=0;i<num_allocators;++i) {
+    if (allocators[i] == mm_allocator) {
+      allocators[i] = allocators[num_allocators-1];
+      vector_dec_used(mm_allocator_pool->thread_allocators);
+      break;
+    }
+  }
+  // Keep it as an orphan while other threads may still hold its memory
+  if (mm_allocator->stats.bytes_current > 0) {
+    __atomic_store_n(&mm_allocator->orphan,true,__ATOMIC_RELEASE);
+    vector_insert(mm_allocator_pool->orphan_allocators,mm_allocator,mm_allocator_t*);
+    mm_allocator_unlock(&mm_allocator_pool->thread_allocators_lock);
+    return;
+  }
+  mm_allocator_unlock(&mm_allocator_pool->thread_allocators_lock);
+  // Return its segments to the pool
+  mm_allocator_delete(mm_allocator);
+}
+mm_allocator_pool_t* mm_allocator_pool_new(
+    const uint64_t segment_size,
+    const uint32_t max_segments) {
+  // Allocate handler
+  mm_allocator_pool_t* const mm_allocator_pool = (mm_allocator_pool_t*) malloc(sizeof(mm_allocator_pool_t));
+  // Segments
+  mm_allocator_pool->segment_size = segment_size;
+  mm_allocator_pool->max_segments = max_segments;
+  mm_allocator_pool->memory_mode = mm_allocator_memory_malloc;
+  mm_allocator_pool->slots = (mm_allocator_pool_slot_t*) malloc((max_segments+1)*sizeof(mm_allocator_pool_slot_t));
+  mm_allocator_pool->segments_head = 0;
+  mm_allocator_pool->empty_head = 0;
+  uint32_t i;
+  for (i=0;i<max_segments;++i) {
+    mm_allocator_pool->slots[i].memory = NULL;
+    mm_allocator_pool_push(mm_allocator_pool,&mm_allocator_pool->empty_head,i);
+  }
+  // Thread allocators
+  if (pthread_key_create(&mm_allocator_pool->thread_key,mm_allocator_pool_thread_exit) != 0) {
+    fprintf(stderr,"MMAllocator error. Could not create thread-local key\n");
+    exit(1);
+  }
+  mm_allocator_pool->thread_allocators = vector_new(MM_ALLOCATOR_INITIAL_THREADS,mm_allocator_t*);
+  mm_allocator_pool->orphan_allocators = vector_new(MM_ALLOCATOR_INITIAL_THREADS,mm_allocator_t*);
+  mm_allocator_pool->thread_allocators_lock = false;
+  // Stats
+  mm_allocator_pool->segments_allocated = 0;
+  mm_allocator_pool->segments_reused = 0;
+  mm_allocator_pool->segments_returned = 0;
+  // Return
+  return mm_allocator_pool;
+}
+void mm_allocator_pool_delete(
+    mm_allocator_pool_t* const mm_allocator_pool) {
+  // Delete the thread allocators still alive (their threads must not use them anymore)
+  pthread_key_delete(mm_allocator_pool->thread_key);
+  VECTOR_ITERATE(mm_allocator_pool->thread_allocators,mm_allocator,m,mm_allocator_t*) {
+    mm_allocator_delete(*mm_allocator);
+  }
+  vector_delete(mm_allocator_pool->thread_allocators);
+  VECTOR_ITERATE(mm_allocator_pool->orphan_allocators,orphan,o,mm_allocator_t*) {
+    mm_allocator_delete(*orphan);
+  }
+  vector_delete(mm_allocator_pool->orphan_allocators);
+  // Free pooled segments
+  int64_t slot_idx;
+  while ((slot_idx=mm_allocator_pool_pop(mm_allocator_pool,&mm_allocator_pool->segments_head)) >= 0) {
+    mm_allocator_memory_free(mm_allocator_pool->memory_mode,
+        mm_allocator_pool->slots[slot_idx].memory,mm_allocator_pool->segment_size);
+  }
+  free(mm_allocator_pool->slots);
+  free(mm_allocator_pool);
+}
+void mm_allocator_pool_set_memory(
+    mm_allocator_pool_t* const mm_allocator_pool,
+    const mm_allocator_memory_t memory_mode) {
+  // Only before any segment is served
+  if (vector_get_used(mm_allocator_pool->thread_allocators) > 0 ||
+      __atomic_load_n(&mm_allocator_pool->segments_allocated,__ATOMIC_RELAXED) > 0) {
+    fprintf(stderr,"MMAllocator error. Pool memory must be set before serving segments\n");
+    exit(1);
+  }
+  mm_allocator_pool->memory_mode = memory_mode;
+}
+mm_allocator_t* mm_allocator_pool_get_allocator(
+    mm_allocator_pool_t* const mm_allocator_pool) {
+  // Fetch the thread allocator
+  mm_allocator_t* mm_allocator = (mm_allocator_t*) pthread_getspecific(mm_allocator_pool->thread_key);
+  if (mm_allocator != NULL) return mm_allocator;
+  // First request from this thread (adopt an orphan, if any still holds memory)
+  mm_allocator_lock(&mm_allocator_pool->thread_allocators_lock);
+  mm_allocator_pool_reclaim_orphans(mm_allocator_pool);
+  const uint64_t num_orphans = vector_get_used(mm_allocator_pool->orphan_allocators);
+  if (num_orphans > 0) {
+    mm_allocator = *vector_get_elm(mm_allocator_pool->orphan_allocators,num_orphans-1,mm_allocator_t*);
+    vector_dec_used(mm_allocator_pool->orphan_allocators);
+    mm_allocator->owner = pthread_self();
+    __atomic_store_n(&mm_allocator->orphan,false,__ATOMIC_RELEASE);
+  } else {
+    mm_allocator = mm_allocator_new_pooled(mm_allocator_pool);
+  }
+  vector_insert(mm_allocator_pool->thread_allocators,mm_allocator,mm_allocator_t*);
+  mm_allocator_unlock(&mm_allocator_pool->thread_allocators_lock);
+  pthread_setspecific(mm_allocator_pool->thread_key,mm_allocator);
+  return mm_allocator;
+}
+void mm_allocator_pool_trim(
+    mm_allocator_pool_t* const mm_allocator_pool) {
+  // Trim the thread allocators (their threads must be parked)
+  mm_allocator_lock(&mm_allocator_pool->thread_allocators_lock);
+  VECTOR_ITERATE(mm_allocator_pool->thread_allocators,mm_allocator,m,mm_allocator_t*) {
+    mm_allocator_trim(*mm_allocator);
+  }
+  // Reclaim the orphans (trimmed like the thread allocators)
+  mm_allocator_pool_reclaim_orphans(mm_allocator_pool);
+  VECTOR_ITERATE(mm_allocator_pool->orphan_allocators,orphan,o,mm_allocator_t*) {
+    mm_allocator_trim(*orphan);
+  }
+  mm_allocator_unlock(&mm_allocator_pool->thread_allocators_lock);
+}
 /*
  * Accessors
  */
@@ -226,6 +952,14 @@ uint64_t mm_allocator_get_num_segments_free(
 /*
  * Allocate
  */
+void* mm_allocator_align_memory(
+    void* const memory_base,
+    const uint64_t align_bytes) {
+  // Leave room for the reference (header) and align
+  void* const memory = memory_base + sizeof(mm_allocator_reference_t);
+  if (align_bytes <= 1) return memory;
+  return (void*)(((uintptr_t)memory + (align_bytes-1)) & ~((uintptr_t)align_bytes-1));
+}
 mm_allocator_segment_t* mm_allocator_fetch_segment(
     mm_allocator_t* const mm_allocator,
     const uint64_t num_bytes) {
@@ -249,37 +983,129 @@ mm_allocator_segment_t* mm_allocator_fetch_segment(
   if (free_segments > 0) {
     mm_allocator_segment_t* const segment =
         mm_allocator_get_segment_free(mm_allocator,free_segments-1);
+    if (segment->memory == NULL) { // Returned to the pool
+      if (!mm_allocator_segment_refill(mm_allocator,segment)) return NULL; // Refused (try malloc)
+    }
     vector_dec_used(mm_allocator->segments_free);
     mm_allocator->current_segment_idx = segment->idx;
+    segment->ticker = ++(mm_allocator->segment_ticker);
     return segment;
   }
   // Allocate new segment
+  ++(mm_allocator->segment_ticker);
   mm_allocator_segment_t* const segment = mm_allocator_segment_new(mm_allocator);
+  if (segment == NULL) return NULL; // Refused by the system (try malloc)
   mm_allocator->current_segment_idx = segment->idx;
   return segment;
 }
-void* mm_allocator_allocate(
+mm_allocator_request_t* mm_allocator_fetch_free_block(
     mm_allocator_t* const mm_allocator,
     const uint64_t num_bytes,
+    mm_allocator_segment_t** const segment_found,
+    uint64_t* const request_idx_found) {
+  // Smallest class whose blocks always fit the request (2^class >= num_bytes)
+  uint64_t size_class = mm_allocator_size_class(num_bytes);
+  if ((1ul << size_class) < num_bytes) ++size_class;
+  const uint64_t num_segments = mm_allocator_get_num_segments(mm_allocator);
+  for (;size_class<MM_ALLOCATOR_SIZE_CLASSES;++size_class) {
+    vector_t* const free_blocks = mm_allocator->free_blocks[size_class];
+    while (vector_get_used(free_blocks) > 0) {
+      // Pop block
+      mm_allocator_free_block_t* const free_block = vector_get_last_elm(free_blocks,mm_allocator_free_block_t);
+      vector_dec_used(free_blocks);
+      // Check stale entry (block trimmed, reused, or segment cleared)
+      if (free_block->segment_idx >= num_segments) continue;
+      mm_allocator_segment_t* const segment = mm_allocator_get_segment(mm_allocator,free_block->segment_idx);
+      if (free_block->request_idx >= mm_allocator_segment_get_num_requests(segment)) continue;
+      mm_allocator_request_t* const request =
+          mm_allocator_segment_get_request(segment,free_block->request_idx);
+      if (!MM_ALLOCATOR_REQUEST_IS_LISTED(request) || request->ticket != free_block->ticket) continue;
+      // Return block
+      *segment_found = segment;
+      *request_idx_found = free_block->request_idx;
+      return request;
+    }
+  }
+  return NULL;
+}
+void* mm_allocator_allocate_free_block(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes_allocated,
     const bool zero_mem,
-    const uint64_t align_bytes
+    const uint64_t align_bytes,
+    const char* func_name,
+    uint64_t line_no) {
+  // Fetch free block
+  mm_allocator_segment_t* segment;
+  uint64_t request_idx;
+  mm_allocator_request_t* const request = mm_allocator_fetch_free_block(
+      mm_allocator,num_bytes_allocated,&segment,&request_idx);
+  if (request == NULL) return NULL;
+  // Allocate memory (keeps the block size)
+  request->size = MM_ALLOCATOR_REQUEST_SIZE(request);
+  void* const memory_base = segment->memory + request->offset;
+  if (zero_mem) mm_allocator_segment_zero(segment,request->offset,request->size); // Set zero
+  // Compute aligned memory
+  void* const memory_aligned = mm_allocator_align_memory(memory_base,align_bytes);
+  // Set mm_reference
+  mm_allocator_reference_t* const mm_reference = (mm_allocator_reference_t*)(memory_aligned - sizeof(mm_allocator_reference_t));
+  mm_reference->segment_idx = segment->idx;
+  mm_reference->request_idx = request_idx;
 #ifdef MM_ALLOCATOR_LOG
-    ,const char* func_name,
-    uint64_t line_no
+  request->timestamp = (mm_allocator->request_ticker)++;
+  request->func_name = (char*)func_name;
+  request->line_no = line_no;
 #endif
-    ) {
+  // Stats
+  ++(mm_allocator->free_blocks_reused);
+  mm_allocator->free_bytes_reused += request->size;
+  mm_allocator->stats.bytes_current += request->size;
+  // Return memory
+  return memory_aligned;
+}
+void* mm_allocator_allocate_memory(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    const bool zero_mem,
+    const uint64_t align_bytes,
+    const bool try_allocate,
+    const char* func_name,
+    uint64_t line_no) {
 #ifdef MM_ALLOCATOR_DISABLE
-  void* memory = calloc(1,num_bytes);
+  void* memory;
+  if (posix_memalign(&memory,MAX(align_bytes,sizeof(void*)),num_bytes) != 0) {
+    if (try_allocate) return NULL; // Refused by the system
+    fprintf(stderr,"MMAllocator error. Could not allocate memory (%" PRIu64 " bytes)\n",num_bytes);
+    exit(1);
+  }
   if (zero_mem) memset(memory,0,num_bytes); // Set zero
-  return memory; // TODO: alignment
+  return memory;
 #else
   // Zero check
   if (num_bytes == 0) {
     fprintf(stderr,"MMAllocator error. Zero bytes requested\n");
     exit(1);
   }
+  // Alignment check
+  if ((align_bytes & (align_bytes-1)) != 0 || align_bytes > MM_ALLOCATOR_ALIGNMENT_PAGE) {
+    fprintf(stderr,"MMAllocator error. Invalid alignment (%" PRIu64 " bytes)\n",align_bytes);
+    exit(1);
+  }
+  // Apply deferred frees (from other threads)
+  if (__atomic_load_n(&mm_allocator->remote_frees_pending,__ATOMIC_ACQUIRE) > 0) {
+    mm_allocator_free_remote_requests(mm_allocator);
+  }
   // Add payload
   const uint64_t num_bytes_allocated = num_bytes + sizeof(mm_allocator_reference_t) + align_bytes;
+  // Reuse a freed block (if free lists are enabled)
+  if (mm_allocator->free_blocks != NULL) {
+    void* const memory = mm_allocator_allocate_free_block(
+        mm_allocator,num_bytes_allocated,zero_mem,align_bytes,func_name,line_no);
+    if (memory != NULL) {
+      mm_allocator_stats_allocate(mm_allocator,num_bytes,func_name,line_no);
+      return memory;
+    }
+  }
   // Fetch segment
 #ifdef MM_ALLOCATOR_FORCE_MALLOC
   mm_allocator_segment_t* const segment = NULL; // Force malloc memory
@@ -289,12 +1115,10 @@ void* mm_allocator_allocate(
   if (segment != NULL) {
     // Allocate memory
     void* const memory_base = segment->memory + segment->used;
-    if (zero_mem) memset(memory_base,0,num_bytes_allocated); // Set zero
-    // Compute aligned memory
-    void* memory_aligned = memory_base + sizeof(mm_allocator_reference_t) + align_bytes;
-    if (align_bytes > 0) {
-      memory_aligned = memory_aligned - ((uintptr_t)memory_aligned % align_bytes);
-    }
+    // Compute aligned memory (only the padding needed at this position)
+    void* const memory_aligned = mm_allocator_align_memory(memory_base,align_bytes);
+    const uint64_t num_bytes_used = (memory_aligned - memory_base) + num_bytes;
+    if (zero_mem) mm_allocator_segment_zero(segment,segment->used,num_bytes_used); // Set zero
     // Set mm_reference
     mm_allocator_reference_t* const mm_reference = (mm_allocator_reference_t*)(memory_aligned - sizeof(mm_allocator_reference_t));
     mm_reference->segment_idx = segment->idx;
@@ -303,25 +1127,44 @@ void* mm_allocator_allocate(
     mm_allocator_request_t* request;
     vector_alloc_new(segment->requests,mm_allocator_request_t,request);
     request->offset = segment->used;
-    request->size = num_bytes_allocated;
+    request->size = num_bytes_used;
 #ifdef MM_ALLOCATOR_LOG
     request->timestamp = (mm_allocator->request_ticker)++;
     request->func_name = (char*)func_name;
     request->line_no = line_no;
 #endif
     // Update segment
-    segment->used += num_bytes_allocated;
+    segment->used += num_bytes_used;
+    segment->dirty = MAX(segment->dirty,segment->used);
+    // Stats
+    mm_allocator->stats.bytes_current += num_bytes_used;
+    mm_allocator_stats_allocate(mm_allocator,num_bytes,func_name,line_no);
     // Return memory
     return memory_aligned;
   } else {
-    // Malloc memory
-    void* const memory_base = malloc(num_bytes_allocated);
-    if (zero_mem) memset(memory_base,0,num_bytes_allocated); // Set zero
-    // Compute aligned memory
-    void* memory_aligned = memory_base + sizeof(mm_allocator_reference_t) + align_bytes;
-    if (align_bytes > 0) {
-      memory_aligned = memory_aligned - ((uintptr_t)memory_aligned % align_bytes);
+    // Malloc memory (reuse a cached large block, if any)
+    uint64_t block_size = num_bytes_allocated;
+    mm_allocator_memory_t memory_mode = mm_allocator->memory_mode;
+    bool zeroed = false;
+    void* memory_base = NULL;
+    if (mm_allocator->large_blocks != NULL) {
+      memory_base = mm_allocator_large_cache_fetch(
+          mm_allocator,num_bytes_allocated,&block_size,&memory_mode,&zeroed);
     }
+    if (memory_base == NULL) {
+      memory_base = mm_allocator_memory_try_allocate(memory_mode,block_size);
+      if (memory_base == NULL) {
+        if (try_allocate) return NULL; // Refused by the system
+        fprintf(stderr,"MMAllocator error. Could not allocate %" PRIu64 " bytes\n",block_size);
+        exit(1);
+      }
+      mm_allocator_place_memory(mm_allocator,memory_base,block_size,
+          memory_mode == mm_allocator_memory_malloc);
+      zeroed = (memory_mode != mm_allocator_memory_malloc);
+    }
+    if (zero_mem && !zeroed) memset(memory_base,0,num_bytes_allocated); // Set zero
+    // Compute aligned memory
+    void* const memory_aligned = mm_allocator_align_memory(memory_base,align_bytes);
     // Set reference
     mm_allocator_reference_t* const mm_reference = (mm_allocator_reference_t*)(memory_aligned - sizeof(mm_allocator_reference_t));
     mm_reference->segment_idx = UINT32_MAX;
@@ -330,21 +1173,72 @@ void* mm_allocator_allocate(
     mm_malloc_request_t* request;
     vector_alloc_new(mm_allocator->malloc_requests,mm_malloc_request_t,request);
     request->mem = memory_base;
-    request->size = num_bytes_allocated;
+    request->size = block_size;
+    request->memory_mode = memory_mode;
 #ifdef MM_ALLOCATOR_LOG
     request->timestamp = (mm_allocator->request_ticker)++;
     request->func_name = (char*)func_name;
     request->line_no = line_no;
 #endif
     request->reference = mm_reference;
+    // Stats
+    mm_allocator->stats.bytes_current += block_size;
+    ++(mm_allocator->stats.malloc_requests);
+    mm_allocator->stats.malloc_bytes += block_size;
+    mm_allocator_stats_allocate(mm_allocator,num_bytes,func_name,line_no);
     // Return memory
     return memory_aligned;
   }
 #endif
 }
+void* mm_allocator_allocate(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    const bool zero_mem,
+    const uint64_t align_bytes,
+    const char* func_name,
+    uint64_t line_no) {
+  return mm_allocator_allocate_memory(
+      mm_allocator,num_bytes,zero_mem,align_bytes,false,func_name,line_no);
+}
+void* mm_allocator_try_allocate(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    const bool zero_mem,
+    const uint64_t align_bytes,
+    const char* func_name,
+    uint64_t line_no) {
+  // Check budget (worst-case bytes accounted)
+  if (mm_allocator->budget > 0) {
+    const uint64_t num_bytes_allocated = num_bytes + sizeof(mm_allocator_reference_t) + align_bytes;
+    if (mm_allocator->stats.bytes_current + num_bytes_allocated > mm_allocator->budget) {
+      ++(mm_allocator->budget_refused);
+      return NULL;
+    }
+  }
+  // Allocate (NULL if the system refuses the memory)
+  return mm_allocator_allocate_memory(
+      mm_allocator,num_bytes,zero_mem,align_bytes,true,func_name,line_no);
+}
 /*
  * Allocator Free
  */
+void mm_allocator_compact_malloc_requests(
+    mm_allocator_t* const mm_allocator) {
+  // Remove freed requests
+  const uint64_t num_requests = vector_get_used(mm_allocator->malloc_requests);
+  mm_malloc_request_t* const requests = vector_get_mem(mm_allocator->malloc_requests,mm_malloc_request_t);
+  uint64_t i, busy_requests = 0;
+  for (i=0;i<num_requests;++i) {
+    if (requests[i].size > 0) {
+      requests[busy_requests] = requests[i];
+      requests[busy_requests].reference->request_idx = busy_requests;
+      ++busy_requests;
+    }
+  }
+  vector_set_used(mm_allocator->malloc_requests,busy_requests);
+  mm_allocator->malloc_requests_freed = 0;
+}
 void mm_allocator_free_malloc_request(
     mm_allocator_t* const mm_allocator,
     mm_allocator_reference_t* const mm_reference) {
@@ -357,24 +1251,13 @@ void mm_allocator_free_malloc_request(
     exit(1);
   }
   // Free request
+  mm_allocator->stats.bytes_current -= request->size;
+  mm_allocator_large_cache_release(mm_allocator,request);
   request->size = 0;
-  free(request->mem);
   ++(mm_allocator->malloc_requests_freed);
   // Check number of freed requests
   if (mm_allocator->malloc_requests_freed >= 1000) {
-    // Remove freed requests
-    const uint64_t num_requests = vector_get_used(mm_allocator->malloc_requests);
-    mm_malloc_request_t* const requests = vector_get_mem(mm_allocator->malloc_requests,mm_malloc_request_t);
-    uint64_t i, busy_requests = 0;
-    for (i=0;i<num_requests;++i) {
-      if (requests[i].size > 0) {
-        requests[busy_requests] = requests[i];
-        requests[busy_requests].reference->request_idx = busy_requests;
-        ++busy_requests;
-      }
-    }
-    vector_set_used(mm_allocator->malloc_requests,busy_requests);
-    mm_allocator->malloc_requests_freed = 0;
+    mm_allocator_compact_malloc_requests(mm_allocator);
   }
 }
 void mm_allocator_free_allocator_request(
@@ -391,10 +1274,25 @@ void mm_allocator_free_allocator_request(
     exit(1);
   }
   // Free request
+  mm_allocator->stats.bytes_current -= MM_ALLOCATOR_REQUEST_SIZE(request);
   MM_ALLOCATOR_REQUEST_SET_FREE(request);
   // Free contiguous request(s) at the end of the segment
   uint64_t num_requests = mm_allocator_segment_get_num_requests(segment);
-  if (mm_reference->request_idx == num_requests-1) { // Is the last request?
+  if (mm_reference->request_idx != num_requests-1) { // Is a middle request?
+    // Add to free lists (if enabled)
+    if (mm_allocator->free_blocks != NULL) {
+      mm_allocator_free_block_t free_block = {
+          .segment_idx = mm_reference->segment_idx,
+          .request_idx = mm_reference->request_idx,
+          .ticket = ++(mm_allocator->free_blocks_ticket),
+      };
+      request->ticket = free_block.ticket;
+      MM_ALLOCATOR_REQUEST_SET_LISTED(request);
+      const uint64_t size_class = mm_allocator_size_class(MM_ALLOCATOR_REQUEST_SIZE(request));
+      vector_insert(mm_allocator->free_blocks[size_class],free_block,mm_allocator_free_block_t);
+      ++(mm_allocator->free_blocks_listed);
+    }
+  } else { // Is the last request?
     --num_requests;
     mm_allocator_request_t* request =
         vector_get_mem(segment->requests,mm_allocator_request_t) + (num_requests-1);
@@ -411,17 +1309,14 @@ void mm_allocator_free_allocator_request(
       mm_allocator_segment_clear(segment); // Clear
       // Add to free segments (if it is not the current segment)
       if (segment->idx != mm_allocator->current_segment_idx) {
-        vector_insert(mm_allocator->segments_free,segment,mm_allocator_segment_t*);
+        mm_allocator_add_segment_free(mm_allocator,segment);
       }
     }
   }
 }
-void mm_allocator_free(
+void mm_allocator_free_local(
     mm_allocator_t* const mm_allocator,
     void* const memory) {
-#ifdef MM_ALLOCATOR_DISABLE
-  free(memory);
-#else
   // Get reference
   void* const effective_memory = memory - sizeof(mm_allocator_reference_t);
   mm_allocator_reference_t* const mm_reference = (mm_allocator_reference_t*) effective_memory;
@@ -432,6 +1327,139 @@ void mm_allocator_free(
     // Free allocator memory
     mm_allocator_free_allocator_request(mm_allocator,mm_reference);
   }
+}
+void mm_allocator_free_remote(
+    mm_allocator_t* const mm_allocator,
+    void* const memory) {
+  // Defer to the owner thread
+  mm_allocator_lock(&mm_allocator->remote_frees_lock);
+  vector_insert(mm_allocator->remote_frees,memory,void*);
+  __atomic_add_fetch(&mm_allocator->remote_frees_pending,1,__ATOMIC_RELEASE);
+  mm_allocator_unlock(&mm_allocator->remote_frees_lock);
+}
+void mm_allocator_free(
+    mm_allocator_t* const mm_allocator,
+    void* const memory) {
+#ifdef MM_ALLOCATOR_DISABLE
+  free(memory);
+#else
+  // Cross-thread free (pooled allocators)
+  if (mm_allocator->pool != NULL &&
+      (__atomic_load_n(&mm_allocator->orphan,__ATOMIC_ACQUIRE) ||
+       !pthread_equal(mm_allocator->owner,pthread_self()))) {
+    mm_allocator_free_remote(mm_allocator,memory);
+    return;
+  }
+  mm_allocator_free_local(mm_allocator,memory);
+  // Apply deferred frees (from other threads)
+  if (__atomic_load_n(&mm_allocator->remote_frees_pending,__ATOMIC_ACQUIRE) > 0) {
+    mm_allocator_free_remote_requests(mm_allocator);
+  }
+#endif
+}
+void mm_allocator_free_remote_requests(
+    mm_allocator_t* const mm_allocator) {
+  mm_allocator_lock(&mm_allocator->remote_frees_lock);
+  VECTOR_ITERATE(mm_allocator->remote_frees,memory,m,void*) {
+    mm_allocator_free_local(mm_allocator,*memory);
+  }
+  vector_clear(mm_allocator->remote_frees);
+  __atomic_store_n(&mm_allocator->remote_frees_pending,0,__ATOMIC_RELEASE);
+  mm_allocator_unlock(&mm_allocator->remote_frees_lock);
+}
+void mm_allocator_trim(
+    mm_allocator_t* const mm_allocator) {
+#ifndef MM_ALLOCATOR_DISABLE
+  // Apply deferred frees (from other threads)
+  mm_allocator_free_remote_requests(mm_allocator);
+  // Return the cached empty segments to the pool
+  if (mm_allocator->pool == NULL) return;
+  VECTOR_ITERATE(mm_allocator->segments_free,segment_ptr,p,mm_allocator_segment_t*) {
+    mm_allocator_segment_t* const segment = *segment_ptr;
+    if (segment->memory != NULL) {
+      mm_allocator_pool_return_segment(mm_allocator->pool,segment->memory);
+      segment->memory = NULL;
+    }
+  }
+#endif
+}
+/*
+ * Mark/Rewind
+ */
+void mm_allocator_mark(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_mark_t* const mm_mark) {
+  // Current segment
+  mm_mark->segment_idx = mm_allocator->current_segment_idx;
+  mm_mark->segment_used = 0;
+  mm_mark->segment_requests = 0;
+  if (mm_allocator_get_num_segments(mm_allocator) > 0) {
+    mm_allocator_segment_t* const segment =
+        mm_allocator_get_segment(mm_allocator,mm_allocator->current_segment_idx);
+    mm_mark->segment_used = segment->used;
+    mm_mark->segment_requests = mm_allocator_segment_get_num_requests(segment);
+  }
+  mm_mark->segment_ticker = mm_allocator->segment_ticker;
+  // Flush free lists (blocks before the mark are not reused within the mark scope)
+  mm_allocator_flush_free_lists(mm_allocator);
+  // Malloc requests (compacted, so the requests before the mark keep their position)
+  if (mm_allocator->malloc_requests_freed > 0) {
+    mm_allocator_compact_malloc_requests(mm_allocator);
+  }
+  mm_mark->malloc_requests = vector_get_used(mm_allocator->malloc_requests);
+}
+void mm_allocator_rewind(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_mark_t* const mm_mark) {
+#ifndef MM_ALLOCATOR_DISABLE
+  // Apply deferred frees (from other threads)
+  mm_allocator_free_remote_requests(mm_allocator);
+  // Rewind segments
+  vector_clear(mm_allocator->segments_free);
+  VECTOR_ITERATE(mm_allocator->segments,segment_ptr,p,mm_allocator_segment_t*) {
+    mm_allocator_segment_t* const segment = *segment_ptr;
+    if (segment->ticker > mm_mark->segment_ticker) {
+      // Fetched (empty) after the mark
+      mm_allocator->stats.bytes_current -= mm_allocator_segment_get_bytes_used(segment,0);
+      mm_allocator_segment_clear(segment);
+    } else if (segment->idx == mm_mark->segment_idx &&
+               mm_allocator_segment_get_num_requests(segment) > mm_mark->segment_requests) {
+      // Current segment at the mark
+      mm_allocator->stats.bytes_current -=
+          mm_allocator_segment_get_bytes_used(segment,mm_mark->segment_requests);
+      segment->used = mm_mark->segment_used;
+      vector_set_used(segment->requests,mm_mark->segment_requests);
+    }
+    // Add to free segments
+    if (segment->idx != mm_mark->segment_idx &&
+        mm_allocator_segment_get_num_requests(segment) == 0) {
+      mm_allocator_add_segment_free(mm_allocator,segment);
+    }
+  }
+  mm_allocator->current_segment_idx = mm_mark->segment_idx;
+  mm_allocator_segment_t* const segment =
+      mm_allocator_get_segment(mm_allocator,mm_mark->segment_idx);
+  if (segment->memory == NULL) { // Returned to the pool (emptied after the mark)
+    if (!mm_allocator_segment_refill(mm_allocator,segment)) {
+      fprintf(stderr,"MMAllocator error. Could not refill the segment at the mark\n");
+      exit(1);
+    }
+  }
+  // Rewind malloc requests
+  const uint64_t num_requests = vector_get_used(mm_allocator->malloc_requests);
+  mm_malloc_request_t* const requests = vector_get_mem(mm_allocator->malloc_requests,mm_malloc_request_t);
+  uint64_t i;
+  for (i=mm_mark->malloc_requests;i<num_requests;++i) {
+    if (requests[i].size > 0) {
+      mm_allocator->stats.bytes_current -= requests[i].size;
+      mm_allocator_large_cache_release(mm_allocator,requests+i);
+    } else {
+      --(mm_allocator->malloc_requests_freed);
+    }
+  }
+  if (num_requests > mm_mark->malloc_requests) {
+    vector_set_used(mm_allocator->malloc_requests,mm_mark->malloc_requests);
+  }
 #endif
 }
 /*
@@ -586,6 +1614,15 @@ void mm_allocator_print(
   fprintf(stream,"  => Segments.allocated %" PRIu64 "\n",num_segments);
   fprintf(stream,"  => Segments.size      %" PRIu64 " MB\n",segment_size/(1024*1024));
   fprintf(stream,"  => Memory.available   %" PRIu64 " MB\n",num_segments*(segment_size/(1024*1024)));
+  fprintf(stream,"  => Memory.kind        %s\n",
+      (mm_allocator->memory_mode==mm_allocator_memory_malloc) ? "malloc" :
+      (mm_allocator->memory_mode==mm_allocator_memory_mmap) ? "mmap" : "hugepages");
+  if (mm_allocator->numa_policy != mm_numa_default) {
+    fprintf(stream,"  => Memory.numa        %s (node=%d,failures=%" PRIu64 ")\n",
+        (mm_allocator->numa_policy==mm_numa_local) ? "local" :
+        (mm_allocator->numa_policy==mm_numa_interleave) ? "interleave" : "bind",
+        mm_allocator->numa_node,mm_allocator->numa_failures);
+  }
   // Print memory information
   uint64_t bytes_used_malloc, bytes_used_allocator;
   uint64_t bytes_free_available, bytes_free_fragmented;
@@ -595,11 +1632,90 @@ void mm_allocator_print(
   fprintf(stream,"      => Memory.free.available  %" PRIu64 "\n",bytes_free_available);
   fprintf(stream,"      => Memory.free.fragmented %" PRIu64 "\n",bytes_free_fragmented);
   fprintf(stream,"    => Memory.malloc %" PRIu64 "\n",bytes_used_malloc);
+  if (mm_allocator->pool != NULL) {
+    mm_allocator_pool_t* const mm_allocator_pool = mm_allocator->pool;
+    fprintf(stream,"  => Pool.segments.allocated %" PRIu64 "\n",
+        __atomic_load_n(&mm_allocator_pool->segments_allocated,__ATOMIC_RELAXED));
+    fprintf(stream,"  => Pool.segments.reused    %" PRIu64 "\n",
+        __atomic_load_n(&mm_allocator_pool->segments_reused,__ATOMIC_RELAXED));
+    fprintf(stream,"  => Pool.segments.returned  %" PRIu64 "\n",
+        __atomic_load_n(&mm_allocator_pool->segments_returned,__ATOMIC_RELAXED));
+  }
+  if (mm_allocator->large_blocks != NULL) {
+    fprintf(stream,"  => LargeCache.cached  %" PRIu64 " blocks (%" PRIu64 " Bytes)\n",
+        vector_get_used(mm_allocator->large_blocks),mm_allocator->large_blocks_bytes);
+    fprintf(stream,"  => LargeCache.reused  %" PRIu64 " blocks\n",mm_allocator->large_blocks_reused);
+  }
+  if (mm_allocator->free_blocks != NULL) {
+    fprintf(stream,"  => FreeLists.listed   %" PRIu64 " blocks\n",mm_allocator->free_blocks_listed);
+    fprintf(stream,"  => FreeLists.reused   %" PRIu64 " blocks (%" PRIu64 " Bytes)\n",
+        mm_allocator->free_blocks_reused,mm_allocator->free_bytes_reused);
+  }
+  // Print stats
+  mm_allocator_print_stats(stream,mm_allocator);
   // Print memory requests
   if (display_requests) {
     mm_allocator_print_allocator_requests(stream,mm_allocator,false);
   }
 }
+int mm_allocator_callsite_cmp(
+    const void* const a,
+    const void* const b) {
+  const mm_allocator_callsite_t* const callsite_a = (const mm_allocator_callsite_t*)a;
+  const mm_allocator_callsite_t* const callsite_b = (const mm_allocator_callsite_t*)b;
+  if (callsite_a->num_bytes == callsite_b->num_bytes) return 0;
+  return (callsite_a->num_bytes > callsite_b->num_bytes) ? -1 : 1;
+}
+void mm_allocator_print_stats(
+    FILE* const stream,
+    mm_allocator_t* const mm_allocator) {
+  mm_allocator_stats_t stats;
+  mm_allocator_get_stats(mm_allocator,&stats);
+  fprintf(stream,"  => Stats.memory.current  %" PRIu64 " Bytes\n",stats.bytes_current);
+  fprintf(stream,"  => Stats.memory.peak     %" PRIu64 " Bytes\n",stats.bytes_peak);
+  fprintf(stream,"  => Stats.segments        %" PRIu64 "\n",stats.num_segments);
+  fprintf(stream,"  => Stats.requests        %" PRIu64 " (%" PRIu64 " Bytes)\n",
+      stats.num_requests,stats.num_bytes_requested);
+  fprintf(stream,"    => Stats.requests.malloc %" PRIu64 " (%" PRIu64 " Bytes)\n",
+      stats.malloc_requests,stats.malloc_bytes);
+  if (mm_allocator->budget > 0) {
+    fprintf(stream,"  => Stats.budget          %" PRIu64 " Bytes (%" PRIu64 " requests refused)\n",
+        mm_allocator->budget,mm_allocator->budget_refused);
+  }
+  // Fragmentation (free memory behind busy requests) & free lists
+  uint64_t bytes_used_malloc, bytes_used_allocator;
+  uint64_t bytes_free_available, bytes_free_fragmented;
+  mm_allocator_get_occupation(mm_allocator,&bytes_used_malloc,&bytes_used_allocator,&bytes_free_available,&bytes_free_fragmented);
+  fprintf(stream,"  => Stats.memory.free     %" PRIu64 " Bytes (%" PRIu64 " Bytes fragmented)\n",
+      bytes_free_available+bytes_free_fragmented,bytes_free_fragmented);
+  if (mm_allocator->free_blocks != NULL) {
+    fprintf(stream,"  => Stats.free-lists      %" PRIu64 " blocks listed\n",mm_allocator->free_blocks_listed);
+    fprintf(stream,"    => Stats.free-lists.reused %" PRIu64 " blocks (%" PRIu64 " Bytes)\n",
+        mm_allocator->free_blocks_reused,mm_allocator->free_bytes_reused);
+  }
+  // Size histogram
+  fprintf(stream,"  => Stats.requests.size\n");
+  uint64_t i;
+  for (i=0;i<MM_ALLOCATOR_SIZE_CLASSES;++i) {
+    if (stats.size_histogram[i] == 0) continue;
+    fprintf(stream,"    [2^%02" PRIu64 ",2^%02" PRIu64 ") %" PRIu64 "\n",i,i+1,stats.size_histogram[i]);
+  }
+  // Callsites (sorted by bytes)
+  if (mm_allocator->callsites != NULL) {
+    mm_allocator_callsite_t* const callsites = malloc(MM_ALLOCATOR_CALLSITES*sizeof(mm_allocator_callsite_t));
+    uint64_t num_callsites = 0;
+    for (i=0;i<MM_ALLOCATOR_CALLSITES;++i) {
+      if (mm_allocator->callsites[i].func_name != NULL) callsites[num_callsites++] = mm_allocator->callsites[i];
+    }
+    qsort(callsites,num_callsites,sizeof(mm_allocator_callsite_t),mm_allocator_callsite_cmp);
+    fprintf(stream,"  => Stats.callsites\n");
+    for (i=0;i<num_callsites;++i) {
+      fprintf(stream,"    %s:%" PRIu64 "\t%" PRIu64 " requests\t%" PRIu64 " Bytes\n",
+          callsites[i].func_name,callsites[i].line_no,callsites[i].num_requests,callsites[i].num_bytes);
+    }
+    free(callsites);
+  }
+}
 
 
 
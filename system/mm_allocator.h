@@ -36,12 +36,78 @@
 #define MM_ALLOCATOR_H_
 
 #include "utils/vector.h"
+#include "system/mm_numa.h"
+#include <pthread.h>
 
 /*
  * Configuration
  */
 //#define MM_ALLOCATOR_LOG
-#define MM_ALLOCATOR_ALIGNMENT 8 // 64bits
+#define MM_ALLOCATOR_ALIGNMENT 8 // 64bits (default)
+#define MM_ALLOCATOR_ALIGNMENT_CACHE_LINE 64
+#define MM_ALLOCATOR_ALIGNMENT_PAGE 4096 // Maximum alignment (large buffers)
+#define MM_ALLOCATOR_SIZE_CLASSES 32 // Power-of-two size classes (free lists)
+#define MM_ALLOCATOR_POOL_CACHED_SEGMENTS 2 // Empty segments kept by each pooled allocator
+#define MM_ALLOCATOR_HUGEPAGE_SIZE (2ul*1024ul*1024ul) // 2MB
+#define MM_ALLOCATOR_CALLSITES 256 // Callsites tracked (per-callsite stats)
+#define MM_ALLOCATOR_LARGE_CACHE_BLOCKS 16 // Maximum blocks in the large-blocks cache
+
+/*
+ * Segments memory
+ */
+typedef enum {
+  mm_allocator_memory_malloc,     // Heap memory (malloc/free)
+  mm_allocator_memory_mmap,       // Anonymous mappings (kernel-zeroed pages)
+  mm_allocator_memory_hugepages,  // Anonymous mappings on huge pages (MAP_HUGETLB or MADV_HUGEPAGE)
+} mm_allocator_memory_t;
+
+/*
+ * MM-Allocator Pool (thread-caching front end)
+ */
+typedef struct {
+  void* memory;                   // Segment memory
+  uint32_t next;                  // Next slot in the stack (slot index + 1; 0 = none)
+} mm_allocator_pool_slot_t;
+typedef struct {
+  // Segments
+  uint64_t segment_size;          // Memory segment size (bytes)
+  uint32_t max_segments;          // Maximum segments pooled (slots)
+  mm_allocator_memory_t memory_mode; // Segments memory
+  mm_allocator_pool_slot_t* slots;// Segment slots
+  uint64_t segments_head;         // Lock-free stack of slots holding a segment (tag<<32 | slot+1)
+  uint64_t empty_head;            // Lock-free stack of empty slots (tag<<32 | slot+1)
+  // Thread allocators
+  pthread_key_t thread_key;       // Thread-local allocator key
+  vector_t* thread_allocators;    // Live thread allocators (mm_allocator_t*)
+  vector_t* orphan_allocators;    // Allocators of exited threads still serving memory (mm_allocator_t*)
+  bool thread_allocators_lock;    // Lock (only taken to add/remove thread allocators)
+  // Stats
+  uint64_t segments_allocated;    // Segments allocated (not available in the pool)
+  uint64_t segments_reused;       // Segments fetched from the pool
+  uint64_t segments_returned;     // Segments returned to the pool
+} mm_allocator_pool_t;
+
+/*
+ * MM-Allocator Stats (always collected)
+ */
+typedef struct {
+  // Memory
+  uint64_t bytes_current;         // Bytes allocated (including headers & padding)
+  uint64_t bytes_peak;            // Maximum bytes allocated (since the last reset)
+  uint64_t num_segments;          // Memory segments
+  // Requests
+  uint64_t num_requests;          // Requests served
+  uint64_t num_bytes_requested;   // Bytes requested
+  uint64_t malloc_requests;       // Requests served by malloc (too large for a segment)
+  uint64_t malloc_bytes;          // Bytes served by malloc
+  uint64_t size_histogram[MM_ALLOCATOR_SIZE_CLASSES]; // Requests per size (log2)
+} mm_allocator_stats_t;
+typedef struct {
+  const char* func_name;          // Callsite function (NULL if the entry is empty)
+  uint64_t line_no;               // Callsite line
+  uint64_t num_requests;          // Requests served
+  uint64_t num_bytes;             // Bytes requested
+} mm_allocator_callsite_t;
 
 /*
  * MM-Allocator
@@ -51,14 +117,56 @@ typedef struct {
   uint64_t request_ticker;        // Request ticker
   // Memory segments
   uint64_t segment_size;          // Memory segment size (bytes)
+  uint64_t alignment;             // Default alignment of the requests (bytes)
+  uint64_t segment_ticker;        // Segment fetch ticker (segments set as current)
+  mm_allocator_memory_t memory_mode; // Segments (and malloc requests) memory
+  mm_numa_policy_t numa_policy;   // NUMA placement of the segments (and malloc requests)
+  int numa_node;                  // NUMA node (bind policy)
+  uint64_t numa_failures;         // Placements refused by the system
   vector_t* segments;             // Memory segments (mm_allocator_segment_t*)
   vector_t* segments_free;        // Completely free segments (mm_allocator_segment_t*)
   uint64_t current_segment_idx;   // Current segment being used (serving memory)
   // Malloc memory
   vector_t* malloc_requests;      // Malloc requests (mm_malloc_request_t)
   uint64_t malloc_requests_freed; // Total malloc request freed and still in vector
+  // Free lists (freed non-tail blocks, per size class)
+  vector_t** free_blocks;         // Free blocks per size class (mm_allocator_free_block_t) or NULL (disabled)
+  uint32_t free_blocks_ticket;    // Free blocks ticker (tells stale free-list entries)
+  uint64_t free_blocks_listed;    // Total blocks added to the free lists
+  uint64_t free_blocks_reused;    // Total requests served from the free lists
+  uint64_t free_bytes_reused;     // Total bytes served from the free lists
+  // Large-blocks cache (freed requests served outside the segments)
+  vector_t* large_blocks;         // Cached blocks, oldest first (mm_allocator_large_block_t) or NULL (disabled)
+  uint64_t large_blocks_bytes;    // Bytes cached
+  uint64_t large_blocks_max_bytes;// Maximum bytes cached
+  bool large_blocks_trim;         // Release the pages of the cached blocks (MADV_DONTNEED)
+  uint64_t large_blocks_reused;   // Total requests served from the cache
+  // Budget
+  uint64_t budget;                // Maximum bytes allocated (0 = unlimited)
+  uint64_t budget_refused;        // Requests refused (over budget)
+  // Stats
+  mm_allocator_stats_t stats;     // Counters (since the last reset)
+  mm_allocator_callsite_t* callsites; // Per-callsite stats (hashed) or NULL (disabled)
+  // Pool
+  mm_allocator_pool_t* pool;      // Segments pool (or NULL)
+  pthread_t owner;                // Owner thread (pooled allocators)
+  bool orphan;                    // Owner thread exited (all frees are deferred)
+  vector_t* remote_frees;         // Deferred frees from other threads (void*)
+  uint64_t remote_frees_pending;  // Deferred frees pending
+  bool remote_frees_lock;         // Lock (only taken on cross-thread frees)
 } mm_allocator_t;
 
+/*
+ * MM-Allocator Mark (allocator state to rewind to)
+ */
+typedef struct {
+  uint64_t segment_idx;           // Current segment
+  uint64_t segment_used;          // Current segment bytes used
+  uint64_t segment_requests;      // Current segment requests
+  uint64_t segment_ticker;        // Segment fetch ticker
+  uint64_t malloc_requests;       // Malloc requests
+} mm_allocator_mark_t;
+
 /*
  * Setup
  */
@@ -76,28 +184,33 @@ void* mm_allocator_allocate(
     mm_allocator_t* const mm_allocator,
     const uint64_t num_bytes,
     const bool zero_mem,
-    const uint64_t align_bytes
-#ifdef MM_ALLOCATOR_LOG
-    ,const char* func_name,
-    uint64_t line_no
-#endif
-    );
-
-#ifdef MM_ALLOCATOR_LOG
-#define mm_allocator_alloc(mm_allocator,type) \
-  ((type*)mm_allocator_allocate(mm_allocator,sizeof(type),false,MM_ALLOCATOR_ALIGNMENT,__func__,(uint64_t)__LINE__))
-#define mm_allocator_malloc(mm_allocator,num_bytes) \
-  (mm_allocator_allocate(mm_allocator,num_bytes,false,MM_ALLOCATOR_ALIGNMENT,__func__,(uint64_t)__LINE__))
-#define mm_allocator_calloc(mm_allocator,num_elements,type,clear_mem) \
-  ((type*)mm_allocator_allocate(mm_allocator,(num_elements)*sizeof(type),clear_mem,MM_ALLOCATOR_ALIGNMENT,__func__,(uint64_t)__LINE__))
-#else
+    const uint64_t align_bytes,
+    const char* func_name,
+    uint64_t line_no);
+
 #define mm_allocator_alloc(mm_allocator,type) \
-  ((type*)mm_allocator_allocate(mm_allocator,sizeof(type),false,MM_ALLOCATOR_ALIGNMENT))
+  ((type*)mm_allocator_allocate(mm_allocator,sizeof(type),false,(mm_allocator)->alignment,__func__,(uint64_t)__LINE__))
 #define mm_allocator_malloc(mm_allocator,num_bytes) \
-  (mm_allocator_allocate(mm_allocator,num_bytes,false,MM_ALLOCATOR_ALIGNMENT))
+  (mm_allocator_allocate(mm_allocator,num_bytes,false,(mm_allocator)->alignment,__func__,(uint64_t)__LINE__))
 #define mm_allocator_calloc(mm_allocator,num_elements,type,clear_mem) \
-  ((type*)mm_allocator_allocate(mm_allocator,(num_elements)*sizeof(type),clear_mem,MM_ALLOCATOR_ALIGNMENT))
-#endif
+  ((type*)mm_allocator_allocate(mm_allocator,(num_elements)*sizeof(type),clear_mem,(mm_allocator)->alignment,__func__,(uint64_t)__LINE__))
+#define mm_allocator_malloc_aligned(mm_allocator,num_bytes,alignment) \
+  (mm_allocator_allocate(mm_allocator,num_bytes,false,alignment,__func__,(uint64_t)__LINE__))
+#define mm_allocator_calloc_aligned(mm_allocator,num_elements,type,clear_mem,alignment) \
+  ((type*)mm_allocator_allocate(mm_allocator,(num_elements)*sizeof(type),clear_mem,alignment,__func__,(uint64_t)__LINE__))
+
+void* mm_allocator_try_allocate(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t num_bytes,
+    const bool zero_mem,
+    const uint64_t align_bytes,
+    const char* func_name,
+    uint64_t line_no);
+
+#define mm_allocator_try_malloc(mm_allocator,num_bytes) \
+  (mm_allocator_try_allocate(mm_allocator,num_bytes,false,(mm_allocator)->alignment,__func__,(uint64_t)__LINE__))
+#define mm_allocator_try_calloc(mm_allocator,num_elements,type,clear_mem) \
+  ((type*)mm_allocator_try_allocate(mm_allocator,(num_elements)*sizeof(type),clear_mem,(mm_allocator)->alignment,__func__,(uint64_t)__LINE__))
 
 #define mm_allocator_uint64(mm_allocator) mm_allocator_malloc(mm_allocator,sizeof(uint64_t))
 #define mm_allocator_uint32(mm_allocator) mm_allocator_malloc(mm_allocator,sizeof(uint32_t))
@@ -106,10 +219,142 @@ void* mm_allocator_allocate(
 
 /*
  * Free
+ *   Trimming applies the frees deferred by other threads and, on pooled
+ *   allocators, returns the cached empty segments to the pool. Like any
+ *   other call, it must come from the owner thread or while the owner is
+ *   parked (not using the allocator).
  */
 void mm_allocator_free(
     mm_allocator_t* const mm_allocator,
     void* const memory);
+void mm_allocator_trim(
+    mm_allocator_t* const mm_allocator);
+
+/*
+ * Budget
+ *   Limits the bytes allocated (as accounted by Stats.memory.current).
+ *   Requests through the try-allocation path (mm_allocator_try_*) beyond
+ *   the budget, or refused by the system (malloc/mmap failing), return
+ *   NULL. The regular allocation macros never fail (they exit if the
+ *   system refuses): they serve the request and leave the allocator over budget, so
+ *   long-running computations can poll mm_allocator_over_budget() and
+ *   back off (e.g. the aligner aborts and reports out-of-budget).
+ */
+void mm_allocator_set_budget(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t max_bytes);
+bool mm_allocator_over_budget(
+    mm_allocator_t* const mm_allocator);
+
+/*
+ * NUMA placement
+ *   Places new segments (and requests served outside of them) following
+ *   the policy: local to the thread allocating them, interleaved, or bound
+ *   to a node. Segments already allocated (or reused from a pool) are
+ *   migrated. E.g. a worker thread can pin its allocator to its node using
+ *   mm_allocator_set_numa_policy(mm,mm_numa_bind,mm_numa_get_current_node())
+ */
+void mm_allocator_set_numa_policy(
+    mm_allocator_t* const mm_allocator,
+    const mm_numa_policy_t numa_policy,
+    const int numa_node);
+
+/*
+ * Alignment
+ *   Default alignment of the requests (power of two, up to
+ *   MM_ALLOCATOR_ALIGNMENT_PAGE). Per-call alignment is given
+ *   using the *_aligned allocation macros.
+ */
+void mm_allocator_set_alignment(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t alignment);
+
+/*
+ * Segments memory
+ *   Segments (and requests served outside of them) can be backed by
+ *   anonymous mappings, optionally on huge pages. Fresh pages are known
+ *   to be zero, so zeroed requests only clear the bytes already written.
+ *   Already allocated (empty) segments are remapped; busy ones keep
+ *   their memory until released.
+ */
+void mm_allocator_set_memory(
+    mm_allocator_t* const mm_allocator,
+    const mm_allocator_memory_t memory_mode);
+
+/*
+ * Size-class free lists
+ *   Blocks freed in the middle of a segment (non-LIFO) are kept in
+ *   power-of-two size-class lists and reused by subsequent requests
+ *   that fit (disabled by default).
+ */
+void mm_allocator_set_free_lists(
+    mm_allocator_t* const mm_allocator,
+    const bool enabled);
+
+/*
+ * Large-blocks cache
+ *   Requests too large for a segment are served by the system. Once
+ *   freed, up to MM_ALLOCATOR_LARGE_CACHE_BLOCKS of them (and no more than
+ *   @max_bytes) are kept and reused by subsequent large requests that fit
+ *   (best fit, wasting at most half of the block). If @trim is set, the
+ *   pages of the cached blocks are given back to the system (the address
+ *   range is kept). Disabled by default (max_bytes=0).
+ */
+void mm_allocator_set_large_cache(
+    mm_allocator_t* const mm_allocator,
+    const uint64_t max_bytes,
+    const bool trim);
+
+/*
+ * Pool (thread-caching front end)
+ *   All the allocators served by a pool take whole segments from (and
+ *   return them to) a lock-free stack of segments. Each thread gets its
+ *   own allocator (mm_allocator_pool_get_allocator), so requests are
+ *   served without locks and only an empty segment beyond the
+ *   MM_ALLOCATOR_POOL_CACHED_SEGMENTS cached ones travels back to the pool.
+ *   Cross-thread frees: memory can be freed from any thread calling
+ *   mm_allocator_free() on the allocator that served it. Frees from other
+ *   threads are deferred and applied by the owner on its next request,
+ *   free, clear or rewind. Idle allocators can be trimmed with
+ *   mm_allocator_pool_trim(), only while their threads are parked.
+ *   Clear, mark/rewind and the free lists are owner-only.
+ *   Thread exit: the allocator is deleted if it holds no live memory.
+ *   Otherwise it is kept by the pool as an orphan, so the memory it
+ *   handed to other threads stays valid and can still be freed. The
+ *   deferred frees of orphans are applied (and the emptied orphans
+ *   deleted) on mm_allocator_pool_get_allocator() and
+ *   mm_allocator_pool_trim(). A new thread adopts a remaining orphan
+ *   (becoming its owner) before creating a new allocator. The remaining
+ *   allocators are deleted along with the pool.
+ */
+mm_allocator_pool_t* mm_allocator_pool_new(
+    const uint64_t segment_size,
+    const uint32_t max_segments);
+void mm_allocator_pool_delete(
+    mm_allocator_pool_t* const mm_allocator_pool);
+mm_allocator_t* mm_allocator_pool_get_allocator(
+    mm_allocator_pool_t* const mm_allocator_pool);
+void mm_allocator_pool_trim(
+    mm_allocator_pool_t* const mm_allocator_pool);
+mm_allocator_t* mm_allocator_new_pooled(
+    mm_allocator_pool_t* const mm_allocator_pool);
+void mm_allocator_pool_set_memory(
+    mm_allocator_pool_t* const mm_allocator_pool,
+    const mm_allocator_memory_t memory_mode);
+
+/*
+ * Mark/Rewind (stack-scoped allocations)
+ *   Rewinding releases every allocation made after the mark at once
+ *   (in O(#segments)). Allocations made before the mark must not be
+ *   freed in-between. Marking flushes the free lists (blocks freed
+ *   before the mark are not reused within the mark scope).
+ */
+void mm_allocator_mark(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_mark_t* const mm_mark);
+void mm_allocator_rewind(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_mark_t* const mm_mark);
 
 /*
  * Utils
@@ -121,6 +366,24 @@ void mm_allocator_get_occupation(
     uint64_t* const bytes_free_available,
     uint64_t* const bytes_free_fragmented);
 
+/*
+ * Stats
+ *   Counters are updated on every request (cheap) and can be queried or
+ *   reset at any time (e.g. per alignment). Per-callsite accounting is
+ *   optional and can be toggled at runtime.
+ */
+void mm_allocator_get_stats(
+    mm_allocator_t* const mm_allocator,
+    mm_allocator_stats_t* const stats);
+void mm_allocator_reset_stats(
+    mm_allocator_t* const mm_allocator);
+void mm_allocator_set_callsite_stats(
+    mm_allocator_t* const mm_allocator,
+    const bool enabled);
+void mm_allocator_print_stats(
+    FILE* const stream,
+    mm_allocator_t* const mm_allocator);
+
 /*
  * Display
  */
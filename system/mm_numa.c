@@ -0,0 +1,107 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: NUMA memory placement (mbind) without depending on libnuma
+ */
+
+#include "system/mm_numa.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Kernel memory policies (linux/mempolicy.h)
+ */
+#define MM_NUMA_MPOL_DEFAULT     0
+#define MM_NUMA_MPOL_PREFERRED   1
+#define MM_NUMA_MPOL_BIND        2
+#define MM_NUMA_MPOL_INTERLEAVE  3
+#define MM_NUMA_MPOL_MF_MOVE     (1<<1)
+#define MM_NUMA_MAX_NODES        64 // Nodes in the mask
+
+/*
+ * Nodes
+ */
+int mm_numa_get_current_node(void) {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned int cpu, node;
+  if (syscall(SYS_getcpu,&cpu,&node,NULL) == 0) return (int)node;
+#endif
+  return 0;
+}
+/*
+ * Memory placement
+ */
+bool mm_numa_set_memory_policy(
+    void* const memory,
+    const uint64_t size,
+    const mm_numa_policy_t policy,
+    const int node,
+    const bool move_pages) {
+#if defined(__linux__) && defined(SYS_mbind)
+  // Trim to whole pages
+  const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = ((uintptr_t)memory + page_size - 1) & ~(page_size - 1);
+  const uintptr_t end = ((uintptr_t)memory + size) & ~(page_size - 1);
+  if (end <= begin) return true; // No whole page
+  // Compute mode & nodes
+  unsigned long node_mask = 0;
+  int mode;
+  switch (policy) {
+    case mm_numa_local: {
+      const int current_node = mm_numa_get_current_node();
+      if (current_node < 0 || current_node >= MM_NUMA_MAX_NODES) return false;
+      mode = MM_NUMA_MPOL_PREFERRED;
+      node_mask = 1ul << current_node;
+      break;
+    }
+    case mm_numa_interleave:
+      mode = MM_NUMA_MPOL_INTERLEAVE;
+      node_mask = ~0ul; // All nodes (restricted to the allowed ones by the kernel)
+      break;
+    case mm_numa_bind:
+      if (node < 0 || node >= MM_NUMA_MAX_NODES) return false;
+      mode = MM_NUMA_MPOL_BIND;
+      node_mask = 1ul << node;
+      break;
+    case mm_numa_default: default:
+      mode = MM_NUMA_MPOL_DEFAULT;
+      break;
+  }
+  // Bind
+  const unsigned long flags = (move_pages) ? MM_NUMA_MPOL_MF_MOVE : 0;
+  const long error = syscall(SYS_mbind,(void*)begin,end-begin,mode,
+      (mode==MM_NUMA_MPOL_DEFAULT) ? NULL : &node_mask,
+      (mode==MM_NUMA_MPOL_DEFAULT) ? 0 : MM_NUMA_MAX_NODES+1,flags);
+  return (error == 0);
+#else
+  return (policy == mm_numa_default);
+#endif
+}
@@ -0,0 +1,66 @@
+/*
+ *                             The MIT License
+ *
+ * Wavefront Alignments Algorithms
+ * Copyright (c) 2017 by Santiago Marco-Sola  <santiagomsola@gmail.com>
+ *
+ * This file is part of Wavefront Alignments Algorithms.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * PROJECT: Wavefront Alignments Algorithms
+ * AUTHOR(S): Santiago Marco-Sola <santiagomsola@gmail.com>
+ * DESCRIPTION: NUMA memory placement (mbind) without depending on libnuma
+ */
+
+#ifndef MM_NUMA_H_
+#define MM_NUMA_H_
+
+#include "utils/commons.h"
+
+/*
+ * NUMA Policy
+ */
+typedef enum {
+  mm_numa_default,     // System policy (first touch)
+  mm_numa_local,       // Node of the thread allocating the memory
+  mm_numa_interleave,  // Interleaved across all nodes
+  mm_numa_bind,        // Bound to a given node
+} mm_numa_policy_t;
+
+/*
+ * Nodes
+ */
+int mm_numa_get_current_node(void);
+
+/*
+ * Memory placement (best effort)
+ *   Applies the policy to the pages fully contained in the given memory
+ *   (not page-aligned memory is trimmed). Pages already touched are only
+ *   migrated if @move_pages is set. Returns false if the system refused
+ *   (or does not support) the policy.
+ */
+bool mm_numa_set_memory_policy(
+    void* const memory,
+    const uint64_t size,
+    const mm_numa_policy_t policy,
+    const int node,
+    const bool move_pages);
+
+#endif /* MM_NUMA_H_ */
@@ -84,14 +84,27 @@ double counter_get_stddev(const profiler_counter_t* const counter) {
 void counter_combine_sum(
     profiler_counter_t* const counter_dst,
     profiler_counter_t* const counter_src) {
+  if (counter_src->samples == 0) return; // Nothing to combine
+  if (counter_dst->samples == 0) { // Empty destination (keep the source min/max)
+    *counter_dst = *counter_src;
+    return;
+  }
+  // Merge mean & variance (Chan et al. parallel algorithm)
+  const double samples_dst = (double)counter_dst->samples;
+  const double samples_src = (double)counter_src->samples;
+  const double samples = samples_dst + samples_src;
+  const double delta = counter_src->m_newM - counter_dst->m_newM;
+  const double s_dst = (counter_dst->samples > 1) ? counter_dst->m_newS : 0.0;
+  const double s_src = (counter_src->samples > 1) ? counter_src->m_newS : 0.0;
+  counter_dst->m_newM = counter_dst->m_newM + delta*samples_src/samples;
+  counter_dst->m_newS = s_dst + s_src + delta*delta*samples_dst*samples_src/samples;
+  counter_dst->m_oldM = counter_dst->m_newM;
+  counter_dst->m_oldS = counter_dst->m_newS;
+  // Merge totals
   counter_dst->total += counter_src->total;
   counter_dst->samples += counter_src->samples;
   counter_dst->min = MIN(counter_dst->min,counter_src->min);
   counter_dst->max = MAX(counter_dst->max,counter_src->max);
-  if (counter_src->m_newS!=0.0) counter_dst->m_newS = counter_src->m_newS;
-  if (counter_src->m_newM!=0.0) counter_dst->m_newM = counter_src->m_newM;
-  if (counter_src->m_oldS!=0.0) counter_dst->m_oldS = counter_src->m_oldS;
-  if (counter_src->m_oldM!=0.0) counter_dst->m_oldM = counter_src->m_oldM;
 }
 void counter_combine_max(
     profiler_counter_t* const counter_dst,
@@ -31,6 +31,7 @@
 
 #include "utils/commons.h"
 #include "system/profiler_timer.h"
+#include <pthread.h>
 
 #include "edit/edit_table.h"
 #include "edit/edit_dp.h"
@@ -48,10 +49,16 @@
 typedef enum {
   alignment_edit_dp,
   alignment_edit_dp_banded,
+  alignment_edit_wavefront,
   alignment_gap_lineal_nw,
+  alignment_gap_lineal_wavefront,
   alignment_gap_affine_swg,
   alignment_gap_affine_swg_banded,
   alignment_gap_affine_wavefront,
+  alignment_gap_affine2p_wavefront,
+  alignment_gap_affine_wavefront_batch,
+  alignment_gap_affine2p_wavefront_batch,
+  alignment_gap_affine_wavefront_lanes,
 } alg_algorithm_type;
 
 /*
@@ -64,14 +71,31 @@ typedef struct {
   // Penalties
   lineal_penalties_t lineal_penalties;
   affine_penalties_t affine_penalties;
+  affine2p_penalties_t affine2p_penalties;
   // Specific parameters
   int bandwidth;
   wavefront_reduction_type reduction_type;
   int min_wavefront_length;
   int max_distance_threshold;
+  bool cigar_rle;
+  affine_wavefronts_match_t match;
+  bool zero_copy;
+  int zero_copy_slack;
+  // System
+  mm_allocator_memory_t memory_mode;
+  bool memory_stats;
+  bool memory_free_lists;
+  bool memory_pool;
+  mm_numa_policy_t numa_policy;
+  int numa_node;
+  int large_cache_mb;
+  int memory_budget_mb;
+  int budget_min_wavefront_length;
+  int budget_max_distance_threshold;
   // Profile
   profiler_timer_t timer_global;
   int progress;
+  int num_threads;
   // Check
   bool check_correct;
   bool check_score;
@@ -97,18 +121,45 @@ benchmark_args parameters = {
       .gap_opening = 6,
       .gap_extension = 2,
   },
+  .affine2p_penalties = {
+      .match = 0,
+      .mismatch = 4,
+      .gap_opening1 = 6,
+      .gap_extension1 = 2,
+      .gap_opening2 = 24,
+      .gap_extension2 = 1,
+  },
   // Specific parameters
   .bandwidth = 10,
   .reduction_type = wavefronts_reduction_none,
   .min_wavefront_length = 10,
   .max_distance_threshold = 50,
+  .cigar_rle = false,
+  .match = {
+      .case_insensitive = false,
+      .n = wavefronts_match_n_exact,
+  },
+  .zero_copy = false,
+  .zero_copy_slack = 0,
+  // System
+  .memory_mode = mm_allocator_memory_malloc,
+  .memory_stats = false,
+  .memory_free_lists = false,
+  .memory_pool = false,
+  .numa_policy = mm_numa_default,
+  .numa_node = 0,
+  .large_cache_mb = 0,
+  .memory_budget_mb = 0,
+  .budget_min_wavefront_length = -1,
+  .budget_max_distance_threshold = -1,
   // Check
   .check_correct = false,
   .check_score = false,
   .check_alignments = false,
-  .check_metric = ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE,
+  .check_metric = 0, // Gap-affine (two-piece for two-piece algorithms)
   .check_bandwidth = -1,
   .progress = 10000,
+  .num_threads = 1,
   .verbose = false
 };
 
@@ -128,6 +179,7 @@ void align_pairwise_test() {
       .text = text,
       .text_length = strlen(text),
       .mm_allocator = mm_allocator,
+      .budget_min_wavefront_length = -1,
       .debug_flags = /* ALIGN_DEBUG_DISPLAY_INFO | */ ALIGN_DEBUG_CHECK_SCORE | ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE,
       .verbose = true,
   };
@@ -149,6 +201,7 @@ void align_pairwise_test() {
   align_input.debug_flags = 0;
   align_input.check_lineal_penalties = &parameters.lineal_penalties;
   align_input.check_affine_penalties = &parameters.affine_penalties;
+  align_input.check_affine2p_penalties = &parameters.affine2p_penalties;
 
   parameters.affine_penalties.match = 0;
   parameters.affine_penalties.mismatch = 6;
@@ -164,112 +217,360 @@ void align_pairwise_test() {
   // Free
   mm_allocator_delete(mm_allocator);
 }
+/*
+ * Benchmark (workers)
+ *   Workers fetch batches of pairs from the input (under a lock) and
+ *   align them using their own allocator, aligner, and stats.
+ */
+#define ALIGN_BENCHMARK_BATCH_SIZE 64
+typedef struct {
+  FILE* input_file;                 // Input dataset
+  pthread_mutex_t input_mutex;      // Input lock (held while reading a batch)
+  int reads_processed;              // Pairs read (next sequence ID)
+  int reads_reported;               // Pairs read at the last progress report
+  mm_allocator_pool_t* mm_allocator_pool; // Allocators pool (--memory-pool) or NULL
+} align_benchmark_input_t;
+typedef struct {
+  // Input
+  align_benchmark_input_t* input;   // Shared input
+  alg_algorithm_type alg_algorithm; // Algorithm
+  pthread_t thread;                 // Worker thread
+  int worker_id;                    // Worker index
+  // Batch
+  char* lines[2*ALIGN_BENCHMARK_BATCH_SIZE];
+  size_t lines_allocated[2*ALIGN_BENCHMARK_BATCH_SIZE];
+  int lines_length[2*ALIGN_BENCHMARK_BATCH_SIZE];
+  // Alignment
+  align_input_t align_input;        // Allocator, aligner & stats
+  int reads_processed;              // Pairs aligned by this worker
+} align_benchmark_worker_t;
+void align_benchmark_worker_init(
+    align_benchmark_worker_t* const worker) {
+  align_input_t* const align_input = &worker->align_input;
+  // Batch
+  memset(worker->lines,0,sizeof(worker->lines));
+  memset(worker->lines_allocated,0,sizeof(worker->lines_allocated));
+  // Align input
+  benchmark_align_input_clear(align_input);
+  align_input->debug_flags = 0;
+  align_input->debug_flags |= parameters.check_metric;
+  if (parameters.check_correct) align_input->debug_flags |= ALIGN_DEBUG_CHECK_CORRECT;
+  if (parameters.check_score) align_input->debug_flags |= ALIGN_DEBUG_CHECK_SCORE;
+  if (parameters.check_alignments) align_input->debug_flags |= ALIGN_DEBUG_CHECK_ALIGNMENT;
+  align_input->check_lineal_penalties = &parameters.lineal_penalties;
+  align_input->check_affine_penalties = &parameters.affine_penalties;
+  align_input->check_affine2p_penalties = &parameters.affine2p_penalties;
+  align_input->check_bandwidth = parameters.check_bandwidth;
+  align_input->verbose = parameters.verbose;
+  if (worker->input->mm_allocator_pool != NULL) { // Thread allocator (segments from the pool)
+    align_input->mm_allocator = mm_allocator_pool_get_allocator(worker->input->mm_allocator_pool);
+  } else {
+    align_input->mm_allocator = mm_allocator_new(BUFFER_SIZE_8M); // Placed by the worker thread
+    mm_allocator_set_memory(align_input->mm_allocator,parameters.memory_mode);
+  }
+  mm_allocator_set_callsite_stats(align_input->mm_allocator,parameters.memory_stats);
+  mm_allocator_set_free_lists(align_input->mm_allocator,parameters.memory_free_lists);
+  mm_allocator_set_numa_policy(align_input->mm_allocator,parameters.numa_policy,parameters.numa_node);
+  mm_allocator_set_large_cache(align_input->mm_allocator,(uint64_t)parameters.large_cache_mb*BUFFER_SIZE_1M,false);
+  mm_allocator_set_budget(align_input->mm_allocator,(uint64_t)parameters.memory_budget_mb*BUFFER_SIZE_1M);
+  align_input->budget_min_wavefront_length = parameters.budget_min_wavefront_length;
+  align_input->budget_max_distance_threshold = parameters.budget_max_distance_threshold;
+  align_input->affine_wavefronts = NULL;
+  align_input->affine_wavefronts_batch = NULL;
+  align_input->affine_wavefronts_lanes = NULL;
+  align_input->cigar_rle = parameters.cigar_rle;
+  align_input->match = parameters.match;
+  align_input->zero_copy = parameters.zero_copy;
+  align_input->zero_copy_slack = parameters.zero_copy_slack;
+  timer_reset(&align_input->timer);
+  worker->reads_processed = 0;
+}
+void align_benchmark_worker_destroy(
+    align_benchmark_worker_t* const worker) {
+  if (worker->align_input.affine_wavefronts != NULL) {
+    affine_wavefronts_delete(worker->align_input.affine_wavefronts);
+  }
+  if (worker->align_input.affine_wavefronts_batch != NULL) {
+    affine_wavefronts_batch_delete(worker->align_input.affine_wavefronts_batch);
+  }
+  if (worker->align_input.affine_wavefronts_lanes != NULL) {
+    affine_wavefronts_lanes_delete(worker->align_input.affine_wavefronts_lanes);
+  }
+  // Pooled allocators belong to the pool (the frees above may be deferred to them)
+  if (worker->input->mm_allocator_pool == NULL) {
+    mm_allocator_delete(worker->align_input.mm_allocator);
+  }
+  int i;
+  for (i=0;i<2*ALIGN_BENCHMARK_BATCH_SIZE;++i) free(worker->lines[i]);
+}
+void align_benchmark_worker_reserve_slack(
+    align_benchmark_worker_t* const worker,
+    const int line_idx) {
+  // Keep the zero-copy slack readable past the end of the sequence (line minus '\n')
+  const size_t min_allocated = worker->lines_length[line_idx] + parameters.zero_copy_slack;
+  if (worker->lines_allocated[line_idx] < min_allocated) {
+    worker->lines[line_idx] = realloc(worker->lines[line_idx],min_allocated);
+    if (worker->lines[line_idx] == NULL) {
+      fprintf(stderr,"Could not reserve the zero-copy slack\n");
+      exit(1);
+    }
+    worker->lines_allocated[line_idx] = min_allocated;
+  }
+}
+int align_benchmark_worker_read_batch(
+    align_benchmark_worker_t* const worker,
+    int* const first_sequence_id) {
+  align_benchmark_input_t* const input = worker->input;
+  pthread_mutex_lock(&input->input_mutex);
+  // Read pairs
+  int num_pairs = 0;
+  while (num_pairs < ALIGN_BENCHMARK_BATCH_SIZE) {
+    const int line1_idx = 2*num_pairs, line2_idx = 2*num_pairs+1;
+    worker->lines_length[line1_idx] = getline(
+        &worker->lines[line1_idx],&worker->lines_allocated[line1_idx],input->input_file);
+    if (worker->lines_length[line1_idx]==-1) break;
+    worker->lines_length[line2_idx] = getline(
+        &worker->lines[line2_idx],&worker->lines_allocated[line2_idx],input->input_file);
+    if (worker->lines_length[line2_idx]==-1) break;
+    if (parameters.zero_copy_slack > 0) {
+      align_benchmark_worker_reserve_slack(worker,line1_idx);
+      align_benchmark_worker_reserve_slack(worker,line2_idx);
+    }
+    ++num_pairs;
+  }
+  *first_sequence_id = input->reads_processed;
+  input->reads_processed += num_pairs;
+  // Update progress
+  if (input->reads_processed - input->reads_reported >= parameters.progress) {
+    input->reads_reported = input->reads_processed;
+    const uint64_t time_elapsed_global = timer_elapsed_ns(&(parameters.timer_global));
+    const float rate_global = (float)input->reads_processed/(float)TIMER_CONVERT_NS_TO_S(time_elapsed_global);
+    const uint64_t time_elapsed_alg = timer_elapsed_ns(&(worker->align_input.timer));
+    const float rate_alg = (float)worker->reads_processed/(float)TIMER_CONVERT_NS_TO_S(time_elapsed_alg);
+    fprintf(stderr,"...processed %d reads (benchmark=%2.3f reads/s;alignment=%2.3f reads/s)\n",
+        input->reads_processed,rate_global,rate_alg);
+  }
+  pthread_mutex_unlock(&input->input_mutex);
+  return num_pairs;
+}
+void align_benchmark_worker_align(
+    align_benchmark_worker_t* const worker,
+    char* const line1,
+    const int line1_length,
+    char* const line2,
+    const int line2_length,
+    const int sequence_id) {
+  align_input_t* const align_input = &worker->align_input;
+  // Configure input
+  align_input->sequence_id = sequence_id;
+  align_input->pattern = line1+1;
+  align_input->pattern_length = line1_length-2;
+  align_input->pattern[align_input->pattern_length] = '\0';
+  align_input->text = line2+1;
+  align_input->text_length = line2_length-2;
+  align_input->text[align_input->text_length] = '\0';
+  // Align queries using DP
+  switch (worker->alg_algorithm) {
+    case alignment_edit_dp:
+      benchmark_edit_dp(align_input);
+      break;
+    case alignment_edit_dp_banded:
+      benchmark_edit_dp_banded(align_input,parameters.bandwidth);
+      break;
+    case alignment_edit_wavefront:
+      benchmark_edit_wavefront(align_input);
+      break;
+    case alignment_gap_lineal_nw:
+      benchmark_gap_lineal_nw(align_input,&parameters.lineal_penalties);
+      break;
+    case alignment_gap_lineal_wavefront:
+      benchmark_gap_lineal_wavefront(
+          align_input,&parameters.lineal_penalties,
+          parameters.min_wavefront_length,
+          parameters.max_distance_threshold);
+      break;
+    case alignment_gap_affine_swg:
+      benchmark_gap_affine_swg(align_input,&parameters.affine_penalties);
+      break;
+    case alignment_gap_affine_swg_banded:
+      benchmark_gap_affine_swg_banded(align_input,
+          &parameters.affine_penalties,parameters.bandwidth);
+      break;
+    case alignment_gap_affine_wavefront:
+      benchmark_gap_affine_wavefront(
+          align_input,&parameters.affine_penalties,
+          parameters.min_wavefront_length,
+          parameters.max_distance_threshold);
+      break;
+    case alignment_gap_affine2p_wavefront:
+      benchmark_gap_affine2p_wavefront(
+          align_input,&parameters.affine2p_penalties,
+          parameters.min_wavefront_length,
+          parameters.max_distance_threshold);
+      break;
+    default:
+      fprintf(stderr,"Algorithm unknown or not implemented\n");
+      exit(1);
+      break;
+  }
+  ++(worker->reads_processed);
+  // DEBUG mm_allocator_print(stderr,align_input->mm_allocator,true);
+}
+void align_benchmark_worker_align_batch(
+    align_benchmark_worker_t* const worker,
+    const int num_pairs,
+    const int first_sequence_id) {
+  // Configure pairs (whole batch)
+  affine_wavefronts_pair_t pairs[ALIGN_BENCHMARK_BATCH_SIZE];
+  int i;
+  for (i=0;i<num_pairs;++i) {
+    char* const line1 = worker->lines[2*i];
+    char* const line2 = worker->lines[2*i+1];
+    pairs[i].pattern = line1+1;
+    pairs[i].pattern_length = worker->lines_length[2*i]-2;
+    line1[1+pairs[i].pattern_length] = '\0';
+    pairs[i].text = line2+1;
+    pairs[i].text_length = worker->lines_length[2*i+1]-2;
+    line2[1+pairs[i].text_length] = '\0';
+  }
+  // Align batch
+  if (worker->alg_algorithm == alignment_gap_affine_wavefront_lanes) {
+    benchmark_gap_affine_wavefront_lanes(&worker->align_input,
+        &parameters.affine_penalties,pairs,num_pairs,first_sequence_id);
+  } else {
+    affine2p_penalties_t* const penalties_2p =
+        (worker->alg_algorithm == alignment_gap_affine2p_wavefront_batch) ?
+        &parameters.affine2p_penalties : NULL;
+    benchmark_gap_affine_wavefront_batch(&worker->align_input,
+        &parameters.affine_penalties,penalties_2p,pairs,num_pairs,first_sequence_id);
+  }
+  worker->reads_processed += num_pairs;
+}
+void* align_benchmark_worker(void* const worker_ptr) {
+  align_benchmark_worker_t* const worker = (align_benchmark_worker_t*)worker_ptr;
+  // Init (allocator placed by this thread)
+  align_benchmark_worker_init(worker);
+  // Read-align loop
+  while (true) {
+    int sequence_id;
+    const int num_pairs = align_benchmark_worker_read_batch(worker,&sequence_id);
+    if (num_pairs == 0) break;
+    if (worker->alg_algorithm == alignment_gap_affine_wavefront_batch ||
+        worker->alg_algorithm == alignment_gap_affine2p_wavefront_batch ||
+        worker->alg_algorithm == alignment_gap_affine_wavefront_lanes) {
+      align_benchmark_worker_align_batch(worker,num_pairs,sequence_id);
+      continue;
+    }
+    int i;
+    for (i=0;i<num_pairs;++i) {
+      align_benchmark_worker_align(worker,
+          worker->lines[2*i],worker->lines_length[2*i],
+          worker->lines[2*i+1],worker->lines_length[2*i+1],sequence_id+i);
+    }
+  }
+  // Pooled allocators may be deleted when this thread exits (print their stats now)
+  if (worker->input->mm_allocator_pool != NULL && parameters.memory_stats) {
+    pthread_mutex_lock(&worker->input->input_mutex);
+    fprintf(stderr,"[MMAllocator] (Thread %d)\n",worker->worker_id);
+    mm_allocator_print_stats(stderr,worker->align_input.mm_allocator);
+    pthread_mutex_unlock(&worker->input->input_mutex);
+  }
+  return NULL;
+}
+void align_benchmark_combine_stats(
+    align_benchmark_worker_t* const workers,
+    const int num_workers,
+    align_input_t* const align_input) {
+  benchmark_align_input_clear(align_input);
+  timer_reset(&align_input->timer);
+  int i;
+  for (i=0;i<num_workers;++i) {
+    benchmark_align_input_combine(align_input,&workers[i].align_input);
+  }
+}
 /*
  * Benchmark
  */
 void align_benchmark(const alg_algorithm_type alg_algorithm) {
   // Parameters
-  FILE *input_file = NULL;
-  char *line1 = NULL, *line2 = NULL;
-  int line1_length=0, line2_length=0;
-  size_t line1_allocated=0, line2_allocated=0;
-  align_input_t align_input;
+  const int num_threads = parameters.num_threads;
+  align_benchmark_input_t input;
   // Init
   timer_restart(&(parameters.timer_global));
-  input_file = fopen(parameters.input, "r");
-  if (input_file==NULL) {
+  input.input_file = fopen(parameters.input, "r");
+  if (input.input_file==NULL) {
     fprintf(stderr,"Input file '%s' couldn't be opened\n",parameters.input);
     exit(1);
   }
-  benchmark_align_input_clear(&align_input);
-  align_input.debug_flags = 0;
-  align_input.debug_flags |= parameters.check_metric;
-  if (parameters.check_correct) align_input.debug_flags |= ALIGN_DEBUG_CHECK_CORRECT;
-  if (parameters.check_score) align_input.debug_flags |= ALIGN_DEBUG_CHECK_SCORE;
-  if (parameters.check_alignments) align_input.debug_flags |= ALIGN_DEBUG_CHECK_ALIGNMENT;
-  align_input.check_lineal_penalties = &parameters.lineal_penalties;
-  align_input.check_affine_penalties = &parameters.affine_penalties;
-  align_input.check_bandwidth = parameters.check_bandwidth;
-  align_input.verbose = parameters.verbose;
-  align_input.mm_allocator = mm_allocator_new(BUFFER_SIZE_8M);
-  timer_reset(&align_input.timer);
-  // Read-align loop
-  int reads_processed = 0, progress = 0;
-  while (true) {
-    // Read queries
-    line1_length = getline(&line1,&line1_allocated,input_file);
-    if (line1_length==-1) break;
-    line2_length = getline(&line2,&line2_allocated,input_file);
-    if (line1_length==-1) break;
-    // Configure input
-    align_input.sequence_id = reads_processed;
-    align_input.pattern = line1+1;
-    align_input.pattern_length = line1_length-2;
-    align_input.pattern[align_input.pattern_length] = '\0';
-    align_input.text = line2+1;
-    align_input.text_length = line2_length-2;
-    align_input.text[align_input.text_length] = '\0';
-    // Align queries using DP
-    switch (alg_algorithm) {
-      case alignment_edit_dp:
-        benchmark_edit_dp(&align_input);
-        break;
-      case alignment_edit_dp_banded:
-        benchmark_edit_dp_banded(&align_input,parameters.bandwidth);
-        break;
-      case alignment_gap_lineal_nw:
-        benchmark_gap_lineal_nw(&align_input,&parameters.lineal_penalties);
-        break;
-      case alignment_gap_affine_swg:
-        benchmark_gap_affine_swg(&align_input,&parameters.affine_penalties);
-        break;
-      case alignment_gap_affine_swg_banded:
-        benchmark_gap_affine_swg_banded(&align_input,
-            &parameters.affine_penalties,parameters.bandwidth);
-        break;
-      case alignment_gap_affine_wavefront:
-        benchmark_gap_affine_wavefront(
-            &align_input,&parameters.affine_penalties,
-            parameters.min_wavefront_length,
-            parameters.max_distance_threshold);
-        break;
-      default:
-        fprintf(stderr,"Algorithm unknown or not implemented\n");
+  pthread_mutex_init(&input.input_mutex,NULL);
+  input.reads_processed = 0;
+  input.reads_reported = 0;
+  input.mm_allocator_pool = NULL;
+  if (parameters.memory_pool) {
+    input.mm_allocator_pool = mm_allocator_pool_new(BUFFER_SIZE_8M,2*num_threads);
+    mm_allocator_pool_set_memory(input.mm_allocator_pool,parameters.memory_mode);
+  }
+  // Align (using a worker per thread)
+  align_benchmark_worker_t* const workers = malloc(num_threads*sizeof(align_benchmark_worker_t));
+  int i;
+  for (i=0;i<num_threads;++i) {
+    workers[i].input = &input;
+    workers[i].alg_algorithm = alg_algorithm;
+    workers[i].worker_id = i;
+  }
+  if (num_threads == 1) {
+    align_benchmark_worker(workers); // Run on the main thread
+  } else {
+    for (i=0;i<num_threads;++i) {
+      if (pthread_create(&workers[i].thread,NULL,align_benchmark_worker,workers+i) != 0) {
+        fprintf(stderr,"Could not create worker thread\n");
         exit(1);
-        break;
+      }
     }
-    // Update progress
-    ++reads_processed;
-    // DEBUG mm_allocator_print(stderr,align_input.mm_allocator,true);
-    if (++progress == parameters.progress) {
-      progress = 0;
-      // Compute speed
-      const uint64_t time_elapsed_global = timer_elapsed_ns(&(parameters.timer_global));
-      const float rate_global = (float)reads_processed/(float)TIMER_CONVERT_NS_TO_S(time_elapsed_global);
-      const uint64_t time_elapsed_alg = timer_elapsed_ns(&(align_input.timer));
-      const float rate_alg = (float)reads_processed/(float)TIMER_CONVERT_NS_TO_S(time_elapsed_alg);
-      fprintf(stderr,"...processed %d reads (benchmark=%2.3f reads/s;alignment=%2.3f reads/s)\n",
-          reads_processed,rate_global,rate_alg);
+    for (i=0;i<num_threads;++i) {
+      pthread_join(workers[i].thread,NULL);
     }
   }
   timer_stop(&(parameters.timer_global));
+  // Combine stats
+  align_input_t align_input;
+  align_benchmark_combine_stats(workers,num_threads,&align_input);
   // Print benchmark results
   fprintf(stderr,"[Benchmark]\n");
-  fprintf(stderr,"=> Total.reads            %d\n",reads_processed);
+  fprintf(stderr,"=> Total.reads            %d\n",input.reads_processed);
+  if (num_threads > 1) {
+    fprintf(stderr,"=> Total.threads          %d\n",num_threads);
+  }
   fprintf(stderr,"=> Time.Benchmark      ");
   timer_print(stderr,&parameters.timer_global,NULL);
   fprintf(stderr,"  => Time.Alignment    ");
   timer_print(stderr,&align_input.timer,&parameters.timer_global);
+  if (parameters.memory_budget_mb > 0) {
+    fprintf(stderr,"=> Total.out-of-budget    %" PRIu64 "\n",
+        counter_get_total(&align_input.align_out_of_budget));
+  }
   // Print Stats
   if (parameters.check_correct || parameters.check_score || parameters.check_alignments) {
     const bool print_wf_stats = (alg_algorithm == alignment_gap_affine_wavefront);
     benchmark_print_stats(stderr,&align_input,print_wf_stats);
   }
+  if (parameters.memory_stats && input.mm_allocator_pool == NULL) {
+    fprintf(stderr,"[MMAllocator]\n");
+    for (i=0;i<num_threads;++i) {
+      if (num_threads > 1) fprintf(stderr,"=> Thread %d\n",i);
+      mm_allocator_print_stats(stderr,workers[i].align_input.mm_allocator);
+    }
+  }
   // Free
-  fclose(input_file);
-  mm_allocator_delete(align_input.mm_allocator);
-  free(line1);
-  free(line2);
+  for (i=0;i<num_threads;++i) {
+    align_benchmark_worker_destroy(workers+i);
+  }
+  free(workers);
+  if (input.mm_allocator_pool != NULL) {
+    mm_allocator_pool_delete(input.mm_allocator_pool);
+  }
+  pthread_mutex_destroy(&input.input_mutex);
+  fclose(input.input_file);
 }
 /*
  * Generic Menu
@@ -283,26 +584,49 @@ void usage() {
       "            [edit]                                                   \n"
       "              edit-dp                                                \n"
       "              edit-dp-banded                                         \n"
+      "              edit-wfa                                               \n"
       "            [gap-lineal]                                             \n"
       "              gap-lineal-nw                                          \n"
+      "              gap-lineal-wfa                                         \n"
+      "              gap-lineal-wfa-adaptive                                \n"
       "            [gap-affine]                                             \n"
       "              gap-affine-swg                                         \n"
       "              gap-affine-swg-banded                                  \n"
       "              gap-affine-wfa                                         \n"
       "              gap-affine-wfa-adaptive                                \n"
+      "              gap-affine-wfa-batch                                   \n"
+      "              gap-affine-wfa-lanes                                   \n"
+      "            [gap-affine-2p]                                          \n"
+      "              gap-affine2p-wfa                                       \n"
+      "              gap-affine2p-wfa-adaptive                              \n"
+      "              gap-affine2p-wfa-batch                                 \n"
       "          --input|i <File>                                           \n"
       "        [Penalties]                                                  \n"
       "          --lineal-penalties|p M,X,I,D                               \n"
       "          --affine-penalties|g M,X,O,E                               \n"
+      "          --affine2p-penalties|G M,X,O1,E1,O2,E2                     \n"
       "        [Specifics]                                                  \n"
       "          --bandwidth <INT>                                          \n"
       "          --minimum-wavefront-length <INT>                           \n"
       "          --maximum-difference-distance <INT>                        \n"
+      "          --cigar-rle                                                \n"
+      "          --match 'exact'|'case-insensitive'|'n-any'|'n-none'[,...]  \n"
+      "          --zero-copy[=<slack>]                                      \n"
       "        [Misc]                                                       \n"
       "          --progress|P <integer>                                     \n"
+      "          --threads|t <integer>                                      \n"
       "          --check|c 'correct'|'score'|'alignment'                    \n"
-      "          --check-distance 'edit'|'gap-lineal'|'gap-affine'          \n"
+      "          --check-distance 'edit'|'gap-lineal'|'gap-affine'|         \n"
+      "                           'gap-affine2p'                            \n"
       "          --check-bandwidth <INT>                                    \n"
+      "          --memory 'malloc'|'mmap'|'hugepages'                       \n"
+      "          --memory-stats                                             \n"
+      "          --memory-free-lists                                        \n"
+      "          --memory-pool                                              \n"
+      "          --numa 'local'|'interleave'|<node>                         \n"
+      "          --large-cache <MB>                                         \n"
+      "          --memory-budget <MB>                                       \n"
+      "          --budget-fallback <INT>,<INT>                              \n"
       "          --help|h                                                   \n");
 }
 void parse_arguments(int argc,char** argv) {
@@ -313,15 +637,28 @@ void parse_arguments(int argc,char** argv) {
     /* Penalties */
     { "lineal-penalties", required_argument, 0, 'p' },
     { "affine-penalties", required_argument, 0, 'g' },
+    { "affine2p-penalties", required_argument, 0, 'G' },
     /* Specifics */
     { "bandwidth", required_argument, 0, 1000 },
     { "minimum-wavefront-length", required_argument, 0, 1002 },
     { "maximum-difference-distance", required_argument, 0, 1003 },
+    { "cigar-rle", no_argument, 0, 1004 },
+    { "match", required_argument, 0, 1005 },
+    { "zero-copy", optional_argument, 0, 1006 },
     /* Misc */
     { "progress", required_argument, 0, 'P' },
+    { "threads", required_argument, 0, 't' },
     { "check", optional_argument, 0, 'c' },
     { "check-distance", required_argument, 0, 2000 },
     { "check-bandwidth", required_argument, 0, 2001 },
+    { "memory", required_argument, 0, 2002 },
+    { "memory-stats", no_argument, 0, 2003 },
+    { "numa", required_argument, 0, 2004 },
+    { "large-cache", required_argument, 0, 2005 },
+    { "memory-budget", required_argument, 0, 2006 },
+    { "budget-fallback", required_argument, 0, 2007 },
+    { "memory-free-lists", no_argument, 0, 2008 },
+    { "memory-pool", no_argument, 0, 2009 },
     { "verbose", no_argument, 0, 'v' },
     { "help", no_argument, 0, 'h' },
     { 0, 0, 0, 0 } };
@@ -331,7 +668,7 @@ void parse_arguments(int argc,char** argv) {
     exit(0);
   }
   while (1) {
-    c=getopt_long(argc,argv,"a:i:p:g:P:c:vh",long_options,&option_index);
+    c=getopt_long(argc,argv,"a:i:p:g:G:P:t:c:vh",long_options,&option_index);
     if (c==-1) break;
     switch (c) {
     /*
@@ -368,6 +705,21 @@ void parse_arguments(int argc,char** argv) {
       parameters.affine_penalties.gap_extension = atoi(sentinel);
       break;
     }
+    case 'G': { // --affine2p-penalties
+      char* sentinel = strtok(optarg,",");
+      parameters.affine2p_penalties.match = atoi(sentinel);
+      sentinel = strtok(NULL,",");
+      parameters.affine2p_penalties.mismatch = atoi(sentinel);
+      sentinel = strtok(NULL,",");
+      parameters.affine2p_penalties.gap_opening1 = atoi(sentinel);
+      sentinel = strtok(NULL,",");
+      parameters.affine2p_penalties.gap_extension1 = atoi(sentinel);
+      sentinel = strtok(NULL,",");
+      parameters.affine2p_penalties.gap_opening2 = atoi(sentinel);
+      sentinel = strtok(NULL,",");
+      parameters.affine2p_penalties.gap_extension2 = atoi(sentinel);
+      break;
+    }
     /*
      * Specific parameters
      */
@@ -380,12 +732,50 @@ void parse_arguments(int argc,char** argv) {
     case 1003: // --maximum-difference-distance
       parameters.max_distance_threshold = atoi(optarg);
       break;
+    case 1004: // --cigar-rle
+      parameters.cigar_rle = true;
+      break;
+    case 1005: { // --match
+      char* sentinel = strtok(optarg,",");
+      while (sentinel != NULL) {
+        if (strcasecmp(sentinel,"exact")==0) {
+          parameters.match.case_insensitive = false;
+          parameters.match.n = wavefronts_match_n_exact;
+        } else if (strcasecmp(sentinel,"case-insensitive")==0) {
+          parameters.match.case_insensitive = true;
+        } else if (strcasecmp(sentinel,"n-any")==0) {
+          parameters.match.n = wavefronts_match_n_any;
+        } else if (strcasecmp(sentinel,"n-none")==0) {
+          parameters.match.n = wavefronts_match_n_none;
+        } else {
+          fprintf(stderr,"Option '--match' must be in {'exact','case-insensitive','n-any','n-none'}\n");
+          exit(1);
+        }
+        sentinel = strtok(NULL,",");
+      }
+      break;
+    }
+    case 1006: // --zero-copy
+      parameters.zero_copy = true;
+      parameters.zero_copy_slack = (optarg==NULL) ? 0 : atoi(optarg);
+      if (parameters.zero_copy_slack < 0) {
+        fprintf(stderr,"Option --zero-copy slack must be non-negative\n");
+        exit(1);
+      }
+      break;
     /*
      * Misc
      */
     case 'P':
       parameters.progress = atoi(optarg);
       break;
+    case 't':
+      parameters.num_threads = atoi(optarg);
+      if (parameters.num_threads < 1) {
+        fprintf(stderr,"Option --threads must be at least 1\n");
+        exit(1);
+      }
+      break;
     case 'c':
       if (optarg ==  NULL) { // default = score
         parameters.check_correct = true;
@@ -415,14 +805,60 @@ void parse_arguments(int argc,char** argv) {
         parameters.check_metric = ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_LINEAL;
       } else if (strcasecmp(optarg,"gap-affine")==0) {
         parameters.check_metric = ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE;
+      } else if (strcasecmp(optarg,"gap-affine2p")==0) {
+        parameters.check_metric = ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P;
       } else {
-        fprintf(stderr,"Option '--check-distance' must be in {'edit','gap-lineal','gap-affine'}\n");
+        fprintf(stderr,"Option '--check-distance' must be in {'edit','gap-lineal','gap-affine','gap-affine2p'}\n");
         exit(1);
       }
       break;
     case 2001: // --check-bandwidth
       parameters.check_bandwidth = atoi(optarg);
       break;
+    case 2002: // --memory
+      if (strcasecmp(optarg,"malloc")==0) { // default = malloc
+        parameters.memory_mode = mm_allocator_memory_malloc;
+      } else if (strcasecmp(optarg,"mmap")==0) {
+        parameters.memory_mode = mm_allocator_memory_mmap;
+      } else if (strcasecmp(optarg,"hugepages")==0) {
+        parameters.memory_mode = mm_allocator_memory_hugepages;
+      } else {
+        fprintf(stderr,"Option '--memory' must be in {'malloc','mmap','hugepages'}\n");
+        exit(1);
+      }
+      break;
+    case 2003: // --memory-stats
+      parameters.memory_stats = true;
+      break;
+    case 2004: // --numa
+      if (strcasecmp(optarg,"local")==0) {
+        parameters.numa_policy = mm_numa_local;
+      } else if (strcasecmp(optarg,"interleave")==0) {
+        parameters.numa_policy = mm_numa_interleave;
+      } else {
+        parameters.numa_policy = mm_numa_bind;
+        parameters.numa_node = atoi(optarg);
+      }
+      break;
+    case 2005: // --large-cache
+      parameters.large_cache_mb = atoi(optarg);
+      break;
+    case 2006: // --memory-budget
+      parameters.memory_budget_mb = atoi(optarg);
+      break;
+    case 2007: { // --budget-fallback
+      char* sentinel = strtok(optarg,",");
+      parameters.budget_min_wavefront_length = atoi(sentinel);
+      sentinel = strtok(NULL,",");
+      parameters.budget_max_distance_threshold = atoi(sentinel);
+      break;
+    }
+    case 2008: // --memory-free-lists
+      parameters.memory_free_lists = true;
+      break;
+    case 2009: // --memory-pool
+      parameters.memory_pool = true;
+      break;
     case 'v':
       parameters.verbose = true;
       break;
@@ -440,6 +876,28 @@ void parse_arguments(int argc,char** argv) {
     fprintf(stderr,"Option --algorithm is required \n");
     exit(1);
   }
+  if (parameters.check_metric == 0) {
+    parameters.check_metric = (strncmp(parameters.algorithm,"gap-affine2p",12)==0) ?
+        ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P : ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE;
+  }
+  if (parameters.match.case_insensitive || parameters.match.n != wavefronts_match_n_exact) {
+    if (strncmp(parameters.algorithm,"gap-affine",10) != 0 ||
+        strstr(parameters.algorithm,"-wfa") == NULL || strstr(parameters.algorithm,"-batch") != NULL ||
+        strstr(parameters.algorithm,"-lanes") != NULL) {
+      fprintf(stderr,"Option --match is only supported by the gap-affine WFA algorithms\n");
+      exit(1);
+    }
+    if (parameters.check_metric != ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE &&
+        parameters.check_metric != ALIGN_DEBUG_CHECK_DISTANCE_METRIC_GAP_AFFINE2P) {
+      fprintf(stderr,"Option --match can only be checked using gap-affine distances\n");
+      exit(1);
+    }
+  }
+  if (strcmp(parameters.algorithm,"gap-affine-wfa-lanes")==0 &&
+      (parameters.check_alignments || (parameters.check_correct && !parameters.check_score))) {
+    fprintf(stderr,"Option --check of 'gap-affine-wfa-lanes' only supports 'score' (no CIGAR)\n");
+    exit(1);
+  }
   if (strcmp(parameters.algorithm,"test")!=0 && parameters.input==NULL) {
     fprintf(stderr,"Option --input is required \n");
     exit(1);
@@ -456,9 +914,19 @@ int main(int argc,char* argv[]) {
     align_benchmark(alignment_edit_dp);
   } else if (strcmp(parameters.algorithm,"edit-dp-banded")==0) {
     align_benchmark(alignment_edit_dp_banded);
+  } else if (strcmp(parameters.algorithm,"edit-wfa")==0) {
+    align_benchmark(alignment_edit_wavefront);
   /* NW */
   } else if (strcmp(parameters.algorithm,"gap-lineal-nw")==0) {
     align_benchmark(alignment_gap_lineal_nw);
+  } else if (strcmp(parameters.algorithm,"gap-lineal-wfa")==0) {
+    parameters.reduction_type = wavefronts_reduction_none;
+    parameters.min_wavefront_length = -1;
+    parameters.max_distance_threshold = -1;
+    align_benchmark(alignment_gap_lineal_wavefront);
+  } else if (strcmp(parameters.algorithm,"gap-lineal-wfa-adaptive")==0) {
+    parameters.reduction_type = wavefronts_reduction_dynamic;
+    align_benchmark(alignment_gap_lineal_wavefront);
   /* SWG */
   } else if (strcmp(parameters.algorithm,"gap-affine-swg")==0) {
     align_benchmark(alignment_gap_affine_swg);
@@ -472,6 +940,21 @@ int main(int argc,char* argv[]) {
   } else if (strcmp(parameters.algorithm,"gap-affine-wfa-adaptive")==0) {
     parameters.reduction_type = wavefronts_reduction_dynamic;
     align_benchmark(alignment_gap_affine_wavefront);
+  } else if (strcmp(parameters.algorithm,"gap-affine-wfa-batch")==0) {
+    align_benchmark(alignment_gap_affine_wavefront_batch);
+  } else if (strcmp(parameters.algorithm,"gap-affine-wfa-lanes")==0) {
+    align_benchmark(alignment_gap_affine_wavefront_lanes);
+  /* Two-piece gap-affine */
+  } else if (strcmp(parameters.algorithm,"gap-affine2p-wfa")==0) {
+    parameters.reduction_type = wavefronts_reduction_none;
+    parameters.min_wavefront_length = -1;
+    parameters.max_distance_threshold = -1;
+    align_benchmark(alignment_gap_affine2p_wavefront);
+  } else if (strcmp(parameters.algorithm,"gap-affine2p-wfa-adaptive")==0) {
+    parameters.reduction_type = wavefronts_reduction_dynamic;
+    align_benchmark(alignment_gap_affine2p_wavefront);
+  } else if (strcmp(parameters.algorithm,"gap-affine2p-wfa-batch")==0) {
+    align_benchmark(alignment_gap_affine2p_wavefront_batch);
   } else {
     fprintf(stderr,"Algorithm '%s' not recognized\n",parameters.algorithm);
     exit(1);
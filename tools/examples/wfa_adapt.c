@@ -54,19 +54,11 @@ int main(int argc,char* argv[]) {
   affine_wavefronts_align(
       affine_wavefronts,pattern,strlen(pattern),text,strlen(text));
   // Count mismatches, deletions, and insertions
-  int i, misms=0, ins=0, del=0;
-  edit_cigar_t* const edit_cigar = &affine_wavefronts->edit_cigar;
-  for (i=edit_cigar->begin_offset;i<edit_cigar->end_offset;++i) {
-    switch (edit_cigar->operations[i]) {
-      case 'M': break;
-      case 'X': ++misms; break;
-      case 'D': ++del; break;
-      case 'I': ++ins; break;
-    }
-  }
+  edit_cigar_stats_t stats;
+  edit_cigar_get_stats(&affine_wavefronts->edit_cigar,&stats);
   fprintf(stderr,
       "Alignment contains %d mismatches, %d insertions, "
-      "and %d deletions\n",misms,ins,del);
+      "and %d deletions\n",stats.mismatches,stats.insertions,stats.deletions);
   // Free
   affine_wavefronts_delete(affine_wavefronts);
   mm_allocator_delete(mm_allocator);
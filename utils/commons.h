@@ -188,6 +188,13 @@
 #define UINT32_ZERO_MASK       0xFFFFFFFEul
 #define UINT32_ONE_LAST_MASK   0x80000000ul
 #define UINT32_ZERO_LAST_MASK  0x7FFFFFFFul
+// Packed bytes (8 bytes per 64-bit word)
+#define SWAR_ONES  0x0101010101010101ull
+#define SWAR_LOW7  0x7F7F7F7F7F7F7F7Full
+#define SWAR_HIGH  0x8080808080808080ull
+#define SWAR_ZERO_BYTES(v) \
+  (~((((v) & SWAR_LOW7) + SWAR_LOW7) | (v)) & SWAR_HIGH) /* 0x80 on every zero byte */
+#define SWAR_EQ_BYTES(v,c) SWAR_ZERO_BYTES((v) ^ ((c)*SWAR_ONES)) /* 0x80 on every byte equal to c */
 
 /*
  * Common numerical data processing/formating
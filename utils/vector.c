@@ -52,6 +52,19 @@ vector_t* vector_new_(const uint64_t num_initial_elements,const uint64_t element
   vector_buffer->used = 0;
   return vector_buffer;
 }
+vector_t* vector_try_new_(const uint64_t num_initial_elements,const uint64_t element_size) {
+  vector_t* const vector_buffer = malloc(sizeof(vector_t));
+  if (!vector_buffer) return NULL;
+  vector_buffer->memory = malloc(num_initial_elements*element_size);
+  if (!vector_buffer->memory) {
+    free(vector_buffer);
+    return NULL;
+  }
+  vector_buffer->element_size = element_size;
+  vector_buffer->elements_allocated = num_initial_elements;
+  vector_buffer->used = 0;
+  return vector_buffer;
+}
 void vector_reserve(vector_t* const vector,const uint64_t num_elements,const bool zero_mem) {
   if (vector->elements_allocated < num_elements) {
     const uint64_t proposed=(float)vector->elements_allocated*VECTOR_EXPAND_FACTOR;
@@ -54,6 +54,8 @@ typedef struct {
  */
 #define vector_new(num_initial_elements,type) vector_new_(num_initial_elements,sizeof(type))
 vector_t* vector_new_(const uint64_t num_initial_elements,const uint64_t element_size);
+#define vector_try_new(num_initial_elements,type) vector_try_new_(num_initial_elements,sizeof(type))
+vector_t* vector_try_new_(const uint64_t num_initial_elements,const uint64_t element_size); // NULL if no memory
 void vector_reserve(vector_t* const vector,const uint64_t num_elements,const bool zero_mem);
 void vector_resize__clear(vector_t* const vector,const uint64_t num_elements);
 #define vector_cast__clear(vector,type) vector_cast__clear_s(vector,sizeof(type))